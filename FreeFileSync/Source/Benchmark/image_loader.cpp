@@ -0,0 +1,56 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#include "image_loader.h"
+#include <algorithm>
+#include <zen/file_traverser.h>
+#include <zen/scope_guard.h>
+#include <zen/utf.h>
+#include <png.h>
+
+using namespace zen;
+using namespace fff;
+
+
+namespace
+{
+ArgbImage loadPngImage(const FileInfo& fi) //throw FileError
+{
+    png_image pngImg = {};
+    pngImg.version = PNG_IMAGE_VERSION;
+    ZEN_ON_SCOPE_EXIT(::png_image_free(&pngImg)); //no-op if already freed by png_image_finish_read() or on error
+
+    if (!::png_image_begin_read_from_file(&pngImg, fi.fullPath.c_str()))
+        throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(fi.fullPath)), utfTo<std::wstring>(pngImg.message));
+
+    pngImg.format = PNG_FORMAT_BGRA; //=> matches xbrz::ColorFormat::argb on little-endian
+
+    ArgbImage img{.name = fi.itemName, .width = static_cast<int>(pngImg.width), .height = static_cast<int>(pngImg.height)};
+    img.pixels.resize(static_cast<size_t>(pngImg.width) * pngImg.height);
+
+    if (!::png_image_finish_read(&pngImg, nullptr /*background*/, img.pixels.data(), 0 /*row_stride: packed*/, nullptr /*colormap*/))
+        throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(fi.fullPath)), utfTo<std::wstring>(pngImg.message));
+    return img;
+}
+}
+
+
+std::vector<ArgbImage> fff::loadPngImages(const Zstring& folderPath) //throw FileError
+{
+    std::vector<FileInfo> pngFiles;
+    traverseFolder(folderPath, [&](const FileInfo& fi)
+    {
+        if (endsWithAsciiNoCase(fi.itemName, Zstr(".png")))
+            pngFiles.push_back(fi);
+    }, nullptr, nullptr); //throw FileError
+
+    std::sort(pngFiles.begin(), pngFiles.end(), [](const FileInfo& lhs, const FileInfo& rhs) { return lhs.itemName < rhs.itemName; });
+
+    std::vector<ArgbImage> images;
+    for (const FileInfo& fi : pngFiles)
+        images.push_back(loadPngImage(fi)); //throw FileError
+    return images;
+}
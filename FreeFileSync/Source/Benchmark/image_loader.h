@@ -0,0 +1,31 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#ifndef IMAGE_LOADER_H_5820174369152083
+#define IMAGE_LOADER_H_5820174369152083
+
+#include <cstdint>
+#include <vector>
+#include <zen/zstring.h>
+#include <zen/file_error.h>
+
+
+namespace fff
+{
+struct ArgbImage
+{
+    Zstring name;
+    int width  = 0;
+    int height = 0;
+    std::vector<uint32_t> pixels; //xbrz::ColorFormat::argb: BGRA byte order on little-endian, alpha not premultiplied
+};
+
+//load all *.png files of a folder, sorted by name, e.g. the bundled icon set: unzip FreeFileSync/Build/Resources/Icons.zip -d <folder>
+//no wxWidgets: uses libpng directly
+std::vector<ArgbImage> loadPngImages(const Zstring& folderPath); //throw FileError
+}
+
+#endif //IMAGE_LOADER_H_5820174369152083
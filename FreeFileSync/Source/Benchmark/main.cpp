@@ -0,0 +1,487 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#include <iostream>
+#include <zen/file_access.h>
+#include <zen/file_path.h>
+#include <zen/guid.h>
+#include <zen/json.h>
+#include <zen/perf.h>
+#include <zen/scope_guard.h>
+#include <xBRZ/src/xbrz.h>
+#include "../afs/concrete.h"
+#include "../base/algorithm.h"
+#include "../base/binary.h"
+#include "../base/comparison.h"
+#include "../base/db_file.h"
+#include "../base/parallel_scan.h"
+#include "tree_generator.h"
+#include "image_loader.h"
+
+    #include <sys/resource.h> //getrusage
+
+using namespace zen;
+using namespace fff;
+
+
+/*  Headless benchmark for the comparison pipeline: no wxWidgets, native file system only
+
+    1. generate two synthetic folder trees (by default on tmpfs: /dev/shm)
+    2. per run, measure: parallelFolderScan()        (both sides)
+                         compare()                   (includes scan, merge, categorize, DB load and sync directions)
+                         redetermineSyncDirection()  (first run: no database, later runs: with database)
+                         saveLastSynchronousState()
+                         loadLastSynchronousState()
+                         filesHaveSameContent()      (optional: --content-size; equal files and files differing in the last byte)
+                         xbrz::scale()               (optional: --icons; all images at factors 2 - 6, items = source pixels)
+    3. print one JSON object per phase and line to stdout; errors and warnings go to stderr
+
+    Example: FreeFileSync_Benchmark_x86_64 --files 1000000 --depth 5 --names unicode --change-rate 0.01 --runs 3 > results.jsonl
+
+    per-device parallelism of metadata tasks (massParallelExecute(): sync.ffs_db load/save, symlink resolution), e.g. 32 folder pairs:
+             FreeFileSync_Benchmark_x86_64 --pairs 32 --parallel 1 > single.jsonl
+             FreeFileSync_Benchmark_x86_64 --pairs 32              > default.jsonl     (AFS::getDefaultParallelOps())
+
+    xBRZ scaling of the bundled icon set (same color format as wx+/image_resources.cpp):
+             unzip FreeFileSync/Build/Resources/Icons.zip -d /tmp/Icons
+             FreeFileSync_Benchmark_x86_64 --files 0 --icons /tmp/Icons > xbrz.jsonl                                  */
+
+namespace
+{
+const char* usageText =
+    "Usage: FreeFileSync_Benchmark_<arch> [options]\n"
+    "  --files <count>          files per side (default: 100000)\n"
+    "  --depth <levels>         folder depth (default: 4)\n"
+    "  --folders <count>        sub folders per folder (default: 6)\n"
+    "  --names <ascii|long|unicode> file name distribution (default: ascii)\n"
+    "  --change-rate <0..1>     share of files differing between left and right (default: 0.05)\n"
+    "  --max-size <bytes>       maximum file size (default: 1024)\n"
+    "  --seed <number>          random seed for tree generation (default: 0)\n"
+    "  --runs <count>           number of measurement runs (default: 3)\n"
+    "  --pairs <count>          folder pairs; files are split evenly (default: 1)\n"
+    "  --parallel <count>       parallel file operations (default: not set => AFS::getDefaultParallelOps() for metadata tasks)\n"
+    "  --content-size <bytes>   also measure file content comparison with files of this size (default: 0 = skip)\n"
+    "  --icons <path>           also measure xBRZ scaling of all *.png files in this folder (default: skip)\n"
+    "  --temp-dir <path>        where to create the trees (default: /dev/shm if available)\n"
+    "  --keep                   don't delete the trees when done\n";
+
+
+struct BenchmarkConfig
+{
+    TreeConfig tree;
+    int runs = 3;
+    size_t pairCount = 1;
+    std::optional<size_t> parallelOps; //not set: AFS::getDefaultParallelOps()
+    uint64_t contentFileSize = 0;
+    Zstring iconFolderPath;
+    Zstring tempFolderPath;
+    bool keepFiles = false;
+};
+
+
+struct InvalidArgument { std::string msg; };
+
+BenchmarkConfig parseArguments(const std::vector<std::string>& args) //throw InvalidArgument
+{
+    BenchmarkConfig cfg;
+
+    for (auto it = args.begin(); it != args.end(); ++it)
+    {
+        const std::string& arg = *it;
+
+        if (arg == "--keep")
+        {
+            cfg.keepFiles = true;
+            continue;
+        }
+
+        if (it + 1 == args.end())
+            throw InvalidArgument{"Missing value for argument: " + arg};
+        const std::string& val = *++it;
+
+        auto parseNumber = [&](auto minVal) //throw InvalidArgument
+        {
+            const auto num = stringTo<decltype(minVal)>(val);
+            if (num < minVal || val.empty() || !(isDigit(val[0]) || val[0] == '.'))
+                throw InvalidArgument{"Invalid value for argument " + arg + ": " + val};
+            return num;
+        };
+
+        /**/ if (arg == "--files")       cfg.tree.fileCount        = parseNumber(size_t(0));
+        else if (arg == "--depth")       cfg.tree.depth            = parseNumber(0);
+        else if (arg == "--folders")     cfg.tree.foldersPerFolder = parseNumber(1);
+        else if (arg == "--max-size")    cfg.tree.maxFileSize      = parseNumber(size_t(0));
+        else if (arg == "--seed")        cfg.tree.seed             = parseNumber(uint64_t(0));
+        else if (arg == "--runs")        cfg.runs                  = parseNumber(1);
+        else if (arg == "--pairs")       cfg.pairCount             = parseNumber(size_t(1));
+        else if (arg == "--parallel")    cfg.parallelOps           = parseNumber(size_t(1));
+        else if (arg == "--content-size") cfg.contentFileSize      = parseNumber(uint64_t(0));
+        else if (arg == "--icons")       cfg.iconFolderPath        = utfTo<Zstring>(val);
+        else if (arg == "--temp-dir")    cfg.tempFolderPath        = utfTo<Zstring>(val);
+        else if (arg == "--change-rate")
+        {
+            cfg.tree.changeRate = parseNumber(0.0);
+            if (cfg.tree.changeRate > 1)
+                throw InvalidArgument{"Invalid value for argument " + arg + ": " + val};
+        }
+        else if (arg == "--names")
+        {
+            /**/ if (val == "ascii")   cfg.tree.names = NameDistribution::ascii;
+            else if (val == "long")    cfg.tree.names = NameDistribution::longName;
+            else if (val == "unicode") cfg.tree.names = NameDistribution::unicode;
+            else throw InvalidArgument{"Invalid value for argument " + arg + ": " + val};
+        }
+        else
+            throw InvalidArgument{"Unknown argument: " + arg};
+    }
+    return cfg;
+}
+
+
+class BenchmarkCallback : public ProcessCallback //errors are logged and ignored
+{
+public:
+    void initNewPhase(int itemsTotal, int64_t bytesTotal, ProcessPhase phaseId) override {}
+
+    void updateDataProcessed(int itemsDelta, int64_t bytesDelta) override {}
+    void updateDataTotal    (int itemsDelta, int64_t bytesDelta) override {}
+
+    void requestUiUpdate(bool force) override {}
+    void updateStatus(std::wstring&& msg) override {}
+
+    void logMessage(const std::wstring& msg, MsgType type) override
+    {
+        switch (type)
+        {
+            case MsgType::info:
+                break;
+            case MsgType::warning:
+                printError(L"[Warning] " + msg);
+                break;
+            case MsgType::error:
+                ++errorCount_;
+                printError(L"[Error] " + msg);
+                break;
+        }
+    }
+
+    void reportWarning(const std::wstring& msg, bool& warningActive) override { printError(L"[Warning] " + msg); }
+
+    Response reportError(const ErrorInfo& errorInfo) override
+    {
+        ++errorCount_;
+        printError(L"[Error] " + errorInfo.msg);
+        return ignore;
+    }
+
+    std::optional<ErrorPolicy> getErrorPolicy() const override { return ErrorPolicy(); } //don't retry
+
+    void reportFatalError(const std::wstring& msg) override
+    {
+        ++errorCount_;
+        printError(L"[Error] " + msg);
+    }
+
+    size_t getErrorCount() const { return errorCount_; }
+
+private:
+    static void printError(const std::wstring& msg) { std::cerr << utfTo<std::string>(msg) << std::endl; }
+
+    size_t errorCount_ = 0;
+};
+
+
+size_t getItemCount(const FolderContainer& folderCont)
+{
+    size_t itemCount = folderCont.files.size() + folderCont.symlinks.size() + folderCont.folders.size();
+    for (const auto& [folderName, attrAndSub] : folderCont.folders)
+        itemCount += getItemCount(attrAndSub.second);
+    return itemCount;
+}
+
+
+size_t getItemCount(const InSyncFolder& dbFolder)
+{
+    size_t itemCount = dbFolder.files.size() + dbFolder.symlinks.size() + dbFolder.folders.size();
+    for (const auto& [folderName, subFolder] : dbFolder.folders)
+        itemCount += getItemCount(subFolder);
+    return itemCount;
+}
+
+
+size_t getItemCount(const ContainerObject& conObj)
+{
+    size_t itemCount = 0;
+    for ([[maybe_unused]] const FilePair&    file : conObj.files   ()) ++itemCount;
+    for ([[maybe_unused]] const SymlinkPair& link : conObj.symlinks()) ++itemCount;
+    for (const FolderPair& folder : conObj.subfolders())
+        itemCount += 1 + getItemCount(folder);
+    return itemCount;
+}
+
+
+size_t getItemCount(const FolderComparison& folderCmp)
+{
+    size_t itemCount = 0;
+    for (const BaseFolderPair& baseFolder : asRange(folderCmp))
+        itemCount += getItemCount(baseFolder);
+    return itemCount;
+}
+
+
+int64_t getPeakMemoryKiB()
+{
+    rusage usage = {};
+    if (::getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+    return usage.ru_maxrss; //Linux: kilobytes
+}
+
+
+void printResult(int run, const char* phaseName, size_t itemCount, std::chrono::nanoseconds duration, size_t errorCount)
+{
+    const double seconds = std::chrono::duration<double>(duration).count();
+
+    JsonValue result(JsonValue::Type::object);
+    result.objectVal.set("run",         run);
+    result.objectVal.set("phase",       phaseName);
+    result.objectVal.set("items",       static_cast<int64_t>(itemCount));
+    result.objectVal.set("seconds",     seconds);
+    result.objectVal.set("itemsPerSec", seconds > 0 ? itemCount / seconds : 0.0);
+    result.objectVal.set("peakRssKiB",  getPeakMemoryKiB());
+    result.objectVal.set("errors",      static_cast<int64_t>(errorCount));
+
+    std::cout << serializeJson(result, "" /*lineBreak*/, "" /*indent*/) << std::endl; //one JSON object per line
+}
+
+
+int runBenchmark(const BenchmarkConfig& cfg) //throw FileError
+{
+    const Zstring benchFolderPath = appendPath(cfg.tempFolderPath, Zstr("FreeFileSync Benchmark ") + utfTo<Zstring>(formatAsHexString(generateGUID().substr(0, 4))));
+    const Zstring folderPathL = appendPath(benchFolderPath, Zstr("Left"));
+    const Zstring folderPathR = appendPath(benchFolderPath, Zstr("Right"));
+
+    createDirectory(benchFolderPath); //throw FileError, ErrorTargetExisting
+    ZEN_ON_SCOPE_EXIT
+    (
+        if (!cfg.keepFiles)
+            try { removeDirectoryPlainRecursion(benchFolderPath); /*throw FileError*/ }
+            catch (const FileError& e) { std::cerr << utfTo<std::string>(e.toString()) << std::endl; }
+    );
+    createDirectory(folderPathL); //throw FileError, ErrorTargetExisting
+    createDirectory(folderPathR); //
+
+    std::cerr << "Benchmark folder: " << utfTo<std::string>(benchFolderPath) << std::endl;
+
+    //one folder pair: "Left" and "Right"; more: "Left/Pair <i>" and "Right/Pair <i>"
+    std::vector<std::pair<Zstring, Zstring>> folderPairPaths;
+    if (cfg.pairCount == 1)
+        folderPairPaths.emplace_back(folderPathL, folderPathR);
+    else
+        for (size_t i = 0; i < cfg.pairCount; ++i)
+        {
+            const Zstring pairName = Zstr("Pair ") + numberTo<Zstring>(i);
+            folderPairPaths.emplace_back(appendPath(folderPathL, pairName), appendPath(folderPathR, pairName));
+            createDirectory(folderPairPaths.back().first);  //throw FileError, ErrorTargetExisting
+            createDirectory(folderPairPaths.back().second); //
+        }
+
+    BenchmarkCallback callback;
+    {
+        StopWatch stopWatch;
+        size_t itemCount = 0;
+        for (size_t i = 0; i < folderPairPaths.size(); ++i)
+        {
+            TreeConfig treeCfg = cfg.tree;
+            treeCfg.fileCount = cfg.tree.fileCount / cfg.pairCount + (i < cfg.tree.fileCount % cfg.pairCount ? 1 : 0);
+            treeCfg.seed      = cfg.tree.seed + i;
+
+            const TreeStats stats = generateTreePair(folderPairPaths[i].first, folderPairPaths[i].second, treeCfg); //throw FileError
+            itemCount += stats.folderCount * 2 + stats.fileCountLeft + stats.fileCountRight;
+        }
+        printResult(0, "generate", itemCount, stopWatch.elapsed(), callback.getErrorCount());
+    }
+
+    //outside of the compared trees:
+    const Zstring contentPathEqualL = appendPath(benchFolderPath, Zstr("Content Equal L.dat"));
+    const Zstring contentPathEqualR = appendPath(benchFolderPath, Zstr("Content Equal R.dat"));
+    const Zstring contentPathDiffL  = appendPath(benchFolderPath, Zstr("Content Diff L.dat"));
+    const Zstring contentPathDiffR  = appendPath(benchFolderPath, Zstr("Content Diff R.dat"));
+    if (cfg.contentFileSize > 0)
+    {
+        generateFilePair(contentPathEqualL, contentPathEqualR, cfg.contentFileSize, std::nullopt); //throw FileError
+        generateFilePair(contentPathDiffL,  contentPathDiffR,  cfg.contentFileSize, cfg.contentFileSize - 1); //
+    }
+
+    const std::vector<ArgbImage> icons = !cfg.iconFolderPath.empty() ? loadPngImages(cfg.iconFolderPath) : std::vector<ArgbImage>(); //throw FileError
+    if (!cfg.iconFolderPath.empty() && icons.empty())
+        throw FileError(L"No *.png files found: " + utfTo<std::wstring>(cfg.iconFolderPath));
+
+    MainConfiguration mainCfg;
+    for (const auto& [pairPathL, pairPathR] : folderPairPaths)
+    {
+        LocalPairConfig& lpc = mainCfg.additionalPairs.emplace_back();
+        lpc.folderPathPhraseLeft  = pairPathL;
+        lpc.folderPathPhraseRight = pairPathR;
+    }
+    mainCfg.firstPair = mainCfg.additionalPairs.front();
+    mainCfg.additionalPairs.erase(mainCfg.additionalPairs.begin());
+    mainCfg.ignoreErrors = true;
+
+    if (cfg.parallelOps) //store 1, too: forces single thread
+        setDeviceParallelOps(mainCfg.deviceParallelOps, folderPathL, *cfg.parallelOps); //same device for both sides
+
+    WarningDialogs warnings;
+
+    for (int run = 1; run <= cfg.runs; ++run)
+    {
+        auto measure = [&](const char* phaseName, const std::function<size_t()>& runPhase)
+        {
+            StopWatch stopWatch;
+            const size_t itemCount = runPhase();
+            printResult(run, phaseName, itemCount, stopWatch.elapsed(), callback.getErrorCount());
+        };
+
+        measure("scan", [&]
+        {
+            const FilterRef nullFilter = makeSharedRef<NullFilter>();
+
+            std::set<DirectoryKey> foldersToRead;
+            for (const auto& [pairPathL, pairPathR] : folderPairPaths)
+            {
+                foldersToRead.insert({createAbstractPath(pairPathL), nullFilter, mainCfg.cmpCfg.handleSymlinks});
+                foldersToRead.insert({createAbstractPath(pairPathR), nullFilter, mainCfg.cmpCfg.handleSymlinks});
+            }
+
+            const std::map<DirectoryKey, DirectoryValue> buf = parallelFolderScan(foldersToRead,
+            callback, [](const std::wstring& statusLine, int itemsTotal) {}, UI_UPDATE_INTERVAL);
+            size_t itemCount = 0;
+            for (const auto& [folderKey, folderVal] : buf)
+                itemCount += getItemCount(folderVal.folderCont);
+            return itemCount;
+        });
+
+        FolderComparison folderCmp;
+        measure("compare", [&]
+        {
+            std::unique_ptr<LockHolder> dirLocks;
+            folderCmp = compare(warnings,
+                                FAT_FILE_TIME_PRECISION_SEC,
+                                {} /*requestPassword*/,
+                                false /*runWithBackgroundPriority*/,
+                                false /*createDirLocks*/,
+                                dirLocks,
+                                extractCompareCfg(mainCfg),
+                                mainCfg.deviceParallelOps,
+                                std::nullopt /*changeList*/,
+                                callback);
+            return getItemCount(folderCmp);
+        });
+        if (folderCmp.empty()) //fatal error => already logged
+            return 1;
+
+        measure("syncDirection", [&]
+        {
+            redetermineSyncDirection(extractDirectionCfg(folderCmp, mainCfg), mainCfg.deviceParallelOps, callback);
+            return getItemCount(folderCmp);
+        });
+
+        measure("dbSave", [&]
+        {
+            for (const BaseFolderPair& baseFolder : asRange(folderCmp))
+                saveLastSynchronousState(baseFolder, true /*transactionalCopy*/, mainCfg.deviceParallelOps, callback);
+            return getItemCount(folderCmp);
+        });
+
+        measure("dbLoad", [&]
+        {
+            std::vector<const BaseFolderPair*> baseFolders;
+            for (const BaseFolderPair& baseFolder : asRange(folderCmp))
+                baseFolders.push_back(&baseFolder);
+
+            size_t itemCount = 0;
+            for (const auto& [baseFolder, lastSyncState] : loadLastSynchronousState(baseFolders, mainCfg.deviceParallelOps, callback))
+                itemCount += getItemCount(lastSyncState.ref());
+            return itemCount;
+        });
+
+        if (cfg.contentFileSize > 0)
+        {
+            auto compareContent = [&](const Zstring& filePathL, const Zstring& filePathR, bool expectSame)
+            {
+                try
+                {
+                    if (filesHaveSameContent(createAbstractPath(filePathL),
+                                             createAbstractPath(filePathR), cfg.contentFileSize, nullptr /*notifyUnbufferedIO*/) != expectSame) //throw FileError
+                        callback.reportFatalError(L"Unexpected content comparison result: " + utfTo<std::wstring>(filePathL));
+                }
+                catch (const FileError& e) { callback.reportFatalError(e.toString()); }
+                return 1;
+            };
+            measure("contentEqual",     [&] { return compareContent(contentPathEqualL, contentPathEqualR, true  /*expectSame*/); });
+            measure("contentDiffAtEnd", [&] { return compareContent(contentPathDiffL,  contentPathDiffR,  false /*expectSame*/); });
+        }
+
+        if (!icons.empty())
+        {
+            size_t pixelCountMax = 0;
+            for (const ArgbImage& img : icons)
+                pixelCountMax = std::max(pixelCountMax, img.pixels.size());
+
+            std::vector<uint32_t> trgBuf(pixelCountMax * xbrz::SCALE_FACTOR_MAX * xbrz::SCALE_FACTOR_MAX); //allocate once: measure scaling only
+
+            for (int factor = 2; factor <= xbrz::SCALE_FACTOR_MAX; ++factor)
+                measure(("xbrzScale" + numberTo<std::string>(factor) + 'x').c_str(), [&]
+            {
+                size_t pixelCount = 0;
+                for (const ArgbImage& img : icons)
+                {
+                    xbrz::scale(factor, img.pixels.data(), trgBuf.data(), img.width, img.height,
+                                xbrz::ColorFormat::argbUnbuffered); //same as wx+/image_resources.cpp
+                    pixelCount += img.pixels.size();
+                }
+                return pixelCount;
+            });
+        }
+    }
+    return callback.getErrorCount() == 0 ? 0 : 1;
+}
+}
+
+
+int main(int argc, char* argv[])
+{
+    BenchmarkConfig cfg;
+    try
+    {
+        cfg = parseArguments(std::vector<std::string>(argv + 1, argv + argc)); //throw InvalidArgument
+    }
+    catch (const InvalidArgument& e)
+    {
+        std::cerr << e.msg << "\n\n" << usageText;
+        return 2;
+    }
+
+    if (cfg.tempFolderPath.empty())
+        try
+        {
+            cfg.tempFolderPath = getItemTypeIfExists(Zstr("/dev/shm")) == ItemType::folder ? Zstr("/dev/shm") : getTempFolderPath(); //throw FileError
+        }
+        catch (const FileError& e) { std::cerr << utfTo<std::string>(e.toString()) << std::endl; return 1; }
+
+    initAfs({cfg.tempFolderPath, cfg.tempFolderPath}); //not using cloud/FTP/SFTP: resource and config paths are irrelevant
+    ZEN_ON_SCOPE_EXIT(teardownAfs());
+
+    try
+    {
+        return runBenchmark(cfg); //throw FileError
+    }
+    catch (const FileError& e)
+    {
+        std::cerr << utfTo<std::string>(e.toString()) << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,14 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#include "../base/icon_loader.h"
+
+using namespace zen;
+
+
+//replaces base/icon_loader.cpp which requires GTK and wxWidgets: afs/native.cpp only needs these two for AFS::getFileIcon() and AFS::getThumbnailImage()
+FileIconHolder fff::getFileIcon(const Zstring& filePath, int maxSize) { return {}; } //optional return value
+ImageHolder fff::getThumbnailImage(const Zstring& filePath, int maxSize) { return {}; } //
@@ -0,0 +1,188 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#include "tree_generator.h"
+#include <random>
+#include <zen/file_access.h>
+#include <zen/file_io.h>
+#include <zen/file_path.h>
+#include <zen/utf.h>
+
+using namespace zen;
+using namespace fff;
+
+
+namespace
+{
+Zstring generateName(std::mt19937_64& rng, NameDistribution nameDist, size_t uniqueId)
+{
+    const std::string_view asciiChars = "abcdefghijklmnopqrstuvwxyz0123456789-_";
+
+    const std::wstring_view unicodeChars[] =
+    {
+        L"a", L"k", L"x", L"7",
+        L"\u00E9", L"e\u0301", //precomposed vs decomposed
+        L"\u00FC", L"u\u0308", //
+        L"\u00DF", L"\u00C5",
+        L"\u0416", L"\u044F", L"\u0434", //Cyrillic
+        L"\u6F22", L"\u5B57", L"\u65E5", L"\u672C", //CJK
+        L"\U0001F600", L"\U0001F4C1", //emoji: outside BMP
+    };
+
+    auto randomLength = [&](size_t minLen, size_t maxLen) { return std::uniform_int_distribution<size_t>(minLen, maxLen)(rng); };
+
+    Zstring name;
+    switch (nameDist)
+    {
+        case NameDistribution::ascii:
+        case NameDistribution::longName:
+        {
+            //NAME_MAX: 255 bytes => leave room for unique ID and file extension
+            const size_t len = nameDist == NameDistribution::ascii ? randomLength(4, 16) : randomLength(120, 220);
+            std::uniform_int_distribution<size_t> charDist(0, asciiChars.size() - 1);
+            for (size_t i = 0; i < len; ++i)
+                name += asciiChars[charDist(rng)];
+        }
+        break;
+
+        case NameDistribution::unicode:
+        {
+            const size_t len = randomLength(4, 16);
+            std::uniform_int_distribution<size_t> charDist(0, std::size(unicodeChars) - 1);
+            std::wstring nameW;
+            for (size_t i = 0; i < len; ++i)
+                nameW += unicodeChars[charDist(rng)];
+            name = utfTo<Zstring>(nameW);
+        }
+        break;
+    }
+    return name + Zstr('_') + numberTo<Zstring>(uniqueId);
+}
+
+
+void writeFile(const Zstring& filePath, size_t fileSize, char fillChar, time_t modTime) //throw FileError
+{
+    {
+        const std::string content(fileSize, fillChar);
+
+        FileOutputPlain file(filePath); //throw FileError, ErrorTargetExisting
+        for (size_t bytesWritten = 0; bytesWritten < content.size();)
+            bytesWritten += file.tryWrite(content.data() + bytesWritten, content.size() - bytesWritten); //throw FileError; may return short!
+        file.close(); //throw FileError
+    }
+    setFileTime(filePath, modTime, ProcSymlink::follow); //throw FileError
+}
+}
+
+
+TreeStats fff::generateTreePair(const Zstring& folderPathL, const Zstring& folderPathR, const TreeConfig& cfg) //throw FileError
+{
+    std::mt19937_64 rng(cfg.seed);
+    size_t uniqueId = 0;
+
+    TreeStats stats;
+
+    //------------ folders: identical on both sides ------------
+    std::vector<Zstring> folderRelPaths{Zstring()};
+    {
+        size_t levelBegin = 0;
+        for (int level = 0; level < cfg.depth; ++level)
+        {
+            const size_t levelEnd = folderRelPaths.size();
+            for (size_t i = levelBegin; i < levelEnd; ++i)
+                for (int j = 0; j < cfg.foldersPerFolder; ++j)
+                {
+                    const Zstring relPath = appendPath(folderRelPaths[i], generateName(rng, cfg.names, uniqueId++));
+
+                    createDirectory(appendPath(folderPathL, relPath)); //throw FileError, ErrorTargetExisting
+                    createDirectory(appendPath(folderPathR, relPath)); //
+                    folderRelPaths.push_back(relPath);
+                }
+            levelBegin = levelEnd;
+        }
+    }
+    stats.folderCount = folderRelPaths.size() - 1;
+
+    //------------ files: randomly distributed over all folders ------------
+    const Zstring fileExtensions[] = {Zstr(".txt"), Zstr(".jpg"), Zstr(".cpp"), Zstr(".pdf"), Zstr(".dat"), Zstring()};
+
+    std::uniform_int_distribution<size_t> folderDist(0, folderRelPaths.size() - 1);
+    std::uniform_int_distribution<size_t> extDist   (0, std::size(fileExtensions) - 1);
+    std::uniform_int_distribution<size_t> sizeDist  (0, cfg.maxFileSize);
+    std::uniform_int_distribution<time_t> timeDist  (1'500'000'000, 1'700'000'000);
+    std::uniform_real_distribution<double> probDist (0, 1);
+
+    for (size_t i = 0; i < cfg.fileCount; ++i)
+    {
+        const Zstring relPath = appendPath(folderRelPaths[folderDist(rng)],
+                                           generateName(rng, cfg.names, uniqueId++) + fileExtensions[extDist(rng)]);
+        const size_t fileSize = sizeDist(rng);
+        const time_t modTime = timeDist(rng);
+        const char fillChar = static_cast<char>('a' + i % 26);
+
+        enum class ChangeType
+        {
+            none,
+            modified, //different size and newer time on right side
+            leftOnly,
+            rightOnly,
+        };
+        const ChangeType changeType = [&]
+        {
+            if (probDist(rng) >= cfg.changeRate)
+                return ChangeType::none;
+            const double p = probDist(rng);
+            return p < 0.5 ? ChangeType::modified : p < 0.75 ? ChangeType::leftOnly : ChangeType::rightOnly;
+        }();
+
+        if (changeType != ChangeType::rightOnly)
+        {
+            writeFile(appendPath(folderPathL, relPath), fileSize, fillChar, modTime); //throw FileError
+            stats.bytesTotal += fileSize;
+            ++stats.fileCountLeft;
+        }
+        if (changeType != ChangeType::leftOnly)
+        {
+            const size_t fileSizeR = changeType == ChangeType::modified ? fileSize + 1 : fileSize;
+            writeFile(appendPath(folderPathR, relPath), fileSizeR, fillChar, changeType == ChangeType::modified ? modTime + 3600 : modTime); //throw FileError
+            stats.bytesTotal += fileSizeR;
+            ++stats.fileCountRight;
+        }
+        if (changeType != ChangeType::none)
+            ++stats.changedCount;
+    }
+    return stats;
+}
+
+
+void fff::generateFilePair(const Zstring& filePathL, const Zstring& filePathR, uint64_t fileSize, std::optional<uint64_t> diffOffset) //throw FileError
+{
+    assert(!diffOffset || *diffOffset < fileSize);
+
+    std::mt19937_64 rng(fileSize);
+    std::string chunk(1024 * 1024, '\0'); //random content: no zero pages, no compressible data
+    for (char& c : chunk)
+        c = static_cast<char>(rng());
+
+    FileOutputPlain fileL(filePathL); //throw FileError, ErrorTargetExisting
+    FileOutputPlain fileR(filePathR); //
+
+    for (uint64_t chunkPos = 0; chunkPos < fileSize; chunkPos += chunk.size())
+    {
+        const size_t chunkSize = static_cast<size_t>(std::min<uint64_t>(chunk.size(), fileSize - chunkPos));
+
+        std::string chunkR(chunk.data(), chunkSize);
+        if (diffOffset && chunkPos <= *diffOffset && *diffOffset < chunkPos + chunkSize)
+            chunkR[*diffOffset - chunkPos] ^= 1;
+
+        for (size_t bytesWritten = 0; bytesWritten < chunkSize;)
+            bytesWritten += fileL.tryWrite(chunk.data() + bytesWritten, chunkSize - bytesWritten); //throw FileError; may return short!
+        for (size_t bytesWritten = 0; bytesWritten < chunkSize;)
+            bytesWritten += fileR.tryWrite(chunkR.data() + bytesWritten, chunkSize - bytesWritten); //throw FileError; may return short!
+    }
+    fileL.close(); //throw FileError
+    fileR.close(); //
+}
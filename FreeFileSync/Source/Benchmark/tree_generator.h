@@ -0,0 +1,54 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#ifndef TREE_GENERATOR_H_7304581290345872
+#define TREE_GENERATOR_H_7304581290345872
+
+#include <cstdint>
+#include <optional>
+#include <zen/zstring.h>
+#include <zen/file_error.h>
+
+
+namespace fff
+{
+enum class NameDistribution
+{
+    ascii,    //short names: [a-z0-9-_]
+    longName, //close to NAME_MAX
+    unicode,  //accents (precomposed and decomposed), Cyrillic, CJK, emoji
+};
+
+
+struct TreeConfig
+{
+    size_t fileCount = 100'000;
+    int depth = 4;            //levels of sub folders below the base folder
+    int foldersPerFolder = 6; //=> folder count: sum of foldersPerFolder^i, i = 1..depth
+    NameDistribution names = NameDistribution::ascii;
+    double changeRate = 0.05; //share of files differing between left and right: modified : left only : right only = 2:1:1
+    size_t maxFileSize = 1024; //bytes; file sizes are uniformly distributed
+    uint64_t seed = 0;
+};
+
+
+struct TreeStats
+{
+    size_t folderCount = 0; //per side
+    size_t fileCountLeft  = 0;
+    size_t fileCountRight = 0;
+    size_t changedCount = 0;
+    uint64_t bytesTotal = 0; //both sides
+};
+
+//create two (deterministic) folder trees differing by TreeConfig::changeRate; folders must be existing and empty
+TreeStats generateTreePair(const Zstring& folderPathL, const Zstring& folderPathR, const TreeConfig& cfg); //throw FileError
+
+//create two files of same size and content, except for one byte at "diffOffset" (if set)
+void generateFilePair(const Zstring& filePathL, const Zstring& filePathR, uint64_t fileSize, std::optional<uint64_t> diffOffset); //throw FileError
+}
+
+#endif //TREE_GENERATOR_H_7304581290345872
@@ -9,6 +9,7 @@
 #include <zen/dir_watcher.h>
 #include <zen/thread.h>
 #include <zen/resolve_path.h>
+#include <sys/epoll.h>
 //#include "../library/db_file.h"     //SYNC_DB_FILE_ENDING -> complete file too much of a dependency; file ending too little to decouple into single header
 //#include "../library/lock_holder.h" //LOCK_FILE_ENDING
 //TEMP_FILE_ENDING
@@ -18,7 +19,7 @@ using namespace zen;
 
 namespace
 {
-constexpr std::chrono::seconds FOLDER_EXISTENCE_CHECK_INTERVAL(1);
+constexpr std::chrono::seconds FOLDER_EXISTENCE_CHECK_INTERVAL(1); //while waiting for missing folders
 
 
 //wait until all directories become available (again) + logs in network share
@@ -114,91 +115,164 @@ std::set<Zstring, LessNativePath> waitForMissingDirs(const std::vector<Zstring>&
 }
 
 
-//wait until changes are detected or if a directory is not available (anymore)
-DirWatcher::Change waitForChanges(const std::set<Zstring, LessNativePath>& folderPaths, //throw FileError
-                                  const std::function<void(bool readyForSync)>& requestUiUpdate, std::chrono::milliseconds cbInterval)
+//watches are kept alive across command executions: (re-)creating DirWatcher for huge folder hierarchies is expensive and would miss changes meanwhile
+class FolderMonitor
 {
-    if (folderPaths.empty()) //pathological case, but we have to check or this function waits forever
-        throw FileError(_("A folder input field is empty.")); //should have been checked by caller!
-
-    std::vector<std::pair<Zstring, std::unique_ptr<DirWatcher>>> watches;
+public:
+    explicit FolderMonitor(const std::set<Zstring, LessNativePath>& folderPaths) //throw FileError
+    {
+        if (folderPaths.empty()) //pathological case, but we have to check or waitForChanges() waits forever
+            throw FileError(_("A folder input field is empty.")); //should have been checked by caller!
 
-    for (const Zstring& folderPath : folderPaths)
-        try
-        {
-            watches.emplace_back(folderPath, std::make_unique<DirWatcher>(folderPath)); //throw FileError
-        }
-        catch (FileError&)
-        {
-            try { getItemType(folderPath); } //throw FileError
+        for (const Zstring& folderPath : folderPaths)
+            try
+            {
+                watches_.emplace_back(folderPath, std::make_unique<DirWatcher>(folderPath)); //throw FileError
+            }
             catch (FileError&)
             {
-                assert(false); //why "unavailable"!? violating waitForChanges() precondition!
-                return {DirWatcher::ChangeType::baseFolderUnavailable, folderPath};
+                try { getItemType(folderPath); } //throw FileError
+                catch (FileError&)
+                {
+                    assert(false); //why "unavailable"!? violating FolderMonitor() precondition!
+                    pendingChange_ = {DirWatcher::ChangeType::baseFolderUnavailable, folderPath};
+                    return;
+                }
+
+                throw;
             }
 
-            throw;
+        auto fmtFolderPaths = [&]
+        {
+            std::wstring output;
+            for (const Zstring& folderPath : folderPaths)
+                output += (output.empty() ? L"" : L", ") + fmtPath(folderPath);
+            return output;
+        };
+
+        //single wait over all inotify descriptors: wake up on changes or when UI needs an update, instead of sleep-polling each watcher
+        epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd_ == -1)
+            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtFolderPaths()), "epoll_create1");
+        ZEN_ON_SCOPE_FAIL(::close(epollFd_));
+
+        for (size_t i = 0; i < watches_.size(); ++i)
+        {
+            epoll_event evt{.events = EPOLLIN, .data{.u64 = i}};
+            if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, watches_[i].second->getWaitHandle(), &evt) != 0)
+                THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(watches_[i].first)), "epoll_ctl(EPOLL_CTL_ADD)");
         }
 
-    auto lastCheckTime = std::chrono::steady_clock::now();
-    for (;;)
+        errorMsg_ = replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtFolderPaths());
+    }
+
+    ~FolderMonitor()
+    {
+        if (epollFd_ != -1)
+            ::close(epollFd_);
+    }
+
+    //wait until changes are detected or if a directory is not available (anymore): returns at least one change, ChangeType::baseFolderUnavailable first
+    std::vector<DirWatcher::Change> waitForChanges(const std::function<void(bool readyForSync)>& requestUiUpdate, std::chrono::milliseconds cbInterval) //throw FileError, X
     {
-        const bool checkDirNow = [&] //checking once per sec should suffice
+        if (pendingChange_)
         {
-            const auto now = std::chrono::steady_clock::now();
-            if (now > lastCheckTime + FOLDER_EXISTENCE_CHECK_INTERVAL)
-            {
-                lastCheckTime = now;
-                return true;
-            }
-            return false;
-        }();
+            ZEN_ON_SCOPE_EXIT(pendingChange_ = std::nullopt);
+            return {*pendingChange_};
+        }
 
-        for (const auto& [folderPath, watcher] : watches)
+        std::vector<epoll_event> events(watches_.size());
+        auto nextUiUpdate = std::chrono::steady_clock::now() + cbInterval;
+        for (;;)
         {
-            //IMPORTANT CHECK: DirWatcher has problems detecting removal of top watched directories!
-            if (checkDirNow)
-                try //catch errors related to directory removal, e.g. ERROR_NETNAME_DELETED
-                {
-                    getItemType(folderPath); //throw FileError
-                }
-                catch (FileError&) { return {DirWatcher::ChangeType::baseFolderUnavailable, folderPath}; }
+            const auto timeoutMs = std::chrono::ceil<std::chrono::milliseconds>(std::max(nextUiUpdate - std::chrono::steady_clock::now(),
+                                                                                         std::chrono::steady_clock::duration::zero()));
+            int evtCount = 0;
+            do
+                evtCount = ::epoll_wait(epollFd_, events.data(), static_cast<int>(events.size()), static_cast<int>(timeoutMs.count()));
+            while (evtCount < 0 && errno == EINTR);
 
-            try
-            {
-                std::vector<DirWatcher::Change> changes = watcher->fetchChanges([&] { requestUiUpdate(false /*readyForSync*/); /*throw X*/ },
-                                                                                cbInterval); //throw FileError
+            if (evtCount < 0)
+                THROW_LAST_FILE_ERROR(errorMsg_, "epoll_wait");
 
-                //give precedence to ChangeType::baseFolderUnavailable
-                for (const DirWatcher::Change& change : changes)
-                    if (change.type == DirWatcher::ChangeType::baseFolderUnavailable)
-                        return change;
+            for (int i = 0; i < evtCount; ++i)
+            {
+                std::vector<DirWatcher::Change> changes = fetchChanges(watches_[events[i].data.u64], [&] { requestUiUpdate(false /*readyForSync*/); /*throw X*/ }, cbInterval); //throw FileError
 
-                std::erase_if(changes, [](const DirWatcher::Change& e)
+                //give precedence to ChangeType::baseFolderUnavailable (reported by DirWatcher via IN_DELETE_SELF/IN_MOVE_SELF/IN_UNMOUNT)
+                std::stable_partition(changes.begin(), changes.end(), [](const DirWatcher::Change& change)
                 {
-                    return
-                        endsWith(e.itemPath, Zstr(".ffs_tmp"))  || //sync.8ea2.ffs_tmp
-                        endsWith(e.itemPath, Zstr(".ffs_lock")) || //sync.ffs_lock, sync.Del.ffs_lock
-                        endsWith(e.itemPath, Zstr(".ffs_db"));     //sync.ffs_db
-                    //no need to ignore temporary recycle bin directory: this must be caused by a file deletion anyway
+                    return change.type == DirWatcher::ChangeType::baseFolderUnavailable;
                 });
 
                 if (!changes.empty())
-                    return changes[0];
+                    return changes;
             }
-            catch (FileError&)
-            {
-                try { getItemType(folderPath); } //throw FileError
-                catch (FileError&) { return {DirWatcher::ChangeType::baseFolderUnavailable, folderPath}; }
 
-                throw;
+            if (const auto now = std::chrono::steady_clock::now();
+                now >= nextUiUpdate)
+            {
+                nextUiUpdate = now + cbInterval;
+                requestUiUpdate(true /*readyForSync*/); //throw X: may start sync at this presumably idle time
             }
         }
+    }
 
-        std::this_thread::sleep_for(cbInterval);
-        requestUiUpdate(true /*readyForSync*/); //throw X: may start sync at this presumably idle time
+    //don't trigger on changes accumulated so far, e.g. caused by the command itself; but remember missing base folders!
+    //=> return changes anyway: caller may want to include them in the next change set
+    std::vector<DirWatcher::Change> discardChanges() //throw FileError
+    {
+        std::vector<DirWatcher::Change> output;
+        if (!pendingChange_)
+            for (auto& watch : watches_)
+                for (const DirWatcher::Change& change : fetchChanges(watch, [] {}, std::chrono::milliseconds(0))) //throw FileError
+                {
+                    if (change.type == DirWatcher::ChangeType::baseFolderUnavailable)
+                    {
+                        pendingChange_ = change;
+                        return output;
+                    }
+                    output.push_back(change);
+                }
+        return output;
     }
-}
+
+private:
+    FolderMonitor           (const FolderMonitor&) = delete;
+    FolderMonitor& operator=(const FolderMonitor&) = delete;
+
+    static std::vector<DirWatcher::Change> fetchChanges(std::pair<Zstring, std::unique_ptr<DirWatcher>>& watch, //throw FileError
+                                                        const std::function<void()>& requestUiUpdate, std::chrono::milliseconds cbInterval)
+    {
+        const auto& [folderPath, watcher] = watch;
+        try
+        {
+            std::vector<DirWatcher::Change> changes = watcher->fetchChanges(requestUiUpdate, cbInterval); //throw FileError
+
+            std::erase_if(changes, [](const DirWatcher::Change& e)
+            {
+                return
+                    endsWith(e.itemPath, Zstr(".ffs_tmp"))  || //sync.8ea2.ffs_tmp
+                    endsWith(e.itemPath, Zstr(".ffs_lock")) || //sync.ffs_lock, sync.Del.ffs_lock
+                    endsWith(e.itemPath, Zstr(".ffs_db"));     //sync.ffs_db
+                //no need to ignore temporary recycle bin directory: this must be caused by a file deletion anyway
+            });
+            return changes;
+        }
+        catch (FileError&)
+        {
+            try { getItemType(folderPath); } //throw FileError
+            catch (FileError&) { return {{DirWatcher::ChangeType::baseFolderUnavailable, folderPath}}; }
+
+            throw;
+        }
+    }
+
+    std::vector<std::pair<Zstring, std::unique_ptr<DirWatcher>>> watches_;
+    int epollFd_ = -1;
+    std::wstring errorMsg_;
+    std::optional<DirWatcher::Change> pendingChange_;
+};
 
 
 std::wstring getChangeTypeName(DirWatcher::ChangeType type)
@@ -223,7 +297,7 @@ struct ExecCommandNowException {};
 
 
 void rts::monitorDirectories(const std::vector<Zstring>& folderPathPhrases, std::chrono::seconds delay,
-                             const std::function<void(const Zstring& itemPath, const std::wstring& actionName)>& executeExternalCommand /*throw FileError*/,
+                             const std::function<void(const Zstring& itemPath, const std::wstring& actionName, const std::vector<Zstring>& watchedFolderPaths, const std::vector<Zstring>& changedItemPaths)>& executeExternalCommand /*throw FileError*/,
                              const std::function<void(const Zstring* missingFolderPath)>& requestUiUpdate,
                              const std::function<void(const std::wstring& msg         )>& reportError,
                              std::chrono::milliseconds cbInterval)
@@ -240,6 +314,14 @@ void rts::monitorDirectories(const std::vector<Zstring>& folderPathPhrases, std:
             //schedule initial execution (*after* all directories have arrived)
             auto nextExecTime = std::chrono::steady_clock::now() + delay;
 
+            std::optional<FolderMonitor> monitor;
+            monitor.emplace(folderPaths); //throw FileError
+
+            //all changes since last command execution: missing base folder (or lost events) is reported via the base folder path
+            std::set<Zstring> changedItemPaths;
+            for (const Zstring& folderPath : folderPaths)
+                changedItemPaths.insert(folderPath); //initial execution: everything is "changed"
+
             for (;;) //command executions
             {
                 DirWatcher::Change lastChangeDetected;
@@ -247,7 +329,7 @@ void rts::monitorDirectories(const std::vector<Zstring>& folderPathPhrases, std:
                 {
                     for (;;) //detected changes
                     {
-                        lastChangeDetected = waitForChanges(folderPaths, [&](bool readyForSync) //throw FileError, ExecCommandNowException
+                        const std::vector<DirWatcher::Change> changes = monitor->waitForChanges([&](bool readyForSync) //throw FileError, ExecCommandNowException
                         {
                             requestUiUpdate(nullptr);
 
@@ -255,9 +337,20 @@ void rts::monitorDirectories(const std::vector<Zstring>& folderPathPhrases, std:
                                 throw ExecCommandNowException(); //abort wait and start sync
                         }, cbInterval);
 
+                        lastChangeDetected = changes[0];
+                        for (const DirWatcher::Change& change : changes)
+                            changedItemPaths.insert(change.itemPath);
+
                         if (lastChangeDetected.type == DirWatcher::ChangeType::baseFolderUnavailable)
+                        {
+                            monitor.reset();
                             //don't execute the command before all directories are available!
                             folderPaths = waitForMissingDirs(folderPathPhrases, [&](const Zstring& folderPath) { requestUiUpdate(&folderPath); }, cbInterval); //throw FileError
+                            monitor.emplace(folderPaths); //throw FileError
+
+                            for (const Zstring& folderPath : folderPaths)
+                                changedItemPaths.insert(folderPath); //changes may have been missed meanwhile
+                        }
 
                         nextExecTime = std::chrono::steady_clock::now() + delay;
                     }
@@ -266,9 +359,17 @@ void rts::monitorDirectories(const std::vector<Zstring>& folderPathPhrases, std:
 
                 try
                 {
-                    executeExternalCommand(lastChangeDetected.itemPath, getChangeTypeName(lastChangeDetected.type)); //throw FileError
+                    executeExternalCommand(lastChangeDetected.itemPath, getChangeTypeName(lastChangeDetected.type),
+                                           std::vector<Zstring>(folderPaths.begin(), folderPaths.end()),
+                                           std::vector<Zstring>(changedItemPaths.begin(), changedItemPaths.end())); //throw FileError
                 }
                 catch (const FileError& e) { reportError(e.toString()); }
+                changedItemPaths.clear();
+
+                //don't trigger on changes the command made itself (e.g. FreeFileSync syncing the monitored folders)
+                //but keep them for the next change set: user might have changed files while the command was running
+                for (const DirWatcher::Change& change : monitor->discardChanges()) //throw FileError
+                    changedItemPaths.insert(change.itemPath);
 
                 nextExecTime = std::chrono::steady_clock::time_point::max();
             }
@@ -15,6 +15,10 @@
 #include <wx+/dc.h>
 #include <wx+/image_tools.h>
 #include <zen/process_exec.h>
+#include <zen/file_io.h>
+#include <zen/file_access.h>
+#include <zen/guid.h>
+#include <zen/crc.h>
 #include <wx+/popup_dlg.h>
 #include <wx+/image_resources.h>
 #include "monitor.h"
@@ -246,10 +250,43 @@ rts::CancelReason rts::runFolderMonitor(const FfsRealConfig& config, const wxStr
 
     TrayIconHolder trayIcon(jobname);
 
-    auto executeExternalCommand = [&](const Zstring& changedItemPath, const std::wstring& actionName) //throw FileError
+    //monitored folders and all changed items since last command execution, one path per line: e.g. FreeFileSync job.ffs_batch -ChangeList "%change_list%"
+    Zstring changeListPath;
+    ZEN_ON_SCOPE_EXIT(if (!changeListPath.empty()) try { removeFilePlain(changeListPath); /*throw FileError*/ } catch (FileError&) {});
+
+    auto executeExternalCommand = [&](const Zstring& changedItemPath, const std::wstring& actionName,
+                                      const std::vector<Zstring>& watchedFolderPaths, const std::vector<Zstring>& changedItemPaths) //throw FileError
     {
+        if (changeListPath.empty())
+            changeListPath = appendPath(getTempFolderPath(), //throw FileError
+                                        Zstr("RTS-") + printNumber<Zstring>(Zstr("%08x"), static_cast<unsigned int>(getCrc32(generateGUID()))) + Zstr(".txt"));
+        std::string changeList;
+        auto writeChangedPaths = [&](const std::vector<Zstring>& itemPaths)
+        {
+            for (Zstring itemPath : itemPaths)
+            {
+                //line break in file name? => report parent folder instead
+                while (contains(itemPath, Zstr('\n')))
+                    if (const std::optional<Zstring> parentPath = getParentFolderPath(itemPath))
+                        itemPath = *parentPath;
+                    else
+                        break;
+
+                changeList += utfTo<std::string>(itemPath) + '\n';
+            }
+        };
+        //section names can't be mistaken for (absolute) paths:
+        changeList += "[Watched]\n";
+        for (const Zstring& folderPath : watchedFolderPaths)
+            if (!contains(folderPath, Zstr('\n'))) //don't claim the parent folder as watched! => FreeFileSync falls back to full scan
+                changeList += utfTo<std::string>(folderPath) + '\n';
+        changeList += "[Changed]\n";
+        writeChangedPaths(changedItemPaths);
+        setFileContent(changeListPath, changeList, nullptr /*notifyUnbufferedIO*/); //throw FileError
+
         ::wxSetEnv(L"change_path", utfTo<wxString>(changedItemPath)); //crude way to report changed file
         ::wxSetEnv(L"change_action", actionName);                     //
+        ::wxSetEnv(L"change_list", utfTo<wxString>(changeListPath)); //
         auto cmdLineExp = expandMacros(cmdLine);
 
         try
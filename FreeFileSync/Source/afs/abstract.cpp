@@ -93,7 +93,8 @@ void AFS::traverseFolder(const AfsPath& folderPath, //throw FileError
 
 //already existing: undefined behavior! (e.g. fail/overwrite/auto-rename)
 AFS::FileCopyResult AFS::copyFileAsStream(const AfsPath& sourcePath, const StreamAttributes& sourceAttr, //throw FileError, ErrorFileLocked, X
-                                          const AbstractPath& targetPath, const IoCallback& notifyUnbufferedIO /*throw X*/) const
+                                          const AbstractPath& targetPath, const IoCallback& notifyUnbufferedIO /*throw X*/,
+                                          const IoDataCallback& notifySourceData /*throw X*/) const
 {
     auto streamIn = getInputStream(sourcePath); //throw FileError, ErrorFileLocked
 
@@ -116,7 +117,9 @@ AFS::FileCopyResult AFS::copyFileAsStream(const AfsPath& sourcePath, const Strea
 
     const uint64_t streamSize = unbufferedStreamCopy([&](void* buffer, size_t bytesToRead)
     {
-        return streamIn->tryRead(buffer, bytesToRead, notifyIoDiv); //throw FileError, ErrorFileLocked, X
+        const size_t bytesRead = streamIn->tryRead(buffer, bytesToRead, notifyIoDiv); //throw FileError, ErrorFileLocked, X
+        if (notifySourceData) notifySourceData(buffer, bytesRead); //throw X
+        return bytesRead;
     },
     streamIn->getBlockSize() /*throw FileError*/,
 
@@ -166,14 +169,15 @@ AFS::FileCopyResult AFS::copyFileTransactional(const AbstractPath& sourcePath, c
                                                bool copyFilePermissions,
                                                bool transactionalCopy,
                                                const std::function<void()>& onDeleteTargetFile,
-                                               const IoCallback& notifyUnbufferedIO /*throw X*/)
+                                               const IoCallback& notifyUnbufferedIO /*throw X*/,
+                                               const IoDataCallback& notifySourceData /*throw X*/)
 {
     auto copyFilePlain = [&](const AbstractPath& targetPathTmp)
     {
         //caveat: typeid returns static type for pointers, dynamic type for references!!!
         if (typeid(sourcePath.afsDevice.ref()) == typeid(targetPathTmp.afsDevice.ref()))
             return sourcePath.afsDevice.ref().copyFileForSameAfsType(sourcePath.afsPath, sourceAttr,
-                                                                     targetPathTmp, copyFilePermissions, notifyUnbufferedIO); //throw FileError, ErrorFileLocked, X
+                                                                     targetPathTmp, copyFilePermissions, notifyUnbufferedIO, notifySourceData); //throw FileError, ErrorFileLocked, X
         //already existing: undefined behavior! (e.g. fail/overwrite/auto-rename)
 
         //fall back to stream-based file copy:
@@ -182,7 +186,7 @@ AFS::FileCopyResult AFS::copyFileTransactional(const AbstractPath& sourcePath, c
                             _("Operation not supported between different devices."));
 
         //already existing: undefined behavior! (e.g. fail/overwrite/auto-rename)
-        return sourcePath.afsDevice.ref().copyFileAsStream(sourcePath.afsPath, sourceAttr, targetPathTmp, notifyUnbufferedIO); //throw FileError, ErrorFileLocked, X
+        return sourcePath.afsDevice.ref().copyFileAsStream(sourcePath.afsPath, sourceAttr, targetPathTmp, notifyUnbufferedIO, notifySourceData); //throw FileError, ErrorFileLocked, X
     };
 
     if (transactionalCopy && !hasNativeTransactionalCopy(targetPath))
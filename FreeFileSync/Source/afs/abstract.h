@@ -78,6 +78,9 @@ struct AbstractFileSystem //THREAD-SAFETY: "const" member functions must model t
     static bool supportPermissionCopy(const AbstractPath& sourcePath, const AbstractPath& targetPath); //throw FileError
 
     static bool hasNativeTransactionalCopy(const AbstractPath& itemPath) { return itemPath.afsDevice.ref().hasNativeTransactionalCopy(); }
+
+    //number of threads per device for short, independent tasks (loading/saving sync.ffs_db, versioning limit, ...) unless configured explicitly
+    static size_t getDefaultParallelOps(const AfsDevice& afsDevice) { return afsDevice.ref().getDefaultParallelOps(); }
     //----------------------------------------------------------------------------------------------------------------
 
     using FingerPrint = uint64_t; //AfsDevice-dependent persistent unique ID
@@ -190,6 +193,9 @@ struct AbstractFileSystem //THREAD-SAFETY: "const" member functions must model t
                                                          std::optional<uint64_t> streamSize,
                                                          std::optional<time_t> modTime)
     { return std::make_unique<OutputStream>(filePath.afsDevice.ref().getOutputStream(filePath.afsPath, streamSize, modTime), filePath, streamSize); }
+
+    //MD5 of file content as known by the server *without* reading the file (e.g. Google Drive); raw bytes (see zen::Md5Stream)
+    static std::optional<std::string> tryGetFileMd5Fast(const AbstractPath& filePath) { return filePath.afsDevice.ref().tryGetFileMd5Fast(filePath.afsPath); } //throw FileError
     //----------------------------------------------------------------------------------------------------------------
 
     struct SymlinkInfo
@@ -288,7 +294,9 @@ struct AbstractFileSystem //THREAD-SAFETY: "const" member functions must model t
                                                 //if transactionalCopy == true, full read access on source had been proven at this point, so it's safe to delete it.
                                                 const std::function<void()>& onDeleteTargetFile /*throw X*/,
                                                 //accummulated delta != file size! consider ADS, sparse, compressed files
-                                                const zen::IoCallback& notifyUnbufferedIO /*throw X*/);
+                                                const zen::IoCallback& notifyUnbufferedIO /*throw X*/,
+                                                //optional: source content as it is copied; not called for server-side copies, e.g. within Google Drive!
+                                                const zen::IoDataCallback& notifySourceData /*throw X*/);
     //already existing: fail
     //symlink handling: follow
     static void copyNewFolder(const AbstractPath& sourcePath, const AbstractPath& targetPath, bool copyFilePermissions); //throw FileError
@@ -346,7 +354,8 @@ protected:
 
     //already existing: undefined behavior! (e.g. fail/overwrite/auto-rename)
     FileCopyResult copyFileAsStream(const AfsPath& sourcePath, const StreamAttributes& sourceAttr, //throw FileError, ErrorFileLocked, X
-                                    const AbstractPath& targetPath, const zen::IoCallback& notifyUnbufferedIO /*throw X*/) const;
+                                    const AbstractPath& targetPath, const zen::IoCallback& notifyUnbufferedIO /*throw X*/,
+                                    const zen::IoDataCallback& notifySourceData /*throw X*/) const;
 
 
     std::wstring generateMoveErrorMsg(const AfsPath& pathFrom, const AbstractPath& pathTo) const
@@ -402,6 +411,8 @@ private:
     virtual std::unique_ptr<OutputStreamImpl> getOutputStream(const AfsPath& filePath, //throw FileError
                                                               std::optional<uint64_t> streamSize,
                                                               std::optional<time_t> modTime) const = 0;
+
+    virtual std::optional<std::string> tryGetFileMd5Fast(const AfsPath& filePath) const = 0; //throw FileError
     //----------------------------------------------------------------------------------------------------------------
     virtual void traverseFolderRecursive(const TraverserWorkload& workload /*throw X*/, size_t parallelOps) const = 0;
     //----------------------------------------------------------------------------------------------------------------
@@ -415,7 +426,9 @@ private:
     virtual FileCopyResult copyFileForSameAfsType(const AfsPath& sourcePath, const StreamAttributes& sourceAttr, //throw FileError, ErrorFileLocked, X
                                                   const AbstractPath& targetPath, bool copyFilePermissions,
                                                   //accummulated delta != file size! consider ADS, sparse, compressed files
-                                                  const zen::IoCallback& notifyUnbufferedIO /*throw X*/) const = 0;
+                                                  const zen::IoCallback& notifyUnbufferedIO /*throw X*/,
+                                                  //source content as it is copied; not called for server-side copies!
+                                                  const zen::IoDataCallback& notifySourceData /*throw X*/) const = 0;
 
 
     //symlink handling: follow
@@ -432,6 +445,8 @@ private:
     virtual void authenticateAccess(const RequestPasswordFun& requestPassword /*throw X*/) const = 0; //throw FileError, X
 
     virtual bool hasNativeTransactionalCopy() const = 0;
+
+    virtual size_t getDefaultParallelOps() const = 0;
     //----------------------------------------------------------------------------------------------------------------
 
     virtual int64_t getFreeDiskSpace(const AfsPath& folderPath) const = 0; //throw FileError, returns < 0 if not available
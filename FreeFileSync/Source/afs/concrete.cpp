@@ -57,3 +57,9 @@ AbstractPath fff::createAbstractPath(const Zstring& itemPathPhrase) //noexcept
     //no idea? => native!
     return createItemPathNative(itemPathPhrase);
 }
+
+
+void fff::setDeviceTransferSessionsMax(const AfsDevice& afsDevice, size_t sessionsMax) //noexcept
+{
+    setSftpSegmentSessionsMax(afsDevice, sessionsMax); //only SFTP supports segmented transfer
+}
@@ -21,6 +21,9 @@ void teardownAfs();
 
 AbstractPath getNullPath();
 AbstractPath createAbstractPath(const Zstring& itemPathPhrase); //noexcept
+
+//extra connections a device may open to transfer a single large file in parallel, shared by all file transfers; 0 (default): none
+void setDeviceTransferSessionsMax(const AfsDevice& afsDevice, size_t sessionsMax); //noexcept
 }
 
 #endif //FS_CONCRETE_348787329573243
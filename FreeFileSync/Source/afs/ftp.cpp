@@ -2436,6 +2436,8 @@ private:
         return std::make_unique<OutputStreamFtp>(login_, filePath, modTime);
     }
 
+    std::optional<std::string> tryGetFileMd5Fast(const AfsPath& filePath) const override { return {}; } //throw FileError
+
     //----------------------------------------------------------------------------------------------------------------
     void traverseFolderRecursive(const TraverserWorkload& workload /*throw X*/, size_t parallelOps) const override
     {
@@ -2446,14 +2448,15 @@ private:
     //symlink handling: follow
     //already existing: undefined behavior! (e.g. fail/overwrite/auto-rename)
     FileCopyResult copyFileForSameAfsType(const AfsPath& sourcePath, const StreamAttributes& sourceAttr, //throw FileError, (ErrorFileLocked), X
-                                          const AbstractPath& targetPath, bool copyFilePermissions, const IoCallback& notifyUnbufferedIO /*throw X*/) const override
+                                          const AbstractPath& targetPath, bool copyFilePermissions, const IoCallback& notifyUnbufferedIO /*throw X*/,
+                                          const IoDataCallback& notifySourceData /*throw X*/) const override
     {
         //no native FTP file copy => use stream-based file copy:
         if (copyFilePermissions)
             throw FileError(replaceCpy(_("Cannot write permissions of %x."), L"%x", fmtPath(AFS::getDisplayPath(targetPath))), _("Operation not supported by device."));
 
         //already existing: undefined behavior! (e.g. fail/overwrite/auto-rename)
-        return copyFileAsStream(sourcePath, sourceAttr, targetPath, notifyUnbufferedIO); //throw FileError, (ErrorFileLocked), X
+        return copyFileAsStream(sourcePath, sourceAttr, targetPath, notifyUnbufferedIO, notifySourceData); //throw FileError, (ErrorFileLocked), X
     }
 
     //symlink handling: follow
@@ -2571,6 +2574,9 @@ private:
     }
 
     bool hasNativeTransactionalCopy() const override { return false; }
+
+    //FTP servers commonly restrict connections per IP (often to a single one)
+    size_t getDefaultParallelOps() const override { return 1; }
     //----------------------------------------------------------------------------------------------------------------
 
     int64_t getFreeDiskSpace(const AfsPath& folderPath) const override { return -1; } //throw FileError, returns < 0 if not available
@@ -21,6 +21,7 @@
 #include <zen/time.h>
 #include <zen/zlib_wrap.h>
 #include "abstract_impl.h"
+#include "gdrive_batch.h"
 #include "init_curl_libssh2.h"
     #include <poll.h>
 
@@ -367,6 +368,172 @@ HttpSession::Result gdriveHttpsRequest(const std::string& serverRelPath, //throw
                               receiveHeader /*throw X*/, access.timeoutSec); //throw SysError, X
 }
 
+//========================================================================================================
+//batch requests: https://developers.google.com/drive/api/guides/performance#batch-requests
+//- coalesce up to 100 metadata calls into a single round-trip (each call still counts against the quota)
+//- media uploads/downloads are not supported
+//- request/response codec: see gdrive_batch.h
+constexpr size_t GDRIVE_BATCHES_IN_FLIGHT_MAX = 4; //per account: don't fall behind the parallelism we had before batching
+
+
+std::vector<GdriveMetaResponse> gdriveBatchRequest(const std::vector<const GdriveMetaRequest*>& requests, const GdriveAccess& access) //throw SysError
+{
+    assert(requests.size() <= GDRIVE_BATCH_SIZE_MAX);
+    const std::string boundary = "ffs_batch_" + formatAsHexString(generateGUID());
+    const std::string postBuf = formatGdriveBatchRequest(requests, boundary);
+
+    std::string response;
+    std::string responseBoundary;
+    const HttpSession::Result httpResult = gdriveHttpsRequest(GDRIVE_BATCH_PATH, {"Content-Type: multipart/mixed; boundary=" + boundary},
+    {{CURLOPT_POSTFIELDS, postBuf.c_str()}}, [&](std::span<const char> buf) { response.append(buf.data(), buf.size()); },
+    nullptr /*readRequest*/, [&](const std::string_view& header)
+    {
+        //Content-Type: multipart/mixed; boundary=batch_XYZ
+        if (startsWithAsciiNoCase(header, "Content-Type:"))
+        {
+            responseBoundary = afterFirst(header, "boundary=", IfNotFoundReturn::none);
+            trim(responseBoundary, TrimSide::both, [](char c) { return isWhiteSpace(c) || c == '"'; });
+        }
+    }, access); //throw SysError
+
+    if (httpResult.statusCode != 200 || responseBoundary.empty())
+        throw SysError(formatGdriveErrorRaw(response));
+
+    return parseGdriveBatchResponse(response, responseBoundary, requests.size()); //throw SysError
+}
+
+
+GdriveMetaResponse gdriveMetaRequestPlain(const GdriveMetaRequest& req, const GdriveAccess& access) //throw SysError
+{
+    std::vector<std::string> extraHeaders;
+    std::vector<CurlOption> extraOptions;
+    if (req.method != "GET" && req.method != "POST")
+        extraOptions.emplace_back(CURLOPT_CUSTOMREQUEST, req.method.c_str());
+    if (!req.jsonBody.empty())
+    {
+        extraHeaders.push_back("Content-Type: application/json; charset=UTF-8");
+        extraOptions.emplace_back(CURLOPT_POSTFIELDS, req.jsonBody.c_str());
+    }
+    assert(req.method != "POST" || !req.jsonBody.empty());
+
+    GdriveMetaResponse output;
+    output.statusCode = gdriveHttpsRequest(req.serverRelPath, extraHeaders, extraOptions,
+    [&](std::span<const char> buf) { output.body.append(buf.data(), buf.size()); },
+    nullptr /*readRequest*/, nullptr /*receiveHeader*/, access).statusCode; //throw SysError
+    return output;
+}
+
+
+/*  coalesce metadata requests of concurrent threads ("group commit"):
+    - a thread without competition sends its request right away as a plain HTTP request => no extra latency
+    - up to GDRIVE_BATCHES_IN_FLIGHT_MAX requests (plain or batch) per account are in flight concurrently
+    - requests arriving while all of these are busy are collected and sent as a single batch by the next thread in line
+      => N parallel operations need ~N/100 round-trips instead of N
+    - the caller always gets the response of its own request => per-item error handling is unchanged       */
+class GdriveBatchQueue
+{
+public:
+    GdriveMetaResponse perform(const GdriveMetaRequest& req, const GdriveAccess& access) //throw SysError
+    {
+        PendingRequest item{&req, &access};
+
+        std::unique_lock dummy(lockQueue_);
+        pending_.push_back(&item);
+
+        //invariant: item is still in pending_ unless done or being sent by an active "leader"
+        while (!item.done)
+            if (size_t& batchesActive = activeBatches_[access.token];
+                batchesActive < GDRIVE_BATCHES_IN_FLIGHT_MAX) //=> item is still pending: become leader
+            {
+                ++batchesActive;
+
+                std::vector<PendingRequest*> batch{&item};
+                std::erase(pending_, &item);
+                std::erase_if(pending_, [&](PendingRequest* pr)
+                {
+                    if (batch.size() < GDRIVE_BATCH_SIZE_MAX && pr->access->token == access.token)
+                    {
+                        batch.push_back(pr);
+                        return true;
+                    }
+                    return false;
+                });
+                dummy.unlock();
+                {
+                    std::vector<GdriveMetaResponse> responses;
+                    std::optional<SysError> batchError;
+
+                    //whatever happens (e.g. std::bad_alloc): complete *all* requests of the batch, or their threads will wait forever
+                    auto guardBatch = makeGuard<ScopeGuardRunMode::onExit>([&]
+                    {
+                        std::lock_guard dummy2(lockQueue_);
+                        for (size_t i = 0; i < batch.size(); ++i)
+                        {
+                            if (responses.size() == batch.size())
+                                batch[i]->response = std::move(responses[i]);
+                            else
+                                batch[i]->error = batchError ? *batchError : SysError(formatSystemError("GdriveBatchQueue", L"", L"Request was aborted."));
+                            batch[i]->done = true;
+                        }
+                        if (--activeBatches_[access.token] == 0)
+                            activeBatches_.erase(access.token);
+                        conditionDone_.notify_all(); //waiting threads: 1. requests done 2. next leader
+                    });
+
+                    try
+                    {
+                        if (batch.size() == 1)
+                            responses.push_back(gdriveMetaRequestPlain(req, access)); //throw SysError
+                        else
+                        {
+                            std::vector<const GdriveMetaRequest*> requests;
+                            for (const PendingRequest* pr : batch)
+                                requests.push_back(pr->request);
+
+                            responses = gdriveBatchRequest(requests, access); //throw SysError
+                        }
+                    }
+                    catch (const SysError& e) { batchError = e; }
+                }
+                dummy.lock();
+            }
+            else
+                conditionDone_.wait(dummy); //HTTP requests are not interruptible either: timeout is bounded by GdriveAccess::timeoutSec
+
+        if (item.error)
+            throw *item.error;
+        return std::move(item.response);
+    }
+
+private:
+    struct PendingRequest
+    {
+        const GdriveMetaRequest* request = nullptr;
+        const GdriveAccess* access = nullptr;
+
+        bool done = false;
+        GdriveMetaResponse response;
+        std::optional<SysError> error;
+    };
+
+    std::mutex lockQueue_;
+    std::condition_variable conditionDone_;
+    std::vector<PendingRequest*> pending_;
+    std::unordered_map<std::string /*access token*/, size_t> activeBatches_; //requests (plain or batch) in flight per account
+};
+constinit Global<GdriveBatchQueue> globalGdriveBatchQueue;
+GLOBAL_RUN_ONCE(globalGdriveBatchQueue.set(std::make_unique<GdriveBatchQueue>()));
+
+
+GdriveMetaResponse gdriveMetaRequest(const GdriveMetaRequest& req, const GdriveAccess& access) //throw SysError
+{
+    const std::shared_ptr<GdriveBatchQueue> batchQueue = globalGdriveBatchQueue.get();
+    if (!batchQueue)
+        throw SysError(formatSystemError("gdriveMetaRequest", L"", L"Function call not allowed during init/shutdown."));
+
+    return batchQueue->perform(req, access); //throw SysError
+}
+
 //========================================================================================================
 
 struct GdriveUser
@@ -1009,10 +1176,7 @@ GdriveItemDetails getItemDetails(const std::string& itemId, const GdriveAccess&
         {"fields", "trashed,name,mimeType,ownedByMe,size,modifiedTime,parents,shortcutDetails(targetId)"},
         {"supportsAllDrives", "true"},
     });
-    std::string response;
-    gdriveHttpsRequest("/drive/v3/files/" + itemId + '?' + queryParams, {} /*extraHeaders*/, {} /*extraOptions*/,
-    [&](std::span<const char> buf) { response.append(buf.data(), buf.size()); },
-    nullptr /*readRequest*/, nullptr /*receiveHeader*/, access); //throw SysError
+    const std::string response = gdriveMetaRequest({"GET", "/drive/v3/files/" + itemId + '?' + queryParams, {}}, access).body; //throw SysError
     try
     {
         const JsonValue jvalue = parseJson(response); //throw JsonParsingError
@@ -1030,6 +1194,36 @@ GdriveItemDetails getItemDetails(const std::string& itemId, const GdriveAccess&
 }
 
 
+//returns raw bytes; not available for Google Docs, shortcuts, folders
+std::optional<std::string> getItemMd5(const std::string& itemId, const GdriveAccess& access) //throw SysError
+{
+    //https://developers.google.com/drive/api/v3/reference/files
+    const std::string& queryParams = xWwwFormUrlEncode(
+    {
+        {"fields", "md5Checksum"},
+        {"supportsAllDrives", "true"},
+    });
+    const std::string response = gdriveMetaRequest({"GET", "/drive/v3/files/" + itemId + '?' + queryParams, {}}, access).body; //throw SysError
+    try
+    {
+        const JsonValue jvalue = parseJson(response); //throw JsonParsingError
+
+        const std::optional<std::string> md5Hex = getPrimitiveFromJsonObject(jvalue, "md5Checksum");
+        if (!md5Hex)
+            return {};
+
+        if (md5Hex->size() != 32 || !std::all_of(md5Hex->begin(), md5Hex->end(), isHexDigit<char>))
+            throw SysError(formatGdriveErrorRaw(response));
+
+        std::string md5;
+        for (size_t i = 0; i < md5Hex->size(); i += 2)
+            md5 += unhexify((*md5Hex)[i], (*md5Hex)[i + 1]);
+        return md5;
+    }
+    catch (JsonParsingError&) { throw SysError(formatGdriveErrorRaw(response)); }
+}
+
+
 struct GdriveItem
 {
     std::string itemId;
@@ -1056,22 +1250,8 @@ std::vector<GdriveItem> readFolderContent(const std::string& folderId, const Gdr
             if (nextPageToken)
                 queryParams += '&' + xWwwFormUrlEncode({{"pageToken", *nextPageToken}});
 
-            std::string response;
-            gdriveHttpsRequest("/drive/v3/files?" + queryParams, {} /*extraHeaders*/, {} /*extraOptions*/,
-            [&](std::span<const char> buf) { response.append(buf.data(), buf.size()); },
-            nullptr /*readRequest*/, nullptr /*receiveHeader*/, access); //throw SysError
-
-            JsonValue jresponse;
-            try { jresponse = parseJson(response); }
-            catch (JsonParsingError&) {}
-
-            /**/                             nextPageToken    = getPrimitiveFromJsonObject(jresponse, "nextPageToken");
-            const std::optional<std::string> incompleteSearch = getPrimitiveFromJsonObject(jresponse, "incompleteSearch");
-            const JsonValue*                 files            = getChildFromJsonObject    (jresponse, "files");
-            if (!incompleteSearch || *incompleteSearch != "false" || !files || files->type != JsonValue::Type::array)
-                throw SysError(formatGdriveErrorRaw(response));
-
-            for (const JsonValue& childVal : files->arrayVal)
+            //up to 1000 items per page: create GdriveItems while the response arrives instead of parsing one huge JsonValue
+            JsonStreamParser parser("files", [&](JsonValue&& childVal) //throw SysError
             {
                 std::optional<std::string> itemId = getPrimitiveFromJsonObject(childVal, "id");
                 if (!itemId || itemId->empty())
@@ -1081,7 +1261,29 @@ std::vector<GdriveItem> readFolderContent(const std::string& folderId, const Gdr
                 assert(std::find(itemDetails.parentIds.begin(), itemDetails.parentIds.end(), folderId) != itemDetails.parentIds.end());
 
                 childItems.push_back({std::move(*itemId), std::move(itemDetails)});
+            });
+            std::string headBytes; //for error reporting only
+
+            JsonValue jresponse;
+            try
+            {
+                gdriveHttpsRequest("/drive/v3/files?" + queryParams, {} /*extraHeaders*/, {} /*extraOptions*/,
+                                   [&](std::span<const char> buf)
+                {
+                    if (headBytes.size() < 16 * 1024)
+                        headBytes.append(buf.data(), buf.size());
+                    parser.feed(buf); //throw JsonParsingError, SysError
+                }, nullptr /*readRequest*/, nullptr /*receiveHeader*/, access); //throw SysError, JsonParsingError
+
+                jresponse = parser.finish(); //throw JsonParsingError
             }
+            catch (JsonParsingError&) { throw SysError(formatGdriveErrorRaw(headBytes)); }
+
+            /**/                             nextPageToken    = getPrimitiveFromJsonObject(jresponse, "nextPageToken");
+            const std::optional<std::string> incompleteSearch = getPrimitiveFromJsonObject(jresponse, "incompleteSearch");
+            const JsonValue*                 files            = getChildFromJsonObject    (jresponse, "files");
+            if (!incompleteSearch || *incompleteSearch != "false" || !files || files->type != JsonValue::Type::array)
+                throw SysError(formatGdriveErrorRaw(serializeJson(jresponse)));
         }
         while (nextPageToken);
     }
@@ -1127,26 +1329,8 @@ ChangesDelta getChangesDelta(const std::string& sharedDriveId /*empty for "My Dr
         if (!sharedDriveId.empty())
             queryParams += '&' + xWwwFormUrlEncode({{"driveId", sharedDriveId}}); //only allowed for shared drives!
 
-        std::string response;
-        gdriveHttpsRequest("/drive/v3/changes?" + queryParams, {} /*extraHeaders*/, {} /*extraOptions*/,
-        [&](std::span<const char> buf) { response.append(buf.data(), buf.size()); },
-        nullptr /*readRequest*/, nullptr /*receiveHeader*/, access); //throw SysError
-
-        JsonValue jresponse;
-        try { jresponse = parseJson(response); }
-        catch (JsonParsingError&) {}
-
-        /**/                             nextPageToken     = getPrimitiveFromJsonObject(jresponse, "nextPageToken");
-        const std::optional<std::string> newStartPageToken = getPrimitiveFromJsonObject(jresponse, "newStartPageToken");
-        const std::optional<std::string> listKind          = getPrimitiveFromJsonObject(jresponse, "kind");
-        const JsonValue*                 changes           = getChildFromJsonObject    (jresponse, "changes");
-
-        if (!!nextPageToken == !!newStartPageToken || //there can be only one
-            !listKind || *listKind != "drive#changeList" ||
-            !changes || changes->type != JsonValue::Type::array)
-            throw SysError(formatGdriveErrorRaw(response));
-
-        for (const JsonValue& childVal : changes->arrayVal)
+        //changes feed after a long time offline can be huge: process changes while the response arrives instead of parsing one huge JsonValue
+        JsonStreamParser parser("changes", [&](JsonValue&& childVal) //throw SysError
         {
             const std::optional<std::string> kind       = getPrimitiveFromJsonObject(childVal, "kind");
             const std::optional<std::string> changeType = getPrimitiveFromJsonObject(childVal, "changeType");
@@ -1200,7 +1384,33 @@ ChangesDelta getChangesDelta(const std::string& sharedDriveId /*empty for "My Dr
                 delta.driveChanges.push_back(std::move(change));
             }
             else assert(false); //no other types (yet!)
+        });
+        std::string headBytes; //for error reporting only
+
+        JsonValue jresponse;
+        try
+        {
+            gdriveHttpsRequest("/drive/v3/changes?" + queryParams, {} /*extraHeaders*/, {} /*extraOptions*/,
+                               [&](std::span<const char> buf)
+            {
+                if (headBytes.size() < 16 * 1024)
+                    headBytes.append(buf.data(), buf.size());
+                parser.feed(buf); //throw JsonParsingError, SysError
+            }, nullptr /*readRequest*/, nullptr /*receiveHeader*/, access); //throw SysError, JsonParsingError
+
+            jresponse = parser.finish(); //throw JsonParsingError
         }
+        catch (JsonParsingError&) { throw SysError(formatGdriveErrorRaw(headBytes)); }
+
+        /**/                             nextPageToken     = getPrimitiveFromJsonObject(jresponse, "nextPageToken");
+        const std::optional<std::string> newStartPageToken = getPrimitiveFromJsonObject(jresponse, "newStartPageToken");
+        const std::optional<std::string> listKind          = getPrimitiveFromJsonObject(jresponse, "kind");
+        const JsonValue*                 changes           = getChildFromJsonObject    (jresponse, "changes");
+
+        if (!!nextPageToken == !!newStartPageToken || //there can be only one
+            !listKind || *listKind != "drive#changeList" ||
+            !changes || changes->type != JsonValue::Type::array)
+            throw SysError(formatGdriveErrorRaw(serializeJson(jresponse)));
 
         if (!nextPageToken)
         {
@@ -1247,15 +1457,12 @@ void gdriveDeleteItem(const std::string& itemId, const GdriveAccess& access) //t
     {
         {"supportsAllDrives", "true"},
     });
-    std::string response;
-    const HttpSession::Result httpResult = gdriveHttpsRequest("/drive/v3/files/" + itemId + '?' + queryParams,
-    {} /*extraHeaders*/, {{CURLOPT_CUSTOMREQUEST, "DELETE"}}, [&](std::span<const char> buf) { response.append(buf.data(), buf.size()); },
-    nullptr /*readRequest*/, nullptr /*receiveHeader*/, access); //throw SysError
+    const GdriveMetaResponse response = gdriveMetaRequest({"DELETE", "/drive/v3/files/" + itemId + '?' + queryParams, {}}, access); //throw SysError
 
-    if (response.empty() && httpResult.statusCode == 204)
+    if (response.body.empty() && response.statusCode == 204)
         return; //"If successful, this method returns an empty response body"
 
-    throw SysError(formatGdriveErrorRaw(response));
+    throw SysError(formatGdriveErrorRaw(response.body));
 }
 
 
@@ -1269,12 +1476,9 @@ void gdriveUnlinkParent(const std::string& itemId, const std::string& parentId,
         {"supportsAllDrives", "true"},
         {"fields", "id,parents"}, //for test if operation was successful
     });
-    std::string response;
-    const HttpSession::Result httpResult = gdriveHttpsRequest("/drive/v3/files/" + itemId + '?' + queryParams,
-    {"Content-Type: application/json; charset=UTF-8"}, {{CURLOPT_CUSTOMREQUEST, "PATCH"}, { CURLOPT_POSTFIELDS, "{}"}},
-    [&](std::span<const char> buf) { response.append(buf.data(), buf.size()); }, nullptr /*readRequest*/, nullptr /*receiveHeader*/, access); //throw SysError
+    const auto& [statusCode, response] = gdriveMetaRequest({"PATCH", "/drive/v3/files/" + itemId + '?' + queryParams, "{}"}, access); //throw SysError
 
-    if (response.empty() && httpResult.statusCode == 204)
+    if (response.empty() && statusCode == 204)
         return; //removing last parent of item not owned by us returns "204 No Content" (instead of 200 + file body)
 
     JsonValue jresponse;
@@ -1306,10 +1510,7 @@ void gdriveMoveToTrash(const std::string& itemId, const GdriveAccess& access) //
     });
     const std::string postBuf = R"({ "trashed": true })";
 
-    std::string response;
-    gdriveHttpsRequest("/drive/v3/files/" + itemId + '?' + queryParams,
-    {"Content-Type: application/json; charset=UTF-8"}, {{CURLOPT_CUSTOMREQUEST, "PATCH"}, {CURLOPT_POSTFIELDS, postBuf.c_str()}},
-    [&](std::span<const char> buf) { response.append(buf.data(), buf.size()); }, nullptr /*readRequest*/, nullptr /*receiveHeader*/, access); //throw SysError
+    const std::string response = gdriveMetaRequest({"PATCH", "/drive/v3/files/" + itemId + '?' + queryParams, postBuf}, access).body; //throw SysError
 
     JsonValue jresponse;
     try { jresponse = parseJson(response); /*throw JsonParsingError*/ }
@@ -1336,10 +1537,7 @@ std::string /*folderId*/ gdriveCreateFolderPlain(const Zstring& folderName, cons
     postParams.objectVal.set("parents", std::vector<JsonValue> {JsonValue(parentId)});
     const std::string& postBuf = serializeJson(postParams, "" /*lineBreak*/, "" /*indent*/);
 
-    std::string response;
-    gdriveHttpsRequest("/drive/v3/files?" + queryParams,
-    {"Content-Type: application/json; charset=UTF-8"}, {{CURLOPT_POSTFIELDS, postBuf.c_str()}},
-    [&](std::span<const char> buf) { response.append(buf.data(), buf.size()); }, nullptr /*readRequest*/, nullptr /*receiveHeader*/, access); //throw SysError
+    const std::string response = gdriveMetaRequest({"POST", "/drive/v3/files?" + queryParams, postBuf}, access).body; //throw SysError
 
     JsonValue jresponse;
     try { jresponse = parseJson(response); }
@@ -1373,10 +1571,7 @@ std::string /*shortcutId*/ gdriveCreateShortcutPlain(const Zstring& shortcutName
     postParams.objectVal.set("shortcutDetails", std::move(shortcutDetails));
     const std::string& postBuf = serializeJson(postParams, "" /*lineBreak*/, "" /*indent*/);
 
-    std::string response;
-    gdriveHttpsRequest("/drive/v3/files?" + queryParams, {"Content-Type: application/json; charset=UTF-8"},
-    {{CURLOPT_POSTFIELDS, postBuf.c_str()}}, [&](std::span<const char> buf) { response.append(buf.data(), buf.size()); },
-    nullptr /*readRequest*/, nullptr /*receiveHeader*/, access); //throw SysError
+    const std::string response = gdriveMetaRequest({"POST", "/drive/v3/files?" + queryParams, postBuf}, access).body; //throw SysError
 
     JsonValue jresponse;
     try { jresponse = parseJson(response); }
@@ -1462,11 +1657,7 @@ void gdriveMoveAndRenameItem(const std::string& itemId, const std::string& paren
     postParams.objectVal.set("modifiedTime", modTimeRfc);
     const std::string& postBuf = serializeJson(postParams, "" /*lineBreak*/, "" /*indent*/);
 
-    std::string response;
-    gdriveHttpsRequest("/drive/v3/files/" + itemId + '?' + queryParams,
-    {"Content-Type: application/json; charset=UTF-8"}, {{CURLOPT_CUSTOMREQUEST, "PATCH"}, {CURLOPT_POSTFIELDS, postBuf.c_str()}},
-    [&](std::span<const char> buf) { response.append(buf.data(), buf.size()); },
-    nullptr /*readRequest*/, nullptr /*receiveHeader*/, access); //throw SysError
+    const std::string response = gdriveMetaRequest({"PATCH", "/drive/v3/files/" + itemId + '?' + queryParams, postBuf}, access).body; //throw SysError
 
     JsonValue jresponse;
     try { jresponse = parseJson(response); /*throw JsonParsingError*/ }
@@ -3643,6 +3834,20 @@ private:
         }
     }
 
+    std::optional<std::string> tryGetFileMd5Fast(const AfsPath& filePath) const override //throw FileError
+    {
+        try
+        {
+            std::string itemId;
+            const GdrivePersistentSessions::AsyncAccessInfo aai = accessGlobalFileState(gdriveLogin_, [&](GdriveFileStateAtLocation& fileState) //throw SysError
+            {
+                itemId = fileState.getFileAttributes(filePath, true /*followLeafShortcut*/).first; //throw SysError
+            });
+            return getItemMd5(itemId, aai.access); //throw SysError
+        }
+        catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(getDisplayPath(filePath))), e.toString()); }
+    }
+
     //----------------------------------------------------------------------------------------------------------------
     void traverseFolderRecursive(const TraverserWorkload& workload /*throw X*/, size_t parallelOps) const override
     {
@@ -3654,7 +3859,8 @@ private:
     //already existing: undefined behavior! (e.g. fail/overwrite/auto-rename)
     //=> actual behavior: 1. fails or 2. creates duplicate (unlikely)
     FileCopyResult copyFileForSameAfsType(const AfsPath& sourcePath, const StreamAttributes& sourceAttr, //throw FileError, (ErrorFileLocked), (X)
-                                          const AbstractPath& targetPath, bool copyFilePermissions, const IoCallback& notifyUnbufferedIO /*throw X*/) const override
+                                          const AbstractPath& targetPath, bool copyFilePermissions, const IoCallback& notifyUnbufferedIO /*throw X*/,
+                                          const IoDataCallback& notifySourceData /*throw X*/) const override
     {
         //no native Google Drive file copy => use stream-based file copy:
         if (copyFilePermissions)
@@ -3665,7 +3871,7 @@ private:
         if (!equalAsciiNoCase(gdriveLogin_.email, fsTarget.gdriveLogin_.email))
             //already existing: undefined behavior! (e.g. fail/overwrite/auto-rename)
             //=> actual behavior: 1. fails or 2. creates duplicate (unlikely)
-            return copyFileAsStream(sourcePath, sourceAttr, targetPath, notifyUnbufferedIO); //throw FileError, (ErrorFileLocked), X
+            return copyFileAsStream(sourcePath, sourceAttr, targetPath, notifyUnbufferedIO, notifySourceData); //throw FileError, (ErrorFileLocked), X
         //else: copying files within account works, e.g. between My Drive <-> shared drives
 
         try
@@ -3893,6 +4099,10 @@ private:
     }
 
     bool hasNativeTransactionalCopy() const override { return true; }
+
+    //metadata calls of parallel threads are coalesced into batch requests (see GdriveBatchQueue) => more threads mostly share round-trips
+    //still, each call counts against Google's rate limits
+    size_t getDefaultParallelOps() const override { return 8; }
     //----------------------------------------------------------------------------------------------------------------
 
     int64_t getFreeDiskSpace(const AfsPath& folderPath) const override //throw FileError, returns < 0 if not available
@@ -0,0 +1,143 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#ifndef GDRIVE_BATCH_H_4817305926481730592
+#define GDRIVE_BATCH_H_4817305926481730592
+
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <zen/string_tools.h>
+#include <zen/sys_error.h>
+
+
+namespace fff
+{
+//batch requests: https://developers.google.com/drive/api/guides/performance#batch-requests
+//multipart/mixed codec only, no networking => can be exercised without a server
+constexpr size_t GDRIVE_BATCH_SIZE_MAX = 100;
+const char GDRIVE_BATCH_PATH[] = "/batch/drive/v3";
+
+struct GdriveMetaRequest
+{
+    std::string method; //"GET", "POST", "PATCH", "DELETE"
+    std::string serverRelPath;
+    std::string jsonBody; //optional
+};
+
+struct GdriveMetaResponse
+{
+    int statusCode = 0;
+    std::string body;
+};
+
+
+inline
+std::string formatGdriveBatchRequest(const std::vector<const GdriveMetaRequest*>& requests, const std::string& boundary)
+{
+    using namespace zen;
+
+    std::string output;
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        const GdriveMetaRequest& req = *requests[i];
+        output += "--" + boundary + "\r\n"
+                  "Content-Type: application/http\r\n"
+                  "Content-ID: <item" + numberTo<std::string>(i) + ">\r\n"
+                  "\r\n" +
+                  req.method + ' ' + req.serverRelPath + " HTTP/1.1\r\n";
+        if (!req.jsonBody.empty())
+            output += "Content-Type: application/json; charset=UTF-8\r\n"
+                      "Content-Length: " + numberTo<std::string>(req.jsonBody.size()) + "\r\n";
+        output += "\r\n" + req.jsonBody + "\r\n";
+    }
+    output += "--" + boundary + "--\r\n";
+    return output;
+}
+
+
+namespace impl
+{
+//split MIME part or HTTP message into header and body
+inline
+std::pair<std::string_view, std::string_view> splitHeaderBody(std::string_view msg)
+{
+    if (const size_t pos = msg.find("\r\n\r\n"); pos != std::string_view::npos)
+        return {msg.substr(0, pos), msg.substr(pos + 4)};
+    if (const size_t pos = msg.find("\n\n"); pos != std::string_view::npos) //be lenient
+        return {msg.substr(0, pos), msg.substr(pos + 2)};
+    return {msg, {}};
+}
+}
+
+
+//partial failure: not an error => see GdriveMetaResponse::statusCode of each item
+inline
+std::vector<GdriveMetaResponse> parseGdriveBatchResponse(const std::string& response, const std::string& boundary, size_t requestCount) //throw SysError
+{
+    /*  --batch_XYZ
+        Content-Type: application/http
+        Content-ID: <response-item0>
+
+        HTTP/1.1 200 OK
+        Content-Type: application/json; charset=UTF-8
+
+        { "id": "..." }
+        --batch_XYZ--                                */
+    using namespace zen;
+
+    std::vector<GdriveMetaResponse> output(requestCount);
+    std::vector<bool> responseFound(requestCount);
+
+    const std::string delimiter = "--" + boundary;
+    std::string_view rest = response;
+    if (const size_t pos = rest.find(delimiter); pos != std::string_view::npos)
+        rest = rest.substr(pos + delimiter.size()); //skip preamble
+    else
+        throw SysError(L"Google Drive batch response is malformed.");
+
+    while (!startsWith(rest, "--")) //close-delimiter
+    {
+        const size_t posNext = rest.find(delimiter);
+        if (posNext == std::string_view::npos)
+            throw SysError(L"Google Drive batch response is malformed.");
+
+        const std::string_view part = rest.substr(0, posNext);
+        rest = rest.substr(posNext + delimiter.size());
+
+        const auto [mimeHeader, httpMsg] = impl::splitHeaderBody(trimCpy(part, TrimSide::left));
+        const auto [httpHeader, httpBody] = impl::splitHeaderBody(httpMsg);
+
+        //Content-ID: <response-item3>
+        std::optional<size_t> itemIdx;
+        split2(mimeHeader, [](char c) { return c == '\r' || c == '\n'; }, [&](std::string_view line)
+        {
+            if (startsWithAsciiNoCase(line, "Content-ID:"))
+                if (const std::string_view idStr = afterFirst(line, "<response-item", IfNotFoundReturn::none);
+                    !idStr.empty())
+                    itemIdx = stringTo<size_t>(beforeFirst(idStr, '>', IfNotFoundReturn::none));
+        });
+        if (!itemIdx || *itemIdx >= requestCount || responseFound[*itemIdx])
+            throw SysError(L"Google Drive batch response is malformed.");
+
+        //HTTP/1.1 204 No Content
+        const std::string_view statusLine = beforeFirst(httpHeader, '\n', IfNotFoundReturn::all);
+        const int statusCode = stringTo<int>(beforeFirst(afterFirst(statusLine, ' ', IfNotFoundReturn::none), ' ', IfNotFoundReturn::all));
+        if (!startsWith(statusLine, "HTTP/") || statusCode == 0)
+            throw SysError(L"Google Drive batch response is malformed.");
+
+        output[*itemIdx] = {statusCode, trimCpy(std::string(httpBody))};
+        responseFound[*itemIdx] = true;
+    }
+
+    if (std::find(responseFound.begin(), responseFound.end(), false) != responseFound.end())
+        throw SysError(L"Google Drive batch response is incomplete.");
+
+    return output;
+}
+}
+
+#endif //GDRIVE_BATCH_H_4817305926481730592
@@ -6,6 +6,7 @@
 
 #include "sftp.h"
 #include <array>
+#include <deque>
 #include <zen/sys_error.h>
 #include <zen/thread.h>
 #include <zen/globals.h>
@@ -599,15 +600,35 @@ public:
         else assert(false);
     }
 
-    static void addSftpChannel(const std::vector<SshSession*>& sshSessions, int timeoutSec) //throw SysError
+    //single step of addSftpChannel(): return "false" if pending
+    bool tryAddSftpChannel(std::chrono::steady_clock::time_point commandStartTime, int timeoutSec) //throw SysError
     {
-        auto addChannelDetails = [](const std::wstring& msg, SshSession& sshSession) //when hitting the server's SFTP channel limit, inform user about channel number
+        try
         {
-            if (sshSession.sftpChannels_.empty())
-                return msg;
-            return msg + L' ' + replaceCpy(_("Failed to open SFTP channel number %x."), L"%x", formatNumber(sshSession.sftpChannels_.size() + 1));
-        };
+            return tryNonBlocking(static_cast<size_t>(-1), commandStartTime, "libssh2_sftp_init",
+                                  [&](const SshSession::Details& sd) //noexcept!
+            {
+                LIBSSH2_SFTP* sftpChannelNew = ::libssh2_sftp_init(sd.sshSession);
+                if (!sftpChannelNew)
+                    return std::min(::libssh2_session_last_errno(sd.sshSession), LIBSSH2_ERROR_SOCKET_NONE);
+                //just in case libssh2 failed to properly set last error; e.g. https://github.com/libssh2/libssh2/pull/123
 
+                sftpChannels_.emplace_back(sftpChannelNew);
+                return LIBSSH2_ERROR_NONE;
+            }, timeoutSec); //throw SysError, (SysErrorSftpProtocol)
+        }
+        catch (const SysError& e) //when hitting the server's SFTP channel limit, inform user about channel number
+        {
+            //SysErrorSftpProtocol? unexpected during libssh2_sftp_init()
+            //-> still occuring for whatever reason!? => "slice" down to SysError
+            if (sftpChannels_.empty())
+                throw SysError(e.toString());
+            throw SysError(e.toString() + L' ' + replaceCpy(_("Failed to open SFTP channel number %x."), L"%x", formatNumber(sftpChannels_.size() + 1)));
+        }
+    }
+
+    static void addSftpChannel(const std::vector<SshSession*>& sshSessions, int timeoutSec) //throw SysError
+    {
         std::optional<SysError> firstSysError;
 
         std::vector<SshSession*> pendingSessions = sshSessions;
@@ -620,25 +641,13 @@ public:
             for (size_t pos = pendingSessions.size(); pos-- > 0 ; ) //CAREFUL WITH THESE ERASEs (invalidate positions!!!)
                 try
                 {
-                    if (pendingSessions[pos]->tryNonBlocking(static_cast<size_t>(-1), sftpCommandStartTime, "libssh2_sftp_init",
-                                                             [&](const SshSession::Details& sd) //noexcept!
-                {
-                    LIBSSH2_SFTP* sftpChannelNew = ::libssh2_sftp_init(sd.sshSession);
-                        if (!sftpChannelNew)
-                            return std::min(::libssh2_session_last_errno(sd.sshSession), LIBSSH2_ERROR_SOCKET_NONE);
-                        //just in case libssh2 failed to properly set last error; e.g. https://github.com/libssh2/libssh2/pull/123
-
-                        pendingSessions[pos]->sftpChannels_.emplace_back(sftpChannelNew);
-                        return LIBSSH2_ERROR_NONE;
-                    }, timeoutSec)) //throw SysError, (SysErrorSftpProtocol)
-                    pendingSessions.erase(pendingSessions.begin() + pos); //= not pending
+                    if (pendingSessions[pos]->tryAddSftpChannel(sftpCommandStartTime, timeoutSec)) //throw SysError
+                        pendingSessions.erase(pendingSessions.begin() + pos); //= not pending
                 }
                 catch (const SysError& e)
                 {
                     if (!firstSysError) //don't throw yet and corrupt other valid, but pending SshSessions! We also don't want to leak LIBSSH2_SFTP* waiting in libssh2 code
-                        firstSysError = SysError(addChannelDetails(e.toString(), *pendingSessions[pos]));
-                    //SysErrorSftpProtocol? unexpected during libssh2_sftp_init()
-                    //-> still occuring for whatever reason!? => "slice" down to SysError
+                        firstSysError = e;
                     pendingSessions.erase(pendingSessions.begin() + pos);
                 }
 
@@ -744,38 +753,157 @@ public:
         void operator()(SshSession* s) const;
     };
 
-    class SshSessionShared
+    /* SSH connection with SFTP channels used by multiple threads at a time: many servers limit connections per user, but not channels
+       => each thread gets its own channel; libssh2 is not thread-safe => serialize all libssh2 calls, but keep commands of all channels in flight
+
+       waiting for traffic: one thread polls the socket, the others wait for the "traffic generation" to change
+       - while a thread polls, no other thread may call libssh2: could read the packets the poller is waiting for => lost wake-up
+       - poll only after all waiting threads had a chance to pick up the latest traffic (retriesDue_ == 0)                           */
+    class SshSessionMultiplexed
     {
     public:
-        SshSessionShared(std::unique_ptr<SshSession, ReUseOnDelete>&& idleSession, int timeoutSec) :
-            session_(std::move(idleSession)) /*bound!*/, timeoutSec_(timeoutSec) { /*assert(session_->isHealthy());*/ }
+        SshSessionMultiplexed(std::unique_ptr<SshSession, ReUseOnDelete>&& idleSession, size_t channelsMax, int timeoutSec) :
+            session_(std::move(idleSession)) /*bound!*/, channelsUsed_(std::max<size_t>(channelsMax, 1)), timeoutSec_(timeoutSec) {}
 
-        //we need two-step initialization: 1. constructor is FAST and noexcept 2. init() is SLOW and throws
-        void initSftpChannel() //throw SysError
+        std::optional<size_t> tryReserveChannel() //thread-safe
         {
-            if (session_->getSftpChannelCount() == 0) //make sure the SSH session contains at least one SFTP channel
-                SshSession::addSftpChannel({session_.get()}, timeoutSec_); //throw SysError
+            std::lock_guard dummy(lockSession_);
+            if (!sessionFailed_)
+                for (size_t channelNo = 0; channelNo < channelsUsed_.size(); ++channelNo)
+                    if (!channelsUsed_[channelNo])
+                    {
+                        channelsUsed_[channelNo] = true;
+                        return channelNo;
+                    }
+            return std::nullopt;
         }
 
-        void executeBlocking(const char* functionName, const std::function<int(const SshSession::Details& sd)>& sftpCommand /*noexcept!*/) //throw SysError, SysErrorSftpProtocol
+        void releaseChannel(size_t channelNo) //thread-safe
+        {
+            std::lock_guard dummy(lockSession_);
+            assert(channelsUsed_[channelNo]);
+            channelsUsed_[channelNo] = false;
+        }
+
+        void initSftpChannel(size_t channelNo) //throw SysError
+        {
+            std::lock_guard dummy(lockChannelInit_); //libssh2_sftp_init() uses the SSH session's non-blocking state => one at a time
+
+            for (;;)
+            {
+                {
+                    std::lock_guard dummy2(lockSession_);
+                    if (session_->getSftpChannelCount() > channelNo)
+                        return;
+                }
+                const auto sftpCommandStartTime = std::chrono::steady_clock::now();
+
+                runBlocking([&] { return session_->tryAddSftpChannel(sftpCommandStartTime, timeoutSec_); }); //throw SysError
+            }
+        }
+
+        void executeBlocking(size_t channelNo, const char* functionName, const std::function<int(const SshSession::Details& sd)>& sftpCommand /*noexcept!*/) //throw SysError, SysErrorSftpProtocol
         {
-            assert(threadId_ == std::this_thread::get_id());
-            assert(session_->getSftpChannelCount() > 0);
             const auto sftpCommandStartTime = std::chrono::steady_clock::now();
 
+            runBlocking([&] { return session_->tryNonBlocking(channelNo, sftpCommandStartTime, functionName, sftpCommand, timeoutSec_); }); //throw SysError, SysErrorSftpProtocol
+        }
+
+        const SshSessionCfg& getSessionCfg() const { return session_->getSessionCfg(); } //thread-safe
+
+    private:
+        SshSessionMultiplexed           (const SshSessionMultiplexed&) = delete;
+        SshSessionMultiplexed& operator=(const SshSessionMultiplexed&) = delete;
+
+        void runBlocking(const std::function<bool()>& tryNonBlocking /*throw SysError, SysErrorSftpProtocol*/) //throw SysError, SysErrorSftpProtocol
+        {
+            std::unique_lock dummy(lockSession_);
+            trafficArrived_.wait(dummy, [&] { return !pollerActive_; });
+
+            ZEN_ON_SCOPE_EXIT(if (waiters_ > 0) notifyTraffic()); //we might have read the packets other threads are waiting for!
+
             for (;;)
-                if (session_->tryNonBlocking(0 /*channelNo*/, sftpCommandStartTime, functionName, sftpCommand, timeoutSec_)) //throw SysError, SysErrorSftpProtocol
-                    return;
-                else //pending
+            {
+                try
+                {
+                    if (tryNonBlocking()) //throw SysError, SysErrorSftpProtocol
+                        return;
+                }
+                catch (const SysErrorSftpProtocol&) { throw; } //SSH session is just fine
+                catch (const SysError&) { sessionFailed_ = true; throw; } //don't hand out further channels
+
+                if (retriesDue_ == 0) //=> become the poller
+                {
+                    pollerActive_ = true;
+                    dummy.unlock();
+
+                    bool pollFailed = true;
+                    ZEN_ON_SCOPE_EXIT(dummy.lock(); pollerActive_ = false; if (pollFailed) sessionFailed_ = true; notifyTraffic());
+
                     SshSession::waitForTraffic({session_.get()}, timeoutSec_); //throw SysError
+                    pollFailed = false;
+                }
+                else
+                {
+                    const size_t trafficGen = trafficGen_;
+                    ++waiters_;
+                    trafficArrived_.wait(dummy, [&] { return trafficGen_ != trafficGen; });
+                    assert(waiters_ > 0 && retriesDue_ > 0);
+                    --waiters_;
+                    --retriesDue_;
+                }
+            }
+        }
+
+        void notifyTraffic() //context: lockSession_ held
+        {
+            ++trafficGen_;
+            retriesDue_ = waiters_;
+            trafficArrived_.notify_all();
+        }
+
+        const std::unique_ptr<SshSession, ReUseOnDelete> session_; //bound!
+
+        std::mutex lockChannelInit_;
+
+        std::mutex lockSession_; //protect ALL accesses to session_ (except for the poller) and the members below
+        std::condition_variable trafficArrived_;
+        bool pollerActive_ = false;
+        size_t trafficGen_ = 0;
+        size_t waiters_    = 0; //threads waiting for trafficGen_ to change
+        size_t retriesDue_ = 0; //waiters that have not retried since trafficGen_ last changed
+        std::vector<bool> channelsUsed_;
+        bool sessionFailed_ = false;
+
+        const int timeoutSec_;
+    };
+
+    class SshSessionShared //bound to a single thread
+    {
+    public:
+        SshSessionShared(const std::shared_ptr<SshSessionMultiplexed>& session, size_t channelNo) :
+            session_(session), channelNo_(channelNo) {}
+
+        ~SshSessionShared() { session_->releaseChannel(channelNo_); }
+
+        //we need two-step initialization: 1. constructor is FAST and noexcept 2. init() is SLOW and throws
+        void initSftpChannel() { session_->initSftpChannel(channelNo_); } //throw SysError
+
+        void executeBlocking(const char* functionName, const std::function<int(const SshSession::Details& sd)>& sftpCommand /*noexcept!*/) //throw SysError, SysErrorSftpProtocol
+        {
+            assert(threadId_ == std::this_thread::get_id());
+            session_->executeBlocking(channelNo_, functionName, sftpCommand); //throw SysError, SysErrorSftpProtocol
         }
 
         const SshSessionCfg& getSessionCfg() const { return session_->getSessionCfg(); } //thread-safe
 
     private:
-        std::unique_ptr<SshSession, ReUseOnDelete> session_; //bound!
+        SshSessionShared           (const SshSessionShared&) = delete;
+        SshSessionShared& operator=(const SshSessionShared&) = delete;
+
+        const std::shared_ptr<SshSessionMultiplexed> session_;
+        const size_t channelNo_;
         const std::thread::id threadId_ = std::this_thread::get_id();
-        const int timeoutSec_;
     };
 
     class SshSessionExclusive
@@ -837,43 +965,69 @@ public:
         Protected<SshSessionCache>& sessionCache = getSessionCache(login);
 
         const std::thread::id threadId = std::this_thread::get_id();
-        std::shared_ptr<SshSessionShared> sharedSession; //either or
-        std::optional<SshSessionCfg> sessionCfg;         //
+        std::shared_ptr<SshSessionShared> sharedSession;                    //either or
+        std::vector<std::shared_ptr<SshSessionMultiplexed>> muxSessions;    //
+        std::unique_ptr<SshSession, ReUseOnDelete> idleSession;             //
+        std::optional<SshSessionCfg> sessionCfg;                            //
 
         sessionCache.access([&](SshSessionCache& cache)
         {
             if (!cache.activeCfg) //AFS::authenticateAccess() not called => authenticate implicitly!
                 setActiveConfig(cache, login);
 
-            std::weak_ptr<SshSessionShared>& sharedSessionWeak = cache.sshSessionsWithThreadAffinity[threadId]; //get or create
-            if (auto session = sharedSessionWeak.lock())
+            if (auto session = cache.sshSessionsWithThreadAffinity[threadId].lock()) //get or create
                 //dereference session ONLY after affinity to THIS thread was confirmed!!!
                 //assume "isHealthy()" to avoid hitting server connection limits: (clean up of !isHealthy() after use; idle sessions via worker thread)
                 sharedSession = session;
+            else
+            {
+                //don't try to reserve a channel while holding the lock: releasing the last reference would call ReUseOnDelete => deadlock!
+                for (const std::weak_ptr<SshSessionMultiplexed>& muxSessionWeak : cache.multiplexedSessions)
+                    if (auto muxSession = muxSessionWeak.lock())
+                        muxSessions.push_back(muxSession);
 
-            if (!sharedSession)
                 //assume "isHealthy()" to avoid hitting server connection limits: (clean up of !isHealthy() after use; idle sessions via worker thread)
                 if (!cache.idleSshSessions.empty())
                 {
-                    std::unique_ptr<SshSession, ReUseOnDelete> sshSession(cache.idleSshSessions.back().release());
-                    /**/                                                  cache.idleSshSessions.pop_back();
-                    sharedSessionWeak = sharedSession = std::make_shared<SshSessionShared>(std::move(sshSession), login.timeoutSec); //still holding lock => constructor must be *fast*!
+                    idleSession.reset(cache.idleSshSessions.back().release());
+                    /**/              cache.idleSshSessions.pop_back();
                 }
-            if (!sharedSession)
                 sessionCfg = *cache.activeCfg;
+            }
         });
 
         startGlobalSessionCleanUp();
 
-        //create new SFTP session outside the lock: 1. don't block other threads 2. non-atomic regarding "sessionCache"! => one session too many is not a problem!
         if (!sharedSession)
         {
-            sharedSession = std::make_shared<SshSessionShared>(std::unique_ptr<SshSession, ReUseOnDelete>(new SshSession(*sessionCfg, login.timeoutSec)), login.timeoutSec); //throw SysError, SysErrorPassword
+            //prefer free SFTP channel of an existing SSH connection
+            for (const std::shared_ptr<SshSessionMultiplexed>& muxSession : muxSessions)
+                if (const std::optional<size_t> channelNo = muxSession->tryReserveChannel())
+                {
+                    sharedSession = std::make_shared<SshSessionShared>(muxSession, *channelNo);
+                    break;
+                }
+
+            std::shared_ptr<SshSessionMultiplexed> muxSessionNew;
+            if (!sharedSession)
+            {
+                //create new SFTP session outside the lock: 1. don't block other threads 2. non-atomic regarding "sessionCache"! => one session too many is not a problem!
+                if (!idleSession)
+                    idleSession.reset(new SshSession(*sessionCfg, login.timeoutSec)); //throw SysError, SysErrorPassword
+
+                muxSessionNew = std::make_shared<SshSessionMultiplexed>(std::move(idleSession), login.traverserChannelsPerConnection, login.timeoutSec);
+                sharedSession = std::make_shared<SshSessionShared>(muxSessionNew, *muxSessionNew->tryReserveChannel());
+            }
+            //else: unused idleSession is returned via ReUseOnDelete *outside* the lock
 
             sessionCache.access([&](SshSessionCache& cache)
             {
                 if (sharedSession->getSessionCfg() == *cache.activeCfg) //created outside the lock => check *again*
+                {
                     cache.sshSessionsWithThreadAffinity[threadId] = sharedSession;
+                    if (muxSessionNew)
+                        cache.multiplexedSessions.push_back(muxSessionNew);
+                }
             });
         }
 
@@ -883,6 +1037,68 @@ public:
         return sharedSession;
     }
 
+    //SSH connection of its own: *not* offered to other threads for multiplexing (unlike getSharedSession())
+    std::shared_ptr<SshSessionShared> getDedicatedSession(const SftpLogin& login) //throw SysError, SysErrorPassword
+    {
+        std::unique_ptr<SshSession, ReUseOnDelete> idleSession; //either or
+        std::optional<SshSessionCfg> sessionCfg;                //
+
+        getSessionCache(login).access([&](SshSessionCache& cache)
+        {
+            if (!cache.activeCfg) //AFS::authenticateAccess() not called => authenticate implicitly!
+                setActiveConfig(cache, login);
+
+            //assume "isHealthy()" to avoid hitting server connection limits: (clean up of !isHealthy() after use, idle sessions via worker thread)
+            if (!cache.idleSshSessions.empty())
+            {
+                idleSession.reset(cache.idleSshSessions.back().release());
+                /**/              cache.idleSshSessions.pop_back();
+            }
+            else
+                sessionCfg = *cache.activeCfg;
+        });
+
+        startGlobalSessionCleanUp();
+
+        //create new SFTP session outside the lock: 1. don't block other threads 2. non-atomic regarding "sessionCache"! => one session too many is not a problem!
+        if (!idleSession)
+            idleSession.reset(new SshSession(*sessionCfg, login.timeoutSec)); //throw SysError, SysErrorPassword
+
+        //not added to SshSessionCache::multiplexedSessions; connection is returned to idleSshSessions via ReUseOnDelete
+        auto muxSession = std::make_shared<SshSessionMultiplexed>(std::move(idleSession), 1 /*channelsMax*/, login.timeoutSec);
+        auto dedicatedSession = std::make_shared<SshSessionShared>(muxSession, *muxSession->tryReserveChannel());
+
+        dedicatedSession->initSftpChannel(); //throw SysError
+        return dedicatedSession;
+    }
+
+    //extra SSH connections for segmented transfer: bounded per device and shared by all file streams, see setSftpSegmentSessionsMax()
+    void setSegmentSessionsMax(const SftpLogin& login, size_t sessionsMax)
+    {
+        getSessionCache(login).access([&](SshSessionCache& cache) { cache.segmentSessionsMax = sessionsMax; });
+    }
+
+    size_t reserveSegmentSessions(const SftpLogin& login, size_t sessionsWanted) //returns number of sessions granted
+    {
+        size_t sessionCount = 0;
+        getSessionCache(login).access([&](SshSessionCache& cache)
+        {
+            if (cache.segmentSessionsActive < cache.segmentSessionsMax)
+                sessionCount = std::min(sessionsWanted, cache.segmentSessionsMax - cache.segmentSessionsActive);
+            cache.segmentSessionsActive += sessionCount;
+        });
+        return sessionCount;
+    }
+
+    void releaseSegmentSessions(const SftpLogin& login, size_t sessionCount)
+    {
+        getSessionCache(login).access([&](SshSessionCache& cache)
+        {
+            assert(cache.segmentSessionsActive >= sessionCount);
+            cache.segmentSessionsActive -= std::min(sessionCount, cache.segmentSessionsActive);
+        });
+    }
+
     std::unique_ptr<SshSessionExclusive> getExclusiveSession(const SftpLogin& login) //throw SysError
     {
         std::unique_ptr<SshSession, ReUseOnDelete> sshSession; //either or
@@ -994,6 +1210,7 @@ private:
         {
             cache.idleSshSessions              .clear(); //run ~SshSession *inside* the lock! => avoid hitting server limits!
             cache.sshSessionsWithThreadAffinity.clear(); //
+            cache.multiplexedSessions          .clear(); //
             //=> incompatible sessions will be deleted by ReUseOnDelete(); until then: additionally counts towards SFTP connection limit :(
         }
     }
@@ -1039,6 +1256,7 @@ private:
                                         return; //don't hold lock for too long: delete only one session at a time, then yield...
                                     }
                                 std::erase_if(cache.sshSessionsWithThreadAffinity, [](const auto& v) { return v.second.expired(); }); //clean up dangling weak pointer
+                                std::erase_if(cache.multiplexedSessions, [](const auto& v) { return v.expired(); });                  //
                                 done = true;
                             });
                             if (done)
@@ -1055,11 +1273,15 @@ private:
         //invariant: all cached sessions correspond to activeCfg at any time!
         std::vector<std::unique_ptr<SshSession>>                             idleSshSessions; //extract *temporarily* from this list during use
         std::unordered_map<std::thread::id, std::weak_ptr<SshSessionShared>> sshSessionsWithThreadAffinity; //Win32 thread IDs may be REUSED! still, shouldn't be a problem...
+        std::vector<std::weak_ptr<SshSessionMultiplexed>>                    multiplexedSessions; //SSH connections with SFTP channels to spare for other threads
 
         std::optional<SshSessionCfg> activeCfg;
 
         Zstring sessionPassword;   //user/password
         Zstring sessionPassphrase; //keyfile/passphrase
+
+        size_t segmentSessionsMax    = 0; //0: no segmented transfer
+        size_t segmentSessionsActive = 0; //reserved by file streams, see SegmentSessionReservation
     };
 
     using GlobalSshSessions = std::map<SshDeviceId, Protected<SshSessionCache>>;
@@ -1099,6 +1321,15 @@ std::shared_ptr<SftpSessionManager::SshSessionShared> getSharedSftpSession(const
 }
 
 
+std::shared_ptr<SftpSessionManager::SshSessionShared> getDedicatedSftpSession(const SftpLogin& login) //throw SysError
+{
+    if (const std::shared_ptr<SftpSessionManager> mgr = globalSftpSessionManager.get())
+        return mgr->getDedicatedSession(login); //throw SysError, SysErrorPassword
+
+    throw SysError(formatSystemError("getDedicatedSftpSession", L"", L"Function call not allowed during init/shutdown."));
+}
+
+
 std::unique_ptr<SftpSessionManager::SshSessionExclusive> getExclusiveSftpSession(const SftpLogin& login) //throw SysError
 {
     if (const std::shared_ptr<SftpSessionManager> mgr = globalSftpSessionManager.get())
@@ -1314,46 +1545,492 @@ void traverseFolderRecursiveSftp(const SftpLogin& login, const std::vector<std::
 
 //===========================================================================================================================
 
-struct InputStreamSftp : public AFS::InputStream
+/* Segmented transfer: a single SFTP handle is capped by one channel's window => for large files and high-latency links, move the data
+   through several handles at different offsets, each on a separate SSH connection (see getDedicatedSftpSession())
+   => multiplexed channels (getSharedSftpSession()) share one connection's window and would gain nothing!
+
+   - "tmp file + rename" is unaffected: segmented writes go into the (transactional) target file created by OutputStreamSftp
+   - progress is reported for data actually read/written, not for data merely queued
+   - extra connections are limited per device and shared by all file streams: none by default, see setSftpSegmentSessionsMax()
+   - no extra connection available at all (e.g. server connection limit)? => continue via the stream's own handle          */
+const uint64_t SFTP_SEGMENTED_TRANSFER_MIN = 64 * 1024 * 1024; //don't bother with additional sessions for small files: setup is more expensive than the gain
+const size_t   SFTP_SEGMENT_SIZE           = 16 * SFTP_OPTIMAL_BLOCK_SIZE_READ;
+static_assert(SFTP_SEGMENT_SIZE % SFTP_OPTIMAL_BLOCK_SIZE_WRITE == 0);
+
+
+class SegmentSessionReservation
 {
-    InputStreamSftp(const SftpLogin& login, const AfsPath& filePath) : //throw FileError
-        displayPath_(getSftpDisplayPath(login, filePath))
+public:
+    SegmentSessionReservation(const SftpLogin& login, uint64_t segmentCount) : login_(login)
     {
+        if (const std::shared_ptr<SftpSessionManager> mgr = globalSftpSessionManager.get())
+            sessionCount_ = mgr->reserveSegmentSessions(login, static_cast<size_t>(std::min<uint64_t>(segmentCount, std::numeric_limits<size_t>::max())));
+    }
+
+    ~SegmentSessionReservation()
+    {
+        if (sessionCount_ > 0)
+            if (const std::shared_ptr<SftpSessionManager> mgr = globalSftpSessionManager.get())
+                mgr->releaseSegmentSessions(login_, sessionCount_);
+    }
+
+    size_t getSessionCount() const { return sessionCount_; }
+
+private:
+    SegmentSessionReservation           (const SegmentSessionReservation&) = delete;
+    SegmentSessionReservation& operator=(const SegmentSessionReservation&) = delete;
+
+    const SftpLogin login_;
+    size_t sessionCount_ = 0;
+};
+
+
+LIBSSH2_SFTP_HANDLE* openSftpFileForReading(SftpSessionManager::SshSessionShared& session, const AfsPath& filePath) //throw SysError
+{
+    LIBSSH2_SFTP_HANDLE* fileHandle = nullptr;
+
+    auto retrieveOpenHandle = [&](unsigned long flags)
+    {
+        session.executeBlocking("libssh2_sftp_open", //throw SysError, SysErrorSftpProtocol
+                                [&](const SshSession::Details& sd) //noexcept!
+        {
+            fileHandle = ::libssh2_sftp_open(sd.sftpChannel, getLibssh2Path(filePath), flags, 0 /*mode*/);
+            if (!fileHandle)
+                return std::min(::libssh2_session_last_errno(sd.sshSession), LIBSSH2_ERROR_SOCKET_NONE);
+
+            return LIBSSH2_ERROR_NONE;
+        });
+    };
+
+    try
+    {
+        retrieveOpenHandle(LIBSSH2_FXF_READ); //throw SysError, SysErrorSftpProtocol
+    }
+    catch (const SysErrorSftpProtocol& e2)
+    {
+        //for Windows SFTP server we need fallback to "LIBSSH2_FXF_READ | LIBSSH2_FXF_WRITE": https://freefilesync.org/forum/viewtopic.php?t=13107
+        if (e2.sftpErrorCode == LIBSSH2_FX_PERMISSION_DENIED)
+            retrieveOpenHandle(LIBSSH2_FXF_READ | LIBSSH2_FXF_WRITE); //throw SysError, SysErrorSftpProtocol
+        else
+            throw;
+    }
+    return fileHandle;
+}
+
+
+//read-ahead of [startPos, fileSize) via worker threads; segments are handed out in stream order
+class SegmentedReaderSftp
+{
+public:
+    SegmentedReaderSftp(std::unique_ptr<SegmentSessionReservation>&& sessions, const SftpLogin& login, const AfsPath& filePath, uint64_t startPos, uint64_t fileSize) :
+        streamPos_(startPos),
+        nextOffset_(startPos),
+        endOffset_(fileSize),
+        segmentsInFlightMax_(sessions->getSessionCount() + 2), //bound memory consumption: ~7 MB per segment
+        sessions_(std::move(sessions))
+    {
+        assert(startPos <= fileSize && sessions_->getSessionCount() > 0);
+        const size_t sessionCount = sessions_->getSessionCount();
+        workersActive_ = sessionCount;
+
+        for (size_t i = 0; i < sessionCount; ++i)
+            workers_.emplace_back([this, login, filePath, i, sessionCount]
+        {
+            setCurrentThreadName(Zstr("Segmented Read[SFTP] ") + numberTo<Zstring>(i + 1) + Zstr('/') + numberTo<Zstring>(sessionCount));
+            readSegments(login, filePath); //throw ThreadStopRequest
+        });
+    }
+
+    ~SegmentedReaderSftp()
+    {
+        for (InterruptibleThread& wt : workers_)
+            wt.requestStop(); //stop *all* before ~InterruptibleThread() joins one by one
+    }
+
+    //may return short; only 0 means EOF! std::nullopt: no extra connection could be set up => continue reading via the stream's own handle
+    std::optional<size_t> tryRead(void* buffer, size_t bytesToRead) //throw SysError
+    {
+        std::unique_lock dummy(lockSegments_);
+        if (streamPos_ == endOffset_)
+            return 0;
+
+        conditionSegmentDone_.wait(dummy, [this] { return (!segments_.empty() && segments_.front().done) || errorMsg_ || workersActive_ == 0; });
+
+        if (segments_.empty() || !segments_.front().done)
+        {
+            if (errorMsg_)
+                throw SysError(*errorMsg_);
+
+            //workers with a file handle only quit after reading up to endOffset_, or with error => no worker got that far
+            assert(segments_.empty());
+            if (!segments_.empty())
+                throw SysError(formatSystemError("SegmentedReaderSftp", L"", L"Worker threads terminated unexpectedly."));
+            return std::nullopt;
+        }
+
+        Segment& seg = segments_.front();
+        const size_t bytesRead = std::min(bytesToRead, seg.buf.size() - seg.bytesConsumed);
+        std::memcpy(buffer, seg.buf.data() + seg.bytesConsumed, bytesRead);
+        seg.bytesConsumed += bytesRead;
+        streamPos_        += bytesRead;
+
+        if (seg.bytesConsumed == seg.buf.size())
+        {
+            segments_.pop_front();
+            dummy.unlock();
+            conditionSegmentFree_.notify_all();
+        }
+        return bytesRead;
+    }
+
+private:
+    SegmentedReaderSftp           (const SegmentedReaderSftp&) = delete;
+    SegmentedReaderSftp& operator=(const SegmentedReaderSftp&) = delete;
+
+    void readSegments(const SftpLogin& login, const AfsPath& filePath) //throw ThreadStopRequest
+    {
+        bool haveHandle = false;
+        std::optional<std::wstring> errorMsg;
         try
         {
-            session_ = getSharedSftpSession(login); //throw SysError
+            //separate SSH connection: that's the point!
+            const std::shared_ptr<SftpSessionManager::SshSessionShared> session = getDedicatedSftpSession(login); //throw SysError
 
-            auto retrieveOpenHandle = [&](unsigned long flags)
+            LIBSSH2_SFTP_HANDLE* fileHandle = openSftpFileForReading(*session, filePath); //throw SysError
+            haveHandle = true;
+            ZEN_ON_SCOPE_EXIT(try
             {
-                session_->executeBlocking("libssh2_sftp_open", //throw SysError, SysErrorSftpProtocol
-                                          [&](const SshSession::Details& sd) //noexcept!
+                session->executeBlocking("libssh2_sftp_close", //throw SysError, SysErrorSftpProtocol
+                [&](const SshSession::Details& sd) { return ::libssh2_sftp_close(fileHandle); }); //noexcept!
+            }
+            catch (const SysError& e) { logExtraError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(getSftpDisplayPath(login, filePath))) + L"\n\n" + e.toString()); });
+
+            std::vector<std::byte> buf;
+            for (;;)
+            {
+                Segment* seg = nullptr;
                 {
-                    fileHandle_ = ::libssh2_sftp_open(sd.sftpChannel, getLibssh2Path(filePath), flags, 0 /*mode*/);
-                    if (!fileHandle_)
-                        return std::min(::libssh2_session_last_errno(sd.sshSession), LIBSSH2_ERROR_SOCKET_NONE);
+                    std::unique_lock dummy(lockSegments_);
+                    interruptibleWait(conditionSegmentFree_, dummy, [this] { return nextOffset_ == endOffset_ || errorMsg_ || segments_.size() < segmentsInFlightMax_; }); //throw ThreadStopRequest
+                    if (nextOffset_ == endOffset_ || errorMsg_)
+                        break;
 
-                    return LIBSSH2_ERROR_NONE;
-                });
-            };
+                    //std::deque::emplace_back() doesn't invalidate references to other elements
+                    seg = &segments_.emplace_back(Segment{.offset = nextOffset_});
+                    nextOffset_ = std::min<uint64_t>(nextOffset_ + SFTP_SEGMENT_SIZE, endOffset_);
+                    buf.resize(static_cast<size_t>(nextOffset_ - seg->offset));
+                }
 
-            try
+                ::libssh2_sftp_seek64(fileHandle, seg->offset); //local operation, no round-trip
+
+                for (size_t bytesRead = 0; bytesRead < buf.size();)
+                {
+                    interruptionPoint(); //throw ThreadStopRequest
+
+                    ssize_t rv = 0;
+                    session->executeBlocking("libssh2_sftp_read", //throw SysError, SysErrorSftpProtocol
+                                             [&](const SshSession::Details& sd) //noexcept!
+                    {
+                        rv = ::libssh2_sftp_read(fileHandle, reinterpret_cast<char*>(buf.data() + bytesRead), std::min(buf.size() - bytesRead, SFTP_OPTIMAL_BLOCK_SIZE_READ));
+                        return static_cast<int>(rv);
+                    });
+                    if (rv == 0) //file shrunk after we got its size!?
+                        throw SysError(_("Unexpected size of data stream:") + L' ' + formatNumber(seg->offset + bytesRead) + L'\n' +
+                                       _("Expected:") + L' ' + formatNumber(endOffset_));
+
+                    ASSERT_SYSERROR(makeUnsigned(rv) <= buf.size() - bytesRead); //better safe than sorry
+                    bytesRead += rv;
+                }
+
+                {
+                    std::lock_guard dummy(lockSegments_);
+                    seg->buf = std::move(buf);
+                    seg->done = true;
+                }
+                conditionSegmentDone_.notify_all();
+                buf.clear(); //moved-from: unspecified state
+            }
+        }
+        catch (const SysError& e) { errorMsg = e.toString(); }
+
+        {
+            std::lock_guard dummy(lockSegments_);
+            //failure to set up an extra connection (e.g. server connection limit) is not fatal: other workers or the stream's own handle take over
+            if (errorMsg && haveHandle && !errorMsg_)
+                errorMsg_ = std::move(errorMsg);
+            --workersActive_;
+        }
+        conditionSegmentDone_.notify_all();
+        conditionSegmentFree_.notify_all();
+    }
+
+    struct Segment
+    {
+        uint64_t offset = 0;
+        std::vector<std::byte> buf;
+        size_t bytesConsumed = 0;
+        bool done = false;
+    };
+
+    std::mutex lockSegments_;
+    std::condition_variable conditionSegmentDone_;
+    std::condition_variable conditionSegmentFree_;
+    std::deque<Segment> segments_; //in stream order: front() is being consumed
+    uint64_t streamPos_;
+    uint64_t nextOffset_;
+    const uint64_t endOffset_;
+    const size_t segmentsInFlightMax_;
+    size_t workersActive_ = 0;
+    std::optional<std::wstring> errorMsg_;
+
+    const std::unique_ptr<SegmentSessionReservation> sessions_; //release *after* workers are joined
+    std::vector<InterruptibleThread> workers_; //declare last: stop + join before other members are destroyed
+};
+
+
+//write-behind of [0, streamSize) via worker threads, each writing its segments at their offsets into the already created target file
+class SegmentedWriterSftp
+{
+public:
+    SegmentedWriterSftp(std::unique_ptr<SegmentSessionReservation>&& sessions, const SftpLogin& login, const AfsPath& filePath) :
+        segmentsInFlightMax_(sessions->getSessionCount() + 2), //bound memory consumption: ~7 MB per segment
+        sessions_(std::move(sessions))
+    {
+        assert(sessions_->getSessionCount() > 0);
+        const size_t sessionCount = sessions_->getSessionCount();
+        workersActive_ = sessionCount;
+
+        for (size_t i = 0; i < sessionCount; ++i)
+            workers_.emplace_back([this, login, filePath, i, sessionCount]
+        {
+            setCurrentThreadName(Zstr("Segmented Write[SFTP] ") + numberTo<Zstring>(i + 1) + Zstr('/') + numberTo<Zstring>(sessionCount));
+            writeSegments(login, filePath); //throw ThreadStopRequest
+        });
+    }
+
+    ~SegmentedWriterSftp()
+    {
+        for (InterruptibleThread& wt : workers_)
+            wt.requestStop(); //stop *all* before ~InterruptibleThread() joins one by one
+    }
+
+    //may return short! CONTRACT: bytesToWrite > 0
+    size_t tryWrite(const void* buffer, size_t bytesToWrite) //throw SysError
+    {
+        assert(bytesToWrite > 0);
+        const size_t bytesWritten = std::min(bytesToWrite, SFTP_SEGMENT_SIZE - fillBuf_.size());
+        fillBuf_.insert(fillBuf_.end(), static_cast<const std::byte*>(buffer), static_cast<const std::byte*>(buffer) + bytesWritten);
+
+        if (fillBuf_.size() == SFTP_SEGMENT_SIZE)
+            pushSegment(); //throw SysError
+        return bytesWritten;
+    }
+
+    //wait until all data is on the server (unless unavailable(): see takeUnwritten())
+    void flush() //throw SysError
+    {
+        if (!fillBuf_.empty())
+            pushSegment(); //throw SysError
+
+        std::unique_lock dummy(lockSegments_);
+        inputComplete_ = true;
+        conditionSegmentNew_.notify_all();
+
+        conditionSegmentDone_.wait(dummy, [this] { return (segments_.empty() && segmentsActive_ == 0) || errorMsg_ || workersActive_ == 0; });
+        if (errorMsg_)
+            throw SysError(*errorMsg_);
+        if (segmentsActive_ != 0 || (!segments_.empty() && !unavailableImpl()))
+            throw SysError(formatSystemError("SegmentedWriterSftp", L"", L"Worker threads terminated unexpectedly."));
+    }
+
+    //no extra connection could be set up at all => nothing was written: let the stream write [0, streamPos) via its own handle
+    bool unavailable()
+    {
+        std::lock_guard dummy(lockSegments_);
+        return unavailableImpl();
+    }
+
+    std::vector<std::byte> takeUnwritten() //call only if unavailable()
+    {
+        assert(unavailable());
+        std::vector<std::byte> buf;
+        {
+            std::lock_guard dummy(lockSegments_);
+            for (const Segment& seg : segments_) //contiguous: [0, nextOffset_)
+                append(buf, seg.buf);
+            segments_.clear();
+        }
+        append(buf, fillBuf_);
+        fillBuf_.clear();
+        return buf;
+    }
+
+    uint64_t takeBytesWritten() //to be reported as progress
+    {
+        std::lock_guard dummy(lockSegments_);
+        return std::exchange(bytesWritten_, 0);
+    }
+
+private:
+    SegmentedWriterSftp           (const SegmentedWriterSftp&) = delete;
+    SegmentedWriterSftp& operator=(const SegmentedWriterSftp&) = delete;
+
+    void pushSegment() //throw SysError
+    {
+        std::unique_lock dummy(lockSegments_);
+        conditionSegmentDone_.wait(dummy, [this] { return segments_.size() + segmentsActive_ < segmentsInFlightMax_ || errorMsg_ || workersActive_ == 0; });
+        if (errorMsg_)
+            throw SysError(*errorMsg_);
+        if (workersActive_ == 0 && !unavailableImpl())
+            throw SysError(formatSystemError("SegmentedWriterSftp", L"", L"Worker threads terminated unexpectedly."));
+        //unavailable: keep segment for takeUnwritten()
+
+        segments_.push_back({.offset = nextOffset_, .buf = std::move(fillBuf_)});
+        nextOffset_ += segments_.back().buf.size();
+        fillBuf_.clear(); //moved-from: unspecified state
+        fillBuf_.reserve(SFTP_SEGMENT_SIZE);
+
+        dummy.unlock();
+        conditionSegmentNew_.notify_one();
+    }
+
+    void writeSegments(const SftpLogin& login, const AfsPath& filePath) //throw ThreadStopRequest
+    {
+        bool haveHandle = false;
+        std::optional<std::wstring> errorMsg;
+        try
+        {
+            //separate SSH connection: that's the point!
+            const std::shared_ptr<SftpSessionManager::SshSessionShared> session = getDedicatedSftpSession(login); //throw SysError
+
+            LIBSSH2_SFTP_HANDLE* fileHandle = nullptr;
+            session->executeBlocking("libssh2_sftp_open", //throw SysError, SysErrorSftpProtocol
+                                     [&](const SshSession::Details& sd) //noexcept!
             {
-                retrieveOpenHandle(LIBSSH2_FXF_READ); //throw SysError, SysErrorSftpProtocol
+                fileHandle = ::libssh2_sftp_open(sd.sftpChannel, getLibssh2Path(filePath), LIBSSH2_FXF_WRITE, 0 /*mode*/); //file already created by OutputStreamSftp
+                if (!fileHandle)
+                    return std::min(::libssh2_session_last_errno(sd.sshSession), LIBSSH2_ERROR_SOCKET_NONE);
+                return LIBSSH2_ERROR_NONE;
+            });
+            haveHandle = true;
+            {
+                std::lock_guard dummy(lockSegments_);
+                haveHandleAny_ = true;
             }
-            catch (const SysErrorSftpProtocol& e2)
+            ZEN_ON_SCOPE_FAIL(if (fileHandle) try
             {
-                //for Windows SFTP server we need fallback to "LIBSSH2_FXF_READ | LIBSSH2_FXF_WRITE": https://freefilesync.org/forum/viewtopic.php?t=13107
-                if (e2.sftpErrorCode == LIBSSH2_FX_PERMISSION_DENIED)
-                    retrieveOpenHandle(LIBSSH2_FXF_READ | LIBSSH2_FXF_WRITE); //throw SysError, SysErrorSftpProtocol
-                else
-                    throw;
+                session->executeBlocking("libssh2_sftp_close", //throw SysError, SysErrorSftpProtocol
+                [&](const SshSession::Details& sd) { return ::libssh2_sftp_close(fileHandle); }); //noexcept!
             }
+            catch (const SysError& e) { logExtraError(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(getSftpDisplayPath(login, filePath))) + L"\n\n" + e.toString()); });
+
+            for (;;)
+            {
+                Segment seg;
+                {
+                    std::unique_lock dummy(lockSegments_);
+                    interruptibleWait(conditionSegmentNew_, dummy, [this] { return !segments_.empty() || inputComplete_ || errorMsg_; }); //throw ThreadStopRequest
+                    if (segments_.empty() || errorMsg_)
+                        break;
+
+                    seg = std::move(segments_.front());
+                    /**/            segments_.pop_front();
+                    ++segmentsActive_;
+                }
+
+                ::libssh2_sftp_seek64(fileHandle, seg.offset); //local operation, no round-trip; server creates holes as needed
+
+                for (size_t bytesWritten = 0; bytesWritten < seg.buf.size();)
+                {
+                    interruptionPoint(); //throw ThreadStopRequest
+
+                    ssize_t rv = 0;
+                    session->executeBlocking("libssh2_sftp_write", //throw SysError, SysErrorSftpProtocol
+                                             [&](const SshSession::Details& sd) //noexcept!
+                    {
+                        rv = ::libssh2_sftp_write(fileHandle, reinterpret_cast<const char*>(seg.buf.data() + bytesWritten), std::min(seg.buf.size() - bytesWritten, SFTP_OPTIMAL_BLOCK_SIZE_WRITE));
+                        assert(rv != 0); //see OutputStreamSftp::tryWrite()
+                        return static_cast<int>(rv);
+                    });
+                    ASSERT_SYSERROR(makeUnsigned(rv) <= seg.buf.size() - bytesWritten); //better safe than sorry
+                    bytesWritten += rv;
+                }
+
+                {
+                    std::lock_guard dummy(lockSegments_);
+                    --segmentsActive_;
+                    bytesWritten_ += seg.buf.size();
+                }
+                conditionSegmentDone_.notify_all();
+            }
+
+            //close failure may indicate data loss => report, but don't try a second time
+            LIBSSH2_SFTP_HANDLE* const fileHandleClose = std::exchange(fileHandle, nullptr);
+            session->executeBlocking("libssh2_sftp_close", //throw SysError, SysErrorSftpProtocol
+            [&](const SshSession::Details& sd) { return ::libssh2_sftp_close(fileHandleClose); }); //noexcept!
+        }
+        catch (const SysError& e) { errorMsg = e.toString(); }
+
+        {
+            std::lock_guard dummy(lockSegments_);
+            //failure to set up an extra connection (e.g. server connection limit) is not fatal: other workers or the stream's own handle take over
+            if (errorMsg && haveHandle && !errorMsg_)
+                errorMsg_ = std::move(errorMsg);
+            --workersActive_;
+        }
+        conditionSegmentDone_.notify_all();
+        conditionSegmentNew_ .notify_all();
+    }
+
+    //all workers gone without error: workers with a file handle only quit after inputComplete_ => none got that far
+    bool unavailableImpl() const { return workersActive_ == 0 && !errorMsg_ && !haveHandleAny_; }
+
+    struct Segment
+    {
+        uint64_t offset = 0;
+        std::vector<std::byte> buf;
+    };
+
+    const size_t segmentsInFlightMax_;
+
+    std::vector<std::byte> fillBuf_; //producer thread only
+    uint64_t nextOffset_ = 0;        //
+
+    std::mutex lockSegments_;
+    std::condition_variable conditionSegmentNew_;
+    std::condition_variable conditionSegmentDone_;
+    std::deque<Segment> segments_; //pending, not yet picked up by a worker
+    size_t segmentsActive_ = 0;
+    bool inputComplete_ = false;
+    uint64_t bytesWritten_ = 0;
+    size_t workersActive_ = 0;
+    bool haveHandleAny_ = false;
+    std::optional<std::wstring> errorMsg_;
+
+    const std::unique_ptr<SegmentSessionReservation> sessions_; //release *after* workers are joined
+    std::vector<InterruptibleThread> workers_; //declare last: stop + join before other members are destroyed
+};
+
+struct InputStreamSftp : public AFS::InputStream
+{
+    InputStreamSftp(const SftpLogin& login, const AfsPath& filePath) : //throw FileError
+        login_(login),
+        filePath_(filePath),
+        displayPath_(getSftpDisplayPath(login, filePath))
+    {
+        try
+        {
+            session_ = getSharedSftpSession(login); //throw SysError
+
+            fileHandle_ = openSftpFileForReading(*session_, filePath); //throw SysError
         }
         catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot open file %x."), L"%x", fmtPath(displayPath_)), e.toString()); }
     }
 
     ~InputStreamSftp()
     {
+        segReader_.reset(); //stop worker threads first
+
         try
         {
             session_->executeBlocking("libssh2_sftp_close", //throw SysError, SysErrorSftpProtocol
@@ -1375,8 +2052,32 @@ struct InputStreamSftp : public AFS::InputStream
         ssize_t bytesRead = 0;
         try
         {
-            session_->executeBlocking("libssh2_sftp_read", //throw SysError, SysErrorSftpProtocol
-                                      [&](const SshSession::Details& sd) //noexcept!
+            //file size is not known up front (see tryGetAttributesFast()) => decide on segmented transfer once we're past the first segment:
+            if (!segmentedCheckDone_ && streamPos_ >= SFTP_SEGMENT_SIZE)
+            {
+                segmentedCheckDone_ = true;
+                if (const uint64_t fileSize = getFileSize(); //throw SysError
+                    fileSize >= streamPos_ + SFTP_SEGMENTED_TRANSFER_MIN)
+                    if (auto sessions = std::make_unique<SegmentSessionReservation>(login_, (fileSize - streamPos_ + SFTP_SEGMENT_SIZE - 1) / SFTP_SEGMENT_SIZE);
+                        sessions->getSessionCount() > 0)
+                        segReader_ = std::make_unique<SegmentedReaderSftp>(std::move(sessions), login_, filePath_, streamPos_, fileSize);
+            }
+
+            if (segReader_)
+            {
+                if (const std::optional<size_t> bytesReadSeg = segReader_->tryRead(buffer, bytesToRead)) //throw SysError
+                    bytesRead = *bytesReadSeg;
+                else //no extra connection available => continue on our own handle
+                {
+                    segReader_.reset();
+                    session_->executeBlocking("libssh2_sftp_seek64", //throw SysError, SysErrorSftpProtocol
+                    [&](const SshSession::Details& sd) { ::libssh2_sftp_seek64(fileHandle_, streamPos_); return LIBSSH2_ERROR_NONE; }); //noexcept!
+                }
+            }
+
+            if (!segReader_)
+                session_->executeBlocking("libssh2_sftp_read", //throw SysError, SysErrorSftpProtocol
+                                          [&](const SshSession::Details& sd) //noexcept!
             {
                 bytesRead = ::libssh2_sftp_read(fileHandle_, static_cast<char*>(buffer), bytesToRead);
                 return static_cast<int>(bytesRead);
@@ -1386,6 +2087,8 @@ struct InputStreamSftp : public AFS::InputStream
         }
         catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(displayPath_)), e.toString()); }
 
+        streamPos_ += bytesRead;
+
         if (notifyUnbufferedIO) notifyUnbufferedIO(bytesRead); //throw X
         return bytesRead; //"zero indicates end of file"
     }
@@ -1395,9 +2098,26 @@ struct InputStreamSftp : public AFS::InputStream
     //PERF: test case 148 files, 1MB: overall copy time increases by 20% if libssh2_sftp_fstat() gets called per each file
 
 private:
+    uint64_t getFileSize() //throw SysError
+    {
+        LIBSSH2_SFTP_ATTRIBUTES attr = {};
+        session_->executeBlocking("libssh2_sftp_fstat", //throw SysError, SysErrorSftpProtocol
+        [&](const SshSession::Details& sd) { return ::libssh2_sftp_fstat(fileHandle_, &attr); }); //noexcept!
+
+        if (!(attr.flags & LIBSSH2_SFTP_ATTR_SIZE))
+            return 0; //=> no segmented transfer
+        return attr.filesize;
+    }
+
+    const SftpLogin login_;
+    const AfsPath filePath_;
     const std::wstring displayPath_;
     LIBSSH2_SFTP_HANDLE* fileHandle_ = nullptr;
     std::shared_ptr<SftpSessionManager::SshSessionShared> session_;
+
+    uint64_t streamPos_ = 0;
+    bool segmentedCheckDone_ = false;
+    std::unique_ptr<SegmentedReaderSftp> segReader_;
 };
 
 //===========================================================================================================================
@@ -1407,6 +2127,7 @@ struct OutputStreamSftp : public AFS::OutputStreamImpl
 {
     OutputStreamSftp(const SftpLogin& login, //throw FileError
                      const AfsPath& filePath,
+                     std::optional<uint64_t> streamSize,
                      std::optional<time_t> modTime) :
         login_(login),
         filePath_(filePath),
@@ -1432,10 +2153,17 @@ struct OutputStreamSftp : public AFS::OutputStreamImpl
         //NOTE: fileHandle_ still unowned until end of constructor!!!
 
         //pre-allocate file space? not supported
+
+        if (streamSize && *streamSize >= SFTP_SEGMENTED_TRANSFER_MIN)
+            if (auto sessions = std::make_unique<SegmentSessionReservation>(login, (*streamSize + SFTP_SEGMENT_SIZE - 1) / SFTP_SEGMENT_SIZE); //noexcept: file handle would leak otherwise!
+                sessions->getSessionCount() > 0)
+                segWriter_ = std::make_unique<SegmentedWriterSftp>(std::move(sessions), login, filePath); //
     }
 
     ~OutputStreamSftp()
     {
+        segWriter_.reset(); //stop worker threads before deleting the file
+
         if (fileHandle_) //=> cleanup non-finalized output file
         {
             if (!closeFailed_) //otherwise there's no much point in calling libssh2_sftp_close() a second time => let it leak!?
@@ -1464,31 +2192,44 @@ struct OutputStreamSftp : public AFS::OutputStreamImpl
             throw std::logic_error(std::string(__FILE__) + '[' + numberTo<std::string>(__LINE__) + "] Contract violation!");
         assert(bytesToWrite % getBlockSize() == 0 || bytesToWrite < getBlockSize());
 
-        ssize_t bytesWritten = 0;
-        try
+        if (segWriter_)
         {
-            session_->executeBlocking("libssh2_sftp_write", //throw SysError, SysErrorSftpProtocol
-                                      [&](const SshSession::Details& sd) //noexcept!
+            size_t bytesWritten = 0;
+            try
             {
-                bytesWritten = ::libssh2_sftp_write(fileHandle_, static_cast<const char*>(buffer), bytesToWrite);
-                /*  "If this function returns zero it should not be considered an error, but simply that there was no error but yet no payload data got sent to the other end."
-                     => sounds like BS, but is it really true!?
-                    From the libssh2_sftp_write code it appears that the function always waits for at least one "ack", unless we give it so much data _libssh2_channel_write() can't sent it all! */
-                assert(bytesWritten != 0);
-                return static_cast<int>(bytesWritten);
-            });
+                bytesWritten = segWriter_->tryWrite(buffer, bytesToWrite); //throw SysError
+            }
+            catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(getSftpDisplayPath(login_, filePath_))), e.toString()); }
 
-            ASSERT_SYSERROR(makeUnsigned(bytesWritten) <= bytesToWrite); //better safe than sorry
+            if (segWriter_->unavailable())
+                writeUnsegmented(notifyUnbufferedIO); //throw FileError, X
+            else //report what's on the server rather than what's queued:
+                if (notifyUnbufferedIO) notifyUnbufferedIO(segWriter_->takeBytesWritten()); //throw X!
+            return bytesWritten;
         }
-        catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(getSftpDisplayPath(login_, filePath_))), e.toString()); }
-
-        if (notifyUnbufferedIO) notifyUnbufferedIO(bytesWritten); //throw X!
-
-        return bytesWritten;
+        return tryWriteUnsegmented(buffer, bytesToWrite, notifyUnbufferedIO); //throw FileError, X
     }
 
     AFS::FinalizeResult finalize(const IoCallback& notifyUnbufferedIO /*throw X*/) override //throw FileError, X
     {
+        if (segWriter_)
+        {
+            try
+            {
+                segWriter_->flush(); //throw SysError
+            }
+            catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(getSftpDisplayPath(login_, filePath_))), e.toString()); }
+
+            if (segWriter_->unavailable())
+                writeUnsegmented(notifyUnbufferedIO); //throw FileError, X
+            else
+            {
+                const uint64_t bytesWritten = segWriter_->takeBytesWritten();
+                segWriter_.reset(); //all worker file handles are closed
+                if (notifyUnbufferedIO) notifyUnbufferedIO(bytesWritten); //throw X!
+            }
+        }
+
         close(); //throw FileError
         //output finalized => no more exceptions from here on!
         //--------------------------------------------------------------------
@@ -1507,6 +2248,41 @@ struct OutputStreamSftp : public AFS::OutputStreamImpl
     }
 
 private:
+    //no extra connection for segmented transfer available => write data queued so far via our own handle and continue unsegmented
+    void writeUnsegmented(const IoCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, X
+    {
+        const std::vector<std::byte> buf = segWriter_->takeUnwritten();
+        segWriter_.reset();
+
+        for (size_t bytesWritten = 0; bytesWritten < buf.size();)
+            bytesWritten += tryWriteUnsegmented(buf.data() + bytesWritten, std::min(buf.size() - bytesWritten, SFTP_OPTIMAL_BLOCK_SIZE_WRITE), notifyUnbufferedIO); //throw FileError, X
+    }
+
+    size_t tryWriteUnsegmented(const void* buffer, size_t bytesToWrite, const IoCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, X; may return short!
+    {
+        ssize_t bytesWritten = 0;
+        try
+        {
+            session_->executeBlocking("libssh2_sftp_write", //throw SysError, SysErrorSftpProtocol
+                                      [&](const SshSession::Details& sd) //noexcept!
+            {
+                bytesWritten = ::libssh2_sftp_write(fileHandle_, static_cast<const char*>(buffer), bytesToWrite);
+                /*  "If this function returns zero it should not be considered an error, but simply that there was no error but yet no payload data got sent to the other end."
+                     => sounds like BS, but is it really true!?
+                    From the libssh2_sftp_write code it appears that the function always waits for at least one "ack", unless we give it so much data _libssh2_channel_write() can't sent it all! */
+                assert(bytesWritten != 0);
+                return static_cast<int>(bytesWritten);
+            });
+
+            ASSERT_SYSERROR(makeUnsigned(bytesWritten) <= bytesToWrite); //better safe than sorry
+        }
+        catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(getSftpDisplayPath(login_, filePath_))), e.toString()); }
+
+        if (notifyUnbufferedIO) notifyUnbufferedIO(bytesWritten); //throw X!
+
+        return bytesWritten;
+    }
+
     void close() //throw FileError
     {
         if (!fileHandle_)
@@ -1552,6 +2328,7 @@ private:
     LIBSSH2_SFTP_HANDLE* fileHandle_ = nullptr;
     bool closeFailed_ = false;
     std::shared_ptr<SftpSessionManager::SshSessionShared> session_;
+    std::unique_ptr<SegmentedWriterSftp> segWriter_;
 };
 
 //===========================================================================================================================
@@ -1817,9 +2594,11 @@ private:
                                                       std::optional<uint64_t> streamSize,
                                                       std::optional<time_t> modTime) const override
     {
-        return std::make_unique<OutputStreamSftp>(login_, filePath, modTime); //throw FileError
+        return std::make_unique<OutputStreamSftp>(login_, filePath, streamSize, modTime); //throw FileError
     }
 
+    std::optional<std::string> tryGetFileMd5Fast(const AfsPath& filePath) const override { return {}; } //throw FileError
+
     //----------------------------------------------------------------------------------------------------------------
     void traverseFolderRecursive(const TraverserWorkload& workload /*throw X*/, size_t parallelOps) const override
     {
@@ -1830,14 +2609,15 @@ private:
     //symlink handling: follow
     //already existing: undefined behavior! (e.g. fail/overwrite/auto-rename)
     FileCopyResult copyFileForSameAfsType(const AfsPath& sourcePath, const StreamAttributes& sourceAttr, //throw FileError, (ErrorFileLocked), X
-                                          const AbstractPath& targetPath, bool copyFilePermissions, const IoCallback& notifyUnbufferedIO /*throw X*/) const override
+                                          const AbstractPath& targetPath, bool copyFilePermissions, const IoCallback& notifyUnbufferedIO /*throw X*/,
+                                          const IoDataCallback& notifySourceData /*throw X*/) const override
     {
         //no native SFTP file copy => use stream-based file copy:
         if (copyFilePermissions)
             throw FileError(replaceCpy(_("Cannot write permissions of %x."), L"%x", fmtPath(AFS::getDisplayPath(targetPath))), _("Operation not supported by device."));
 
         //already existing: undefined behavior! (e.g. fail/overwrite/auto-rename)
-        return copyFileAsStream(sourcePath, sourceAttr, targetPath, notifyUnbufferedIO); //throw FileError, (ErrorFileLocked), X
+        return copyFileAsStream(sourcePath, sourceAttr, targetPath, notifyUnbufferedIO, notifySourceData); //throw FileError, (ErrorFileLocked), X
     }
 
     //symlink handling: follow
@@ -1960,6 +2740,9 @@ private:
     }
 
     bool hasNativeTransactionalCopy() const override { return false; }
+
+    //each thread opens its own SSH session: stay well below server limits (OpenSSH: MaxStartups 10:30:100)
+    size_t getDefaultParallelOps() const override { return 2; }
     //----------------------------------------------------------------------------------------------------------------
 
     int64_t getFreeDiskSpace(const AfsPath& folderPath) const override //throw FileError, returns < 0 if not available
@@ -2120,6 +2903,14 @@ SftpLogin fff::extractSftpLogin(const AfsDevice& afsDevice) //noexcept
 }
 
 
+void fff::setSftpSegmentSessionsMax(const AfsDevice& afsDevice, size_t sessionsMax) //noexcept
+{
+    if (const auto sftpDevice = dynamic_cast<const SftpFileSystem*>(&afsDevice.ref()))
+        if (const std::shared_ptr<SftpSessionManager> mgr = globalSftpSessionManager.get())
+            mgr->setSegmentSessionsMax(sftpDevice->getLogin(), sessionsMax);
+}
+
+
 int fff::getServerMaxChannelsPerConnection(const SftpLogin& login) //throw FileError
 {
     try
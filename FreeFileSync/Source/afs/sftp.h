@@ -42,13 +42,16 @@ struct SftpLogin
     bool allowZlib = false;
     //other settings not specific to SFTP session:
     int timeoutSec = 10;                    //valid range: [1, inf)
-    int traverserChannelsPerConnection = 1; //valid range: [1, inf)
+    int traverserChannelsPerConnection = 1; //valid range: [1, inf); also limits parallel file operations sharing one SSH connection
 };
 AfsDevice condenseToSftpDevice(const SftpLogin& login); //noexcept; potentially messy user input
 SftpLogin extractSftpLogin(const AfsDevice& afsDevice); //noexcept
 
 int getServerMaxChannelsPerConnection(const SftpLogin& login); //throw FileError
 
+//segmented transfer of large files: extra SSH connections shared by all file streams of the device; 0 (default): none
+void setSftpSegmentSessionsMax(const AfsDevice& afsDevice, size_t sessionsMax); //noexcept; no-op for non-SFTP devices
+
 AfsPath getSftpHomePath(const SftpLogin& login); //throw FileError
 }
 
@@ -7,6 +7,7 @@
 #include "application.h"
 #include <memory>
 #include <zen/file_access.h>
+#include <zen/file_io.h>
 #include <zen/json.h>
 #include <zen/shutdown.h>
 #include <zen/process_exec.h>
@@ -18,6 +19,7 @@
 #include <wx+/popup_dlg.h>
 #include <wx+/image_resources.h>
 #include "afs/concrete.h"
+#include "afs/native.h"
 #include "base/comparison.h"
 #include "base/synchronization.h"
 #include "ui/batch_status_handler.h"
@@ -72,6 +74,7 @@ void showSyntaxHelp()
                                                  TAB_SPACE + L"[" + _("config files:") + L" *.ffs_gui/*.ffs_batch]" + L'\n' +
                                                  TAB_SPACE + L"[-DirPair " + _("directory") + L' ' + _("directory") + L"]" L"\n" +
                                                  TAB_SPACE + L"[-Edit]" + L'\n' +
+                                                 TAB_SPACE + L"[-ChangeList " + _("file") + L"]" + L'\n' +
                                                  TAB_SPACE + L"[" + _("global config file:") + L" GlobalSettings.xml]" + L"\n\n" +
 
                                                  _("config files:") + L'\n' +
@@ -83,6 +86,9 @@ void showSyntaxHelp()
                                                  L"-Edit" + L'\n' +
                                                  _("Open the selected configuration for editing only, without executing it.") + L"\n\n" +
 
+                                                 L"-ChangeList " + _("file") + L'\n' +
+                                                 _("Text file listing the monitored folders and the changed items, one path per line, e.g. %change_list% from RealTimeSync. Batch mode only: Unchanged items are taken from the database instead of scanning.") + L"\n\n" +
+
                                                  _("global config file:") + L'\n' +
                                                  _("Path to an alternate GlobalSettings.xml file.")));
 }
@@ -249,10 +255,12 @@ void Application::onEnterEventLoop()
         std::vector<Zstring> cfgFilePaths;
         Zstring globalCfgPathAlt;
         bool openForEdit = false;
+        std::optional<ChangeList> changeList;
         {
-            const char* optionEdit    = "-edit";
-            const char* optionDirPair = "-dirpair";
-            const char* optionSendTo  = "-sendto"; //remaining arguments are unspecified number of folder paths; wonky syntax; let's keep it undocumented
+            const char* optionEdit       = "-edit";
+            const char* optionDirPair    = "-dirpair";
+            const char* optionChangeList = "-changelist";
+            const char* optionSendTo     = "-sendto"; //remaining arguments are unspecified number of folder paths; wonky syntax; let's keep it undocumented
 
             auto isHelpRequest = [](const Zstring& arg)
             {
@@ -267,9 +275,10 @@ void Application::onEnterEventLoop()
 
             auto isCommandLineOption = [&](const Zstring& arg)
             {
-                return equalAsciiNoCase(arg, optionEdit   ) ||
-                       equalAsciiNoCase(arg, optionDirPair) ||
-                       equalAsciiNoCase(arg, optionSendTo ) ||
+                return equalAsciiNoCase(arg, optionEdit      ) ||
+                       equalAsciiNoCase(arg, optionDirPair   ) ||
+                       equalAsciiNoCase(arg, optionChangeList) ||
+                       equalAsciiNoCase(arg, optionSendTo    ) ||
                        isHelpRequest(arg);
             };
 
@@ -288,6 +297,27 @@ void Application::onEnterEventLoop()
                         throw FileError(replaceCpy(_("A left and a right directory path are expected after %x."), L"%x", utfTo<std::wstring>(optionDirPair)));
                     dirPathPhrasePairs.back().second = *it;
                 }
+                else if (equalAsciiNoCase(*it, optionChangeList))
+                {
+                    if (++it == commandArgs.end() || isCommandLineOption(*it))
+                        throw FileError(replaceCpy(_("A file path is expected after %x."), L"%x", utfTo<std::wstring>(optionChangeList)));
+
+                    const std::string changeListBuf = getFileContent(getResolvedFilePath(*it), nullptr /*notifyUnbufferedIO*/); //throw FileError
+
+                    //format: "[Watched]" section followed by "[Changed]" section; section names can't be mistaken for (absolute) paths
+                    //no "[Watched]" section (old format): coverage unknown => always full scan
+                    changeList.emplace();
+                    std::vector<Zstring>* section = &changeList->changedItemPaths;
+                    split2(changeListBuf, [](char c) { return c == '\n'; }, [&](const std::string_view line) //'\r' is a valid file name character!
+                    {
+                        if (line == "[Watched]")
+                            section = &changeList->watchedFolderPaths;
+                        else if (line == "[Changed]")
+                            section = &changeList->changedItemPaths;
+                        else if (!line.empty())
+                            section->push_back(utfTo<Zstring>(line));
+                    });
+                }
                 else if (equalAsciiNoCase(*it, optionSendTo))
                 {
                     for (size_t i = 0; ; ++i)
@@ -438,7 +468,7 @@ void Application::onEnterEventLoop()
 
             replaceDirectories(batchCfg.guiCfg.mainCfg); //throw FileError
 
-            runBatchMode(batchCfg, filePath0, globalCfg, globalCfgFilePath);
+            runBatchMode(batchCfg, filePath0, changeList, globalCfg, globalCfgFilePath);
         }
         else //GUI mode: (ffs_gui *or* ffs_batch)
         {
@@ -462,7 +492,8 @@ void Application::onEnterEventLoop()
 }
 
 
-void Application::runBatchMode(const FfsBatchConfig& batchCfg, const Zstring& cfgFilePath, GlobalConfig globalCfg, const Zstring& globalCfgFilePath)
+void Application::runBatchMode(const FfsBatchConfig& batchCfg, const Zstring& cfgFilePath, const std::optional<ChangeList>& changeList,
+                               GlobalConfig globalCfg, const Zstring& globalCfgFilePath)
 {
     const bool allowUserInteraction = !batchCfg.batchExCfg.autoCloseSummary ||
                                       (!batchCfg.guiCfg.mainCfg.ignoreErrors && batchCfg.batchExCfg.batchErrorHandling == BatchErrorHandling::showPopup);
@@ -483,6 +514,18 @@ void Application::runBatchMode(const FfsBatchConfig& batchCfg, const Zstring& cf
         globalCfg.dpiLayouts[getDpiScalePercent()].progressDlg.isMaximized
     };
 
+    AbstractPath logFolderPath = createAbstractPath(batchCfg.guiCfg.mainCfg.altLogFolderPathPhrase); //optional
+    if (AFS::isNullPath(logFolderPath))
+        logFolderPath = createAbstractPath(globalCfg.logFolderPhrase);
+    assert(!AFS::isNullPath(logFolderPath)); //mandatory! but still: let's include fall back
+    if (AFS::isNullPath(logFolderPath))
+        logFolderPath = createAbstractPath(getLogFolderDefaultPath());
+
+    //stream log to disk while running: requires local file system => fall back to default log folder
+    Zstring logSpoolFolderPath = getNativeItemPath(logFolderPath);
+    if (logSpoolFolderPath.empty())
+        logSpoolFolderPath = getLogFolderDefaultPath();
+
     //class handling status updates and error messages
     BatchStatusHandler statusHandler(!batchCfg.batchExCfg.runMinimized,
                                      extractJobName(cfgFilePath),
@@ -495,7 +538,8 @@ void Application::runBatchMode(const FfsBatchConfig& batchCfg, const Zstring& cf
                                      progDlgRect,
                                      batchCfg.batchExCfg.autoCloseSummary,
                                      batchCfg.batchExCfg.postBatchAction,
-                                     batchCfg.batchExCfg.batchErrorHandling);
+                                     batchCfg.batchExCfg.batchErrorHandling,
+                                     logSpoolFolderPath);
 
     AFS::RequestPasswordFun requestPassword; //throw CancelProcess
     if (allowUserInteraction)
@@ -523,6 +567,8 @@ void Application::runBatchMode(const FfsBatchConfig& batchCfg, const Zstring& cf
                                              globalCfg.createLockFile,
                                              dirLocks,
                                              extractCompareCfg(batchCfg.guiCfg.mainCfg),
+                                             batchCfg.guiCfg.mainCfg.deviceParallelOps,
+                                             changeList,
                                              statusHandler); //throw CancelProcess
         if (!cmpResult.empty())
             synchronize(syncStartTime,
@@ -533,6 +579,7 @@ void Application::runBatchMode(const FfsBatchConfig& batchCfg, const Zstring& cf
                         globalCfg.runWithBackgroundPriority,
                         extractSyncCfg(batchCfg.guiCfg.mainCfg),
                         cmpResult,
+                        batchCfg.guiCfg.mainCfg.deviceParallelOps,
                         globalCfg.warnDlgs,
                         statusHandler); //throw CancelProcess
     }
@@ -542,13 +589,6 @@ void Application::runBatchMode(const FfsBatchConfig& batchCfg, const Zstring& cf
     BatchStatusHandler::Result r = statusHandler.prepareResult();
 
 
-    AbstractPath logFolderPath = createAbstractPath(batchCfg.guiCfg.mainCfg.altLogFolderPathPhrase); //optional
-    if (AFS::isNullPath(logFolderPath))
-        logFolderPath = createAbstractPath(globalCfg.logFolderPhrase);
-    assert(!AFS::isNullPath(logFolderPath)); //mandatory! but still: let's include fall back
-    if (AFS::isNullPath(logFolderPath))
-        logFolderPath = createAbstractPath(getLogFolderDefaultPath());
-
     AbstractPath logFilePath = AFS::appendRelPath(logFolderPath, generateLogFileName(globalCfg.logFormat, r.summary));
     //e.g. %AppData%\FreeFileSync\Logs\Backup FreeFileSync 2013-09-15 015052.123 [Error].log
 
@@ -600,7 +640,7 @@ void Application::runBatchMode(const FfsBatchConfig& batchCfg, const Zstring& cf
                 try
                 {
                     logMsg(r.errorLog.ref(), replaceCpy(_("Sending email notification to %x"), L"%x", utfTo<std::wstring>(notifyEmail)), MSG_TYPE_INFO);
-                    sendLogAsEmail(notifyEmail, r.summary, r.errorLog.ref(), logFilePath, notifyStatusNoThrow); //throw FileError
+                    sendLogAsEmail(notifyEmail, r.summary, r.errorLog.ref(), r.logSpool.get(), logFilePath, notifyStatusNoThrow); //throw FileError
                 }
                 catch (const FileError& e) { logMsg(r.errorLog.ref(), e.toString(), MSG_TYPE_ERROR); }
     }
@@ -614,7 +654,7 @@ void Application::runBatchMode(const FfsBatchConfig& batchCfg, const Zstring& cf
     try //create not before destruction: 1. avoid issues with FFS trying to sync open log file 2. include status in log file name without extra rename
     {
         //do NOT use tryReportingError()! saving log files should not be cancellable!
-        saveLogFile(logFilePath, r.summary, r.errorLog.ref(), globalCfg.logfilesMaxAgeDays, globalCfg.logFormat, logsToKeepPaths, notifyStatusNoThrow); //throw FileError
+        saveLogFile(logFilePath, r.summary, r.errorLog.ref(), r.logSpool.get(), globalCfg.logfilesMaxAgeDays, globalCfg.logFormat, logsToKeepPaths, notifyStatusNoThrow); //throw FileError
     }
     catch (const FileError& e)
     {
@@ -627,13 +667,13 @@ void Application::runBatchMode(const FfsBatchConfig& batchCfg, const Zstring& cf
             logMsg(r.errorLog.ref(), e.toString(), MSG_TYPE_ERROR);
 
             logFilePath = logFileDefaultPath;
-            saveLogFile(logFileDefaultPath, r.summary, r.errorLog.ref(), globalCfg.logfilesMaxAgeDays, globalCfg.logFormat, logsToKeepPaths, notifyStatusNoThrow); //throw FileError
+            saveLogFile(logFileDefaultPath, r.summary, r.errorLog.ref(), r.logSpool.get(), globalCfg.logfilesMaxAgeDays, globalCfg.logFormat, logsToKeepPaths, notifyStatusNoThrow); //throw FileError
         }
         catch (const FileError& e2) { logMsg(r.errorLog.ref(), e2.toString(), MSG_TYPE_ERROR); logExtraError(e2.toString()); } //should never happen!!!
     }
 
     //--------- update last sync stats for the selected cfg file ---------
-    const ErrorLogStats& logStats = getStats(r.errorLog.ref());
+    const ErrorLogStats& logStats = r.logSpool ? r.logSpool->getStats(r.errorLog.ref()) : getStats(r.errorLog.ref());
 
     for (ConfigFileItem& cfi : globalCfg.mainDlg.config.fileHistory)
         if (equalNativePath(cfi.cfgFilePath, cfgFilePath))
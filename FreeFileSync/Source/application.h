@@ -12,6 +12,7 @@
 #include <wx/app.h>
 #include "config.h"
 #include "return_codes.h"
+#include "base/comparison.h"
 
 
 namespace fff //avoid name clash with "int ffs()" for fuck's sake! (maxOS, Linux issue only: <string> internally includes <strings.h>, WTF!)
@@ -25,7 +26,7 @@ private:
     wxLayoutDirection GetLayoutDirection() const override;
     void onEnterEventLoop();
 
-    void runBatchMode(const FfsBatchConfig& batchCfg, const Zstring& cfgFilePath,
+    void runBatchMode(const FfsBatchConfig& batchCfg, const Zstring& cfgFilePath, const std::optional<ChangeList>& changeList,
                       GlobalConfig globalCfg, const Zstring& globalCfgFilePath);
 
     FfsExitCode exitCode_ = FfsExitCode::success;
@@ -11,6 +11,7 @@
 #include "norm_filter.h"
 #include "db_file.h"
 #include "cmp_filetime.h"
+#include "binary.h"
 #include "status_handler_impl.h"
 #include "../afs/concrete.h"
 #include "../afs/native.h"
@@ -25,7 +26,7 @@ void fff::swapGrids(const MainConfiguration& mainCfg, FolderComparison& folderCm
     for (BaseFolderPair& baseFolder : asRange(folderCmp))
         baseFolder.flip();
 
-    redetermineSyncDirection(extractDirectionCfg(folderCmp, mainCfg),
+    redetermineSyncDirection(extractDirectionCfg(folderCmp, mainCfg), mainCfg.deviceParallelOps,
                              callback); //throw FileError
 }
 
@@ -33,23 +34,105 @@ void fff::swapGrids(const MainConfiguration& mainCfg, FolderComparison& folderCm
 
 namespace
 {
+/*  set sync directions of large hierarchies per subtree in parallel: same split as SyncStatistics
+    - items are independent of each other, except for FolderPair::syncOpBuffered_ of parent folders, invalidated by FileSystemObject::setSyncDir()
+        => folders above the split points are processed and invalidated on the main thread *before* going parallel:
+           concurrent notifications then only read them, see FolderPair::notifySyncCfgChanged()
+    - Setter::processShallow(conObj, ctx):   files and symlinks only
+      Setter::processFolderSelf(folder, ctx): folder only; returns context for child items, or none if child items were handled already
+      Setter::recurse(conObj, ctx):          all contained items                                                                      */
+template <class Setter>
+std::vector<std::function<void()>> getSubtreeTasks(const std::shared_ptr<const Setter>& setter, ContainerObject& baseObj, const typename Setter::Context& baseCtx)
+{
+    struct WorkItem
+    {
+        ContainerObject* conObj;
+        FolderPair* folder; //== conObj, or nullptr for base folder
+        typename Setter::Context ctx;
+        bool recursive;
+    };
+    std::vector<WorkItem> workItems{{&baseObj, nullptr, baseCtx, true}};
+
+    if (countItemsUpTo(baseObj, PARALLEL_HIERARCHY_ITEMS_MIN) >= PARALLEL_HIERARCHY_ITEMS_MIN) //small hierarchy: don't split at all
+    {
+        const size_t threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 1); //hardware_concurrency() == 0 if "not computable or well defined"
+
+        for (int level = 0; level < 3 && workItems.size() < 4 * threadCount; ++level)
+        {
+            std::vector<WorkItem> workItemsSplit;
+            for (const WorkItem& wi : workItems)
+                if (wi.recursive && !wi.conObj->subfolders().empty())
+                {
+                    workItemsSplit.push_back({wi.conObj, wi.folder, wi.ctx, false /*recursive*/});
+
+                    for (FolderPair& subFolder : wi.conObj->subfolders())
+                        if (std::optional<typename Setter::Context> subCtx = setter->processFolderSelf(subFolder, wi.ctx)) //main thread: see above
+                            workItemsSplit.push_back({&subFolder, &subFolder, std::move(*subCtx), true /*recursive*/});
+
+                    if (wi.folder)
+                        wi.folder->invalidateSyncOperation(); //see above
+                }
+                else
+                    workItemsSplit.push_back(wi);
+
+            workItems.swap(workItemsSplit);
+        }
+    }
+
+    std::vector<std::function<void()>> tasks;
+    for (const WorkItem& wi : workItems)
+        tasks.push_back([setter, wi]
+    {
+        if (wi.recursive)
+            setter->recurse(*wi.conObj, wi.ctx);
+        else
+            setter->processShallow(*wi.conObj, wi.ctx);
+    });
+    return tasks;
+}
+
+
+void runTasks(std::vector<std::function<void()>>& tasks, const Zstring& threadGroupName)
+{
+    if (tasks.size() == 1)
+        tasks[0]();
+    else if (!tasks.empty())
+    {
+        ThreadGroup<std::function<void()>> tg(std::min<size_t>(std::max<size_t>(std::thread::hardware_concurrency(), 1), tasks.size()), threadGroupName);
+        for (std::function<void()>& task : tasks)
+            tg.run(std::move(task));
+        tg.wait();
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
 //visitFSObjectRecursively? nope, see premature end of traversal in processFolder()
 class SetSyncDirViaDifferences
 {
 public:
-    static void execute(const DirectionByDiff& dirs, ContainerObject& conObj) { SetSyncDirViaDifferences(dirs).recurse(conObj); }
+    static std::vector<std::function<void()>> getTasks(const DirectionByDiff& dirs, ContainerObject& conObj)
+    { return getSubtreeTasks(std::shared_ptr<const SetSyncDirViaDifferences>(new SetSyncDirViaDifferences(dirs)), conObj, {}); }
 
 private:
     SetSyncDirViaDifferences(const DirectionByDiff& dirs) : dirs_(dirs) {}
 
-    void recurse(ContainerObject& conObj) const
+    using Context = std::monostate; //no per-folder state
+    template <class Setter> friend std::vector<std::function<void()>> getSubtreeTasks(const std::shared_ptr<const Setter>& setter, ContainerObject& baseObj, const typename Setter::Context& baseCtx);
+
+    void recurse(ContainerObject& conObj, Context = {}) const
+    {
+        processShallow(conObj);
+        for (FolderPair& folder : conObj.subfolders())
+            processFolder(folder);
+    }
+
+    void processShallow(ContainerObject& conObj, Context = {}) const
     {
         for (FilePair& file : conObj.files())
             processFile(file);
         for (SymlinkPair& link : conObj.symlinks())
             processLink(link);
-        for (FolderPair& folder : conObj.subfolders())
-            processFolder(folder);
     }
 
     void processFile(FilePair& file) const
@@ -148,14 +231,26 @@ private:
     }
 
     void processFolder(FolderPair& folder) const
+    {
+        if (processFolderSelf(folder))
+            recurse(folder);
+    }
+
+    std::optional<Context> processFolderSelf(FolderPair& folder, Context = {}) const //returns none if child items were handled already
     {
         const CompareDirResult cat = folder.getDirCategory();
 
         //########### schedule abandoned temporary recycle bin directory for deletion  ##########
         if (cat == DIR_LEFT_ONLY && endsWith(folder.getItemName<SelectSide::left>(), AFS::TEMP_FILE_ENDING))
-            return setSyncDirectionRec(SyncDirection::left, folder); //
+        {
+            setSyncDirectionRec(SyncDirection::left, folder); //
+            return {};
+        }
         else if (cat == DIR_RIGHT_ONLY && endsWith(folder.getItemName<SelectSide::right>(), AFS::TEMP_FILE_ENDING))
-            return setSyncDirectionRec(SyncDirection::right, folder); //don't recurse below!
+        {
+            setSyncDirectionRec(SyncDirection::right, folder); //don't recurse below!
+            return {};
+        }
         //#######################################################################################
 
         switch (cat)
@@ -179,8 +274,7 @@ private:
                 folder.setSyncDirConflict(folder.getCategoryCustomDescription()); //take over category conflict: allow *manual* resolution only!
                 break;
         }
-
-        recurse(folder);
+        return Context();
     }
 
     const DirectionByDiff dirs_;
@@ -351,8 +445,8 @@ private:
         purgeDuplicates<SelectSide::left >(filesL_,  exLeftOnlyById_);
         purgeDuplicates<SelectSide::right>(filesR_, exRightOnlyById_);
 
-        if ((!exLeftOnlyById_ .empty() || !exLeftOnlyByPath_ .empty()) &&
-            (!exRightOnlyById_.empty() || !exRightOnlyByPath_.empty()))
+        if ((!exLeftOnlyById_ .empty() || !exLeftOnlyByPath_ .empty() || !exLeftOnlyBySize_ .empty()) &&
+            (!exRightOnlyById_.empty() || !exRightOnlyByPath_.empty() || !exRightOnlyBySize_.empty()))
             detectMovePairs(dbFolder);
     }
 
@@ -362,11 +456,11 @@ private:
         {
             file.setMovePair(nullptr); //discard remnants from previous move detection and start fresh (e.g. consider manual folder rename)
 
-            const AFS::FingerPrint filePrintL = file.isEmpty<SelectSide::left >() ? 0 : file.getFilePrint<SelectSide::left >();
-            const AFS::FingerPrint filePrintR = file.isEmpty<SelectSide::right>() ? 0 : file.getFilePrint<SelectSide::right>();
+            const AFS::FingerPrint filePrintL = getMovePrint<SelectSide::left >(file);
+            const AFS::FingerPrint filePrintR = getMovePrint<SelectSide::right>(file);
 
-            if (filePrintL != 0) filesL_.push_back(&file); //collect *all* prints for uniqueness check!
-            if (filePrintR != 0) filesR_.push_back(&file); //
+            if (filePrintL != 0) filesL_.emplace_back(filePrintL, &file); //collect *all* prints for uniqueness check!
+            if (filePrintR != 0) filesR_.emplace_back(filePrintR, &file); //
 
             auto getDbEntry = [](const InSyncFolder* dbFolder, const Zstring& fileName) -> const InSyncFile*
             {
@@ -382,11 +476,17 @@ private:
             {
                 if (const InSyncFile* dbEntry = getDbEntry(dbFolderL, file.getItemName<SelectSide::left>()))
                     exLeftOnlyByPath_.emplace(dbEntry, &file);
+
+                if (filePrintL == 0 && file.getFileSize<SelectSide::left>() != 0) //empty files: way too ambiguous, and copying them costs nothing anyway
+                    exLeftOnlyBySize_[file.getFileSize<SelectSide::left>()].push_back(&file);
             }
             else if (cat == FILE_RIGHT_ONLY)
             {
                 if (const InSyncFile* dbEntry = getDbEntry(dbFolderR, file.getItemName<SelectSide::right>()))
                     exRightOnlyByPath_.emplace(dbEntry, &file);
+
+                if (filePrintR == 0 && file.getFileSize<SelectSide::right>() != 0)
+                    exRightOnlyBySize_[file.getFileSize<SelectSide::right>()].push_back(&file);
             }
         }
 
@@ -412,44 +512,44 @@ private:
     }
 
     template <SelectSide side>
-    static void purgeDuplicates(std::vector<FilePair*>& files,
-                                std::unordered_map<AFS::FingerPrint, FilePair*>& exOneSideById)
+    static AFS::FingerPrint getMovePrint(const FilePair& file)
     {
-        if (!files.empty())
-        {
-            std::sort(files.begin(), files.end(), [](const FilePair* lhs, const FilePair* rhs)
-            { return lhs->getFilePrint<side>() < rhs->getFilePrint<side>(); });
+        if (file.isEmpty<side>())
+            return 0;
+        return file.getFilePrint<side>();
+    }
 
-            AFS::FingerPrint prevPrint = files[0]->getFilePrint<side>();
+    template <SelectSide side>
+    static AFS::FingerPrint getMovePrint(const InSyncFile& dbFile) { return selectParam<side>(dbFile.left, dbFile.right).filePrint; }
 
-            for (auto it = files.begin() + 1; it != files.end(); ++it)
-                if (const AFS::FingerPrint filePrint = (*it)->getFilePrint<side>();
-                    prevPrint != filePrint)
-                    prevPrint = filePrint;
-                else //duplicate file ID! NTFS hard link/symlink?
-                {
-                    const auto dupFirst = it - 1;
-                    const auto dupLast = std::find_if(it + 1, files.end(), [prevPrint](const FilePair* file)
-                    { return file->getFilePrint<side>() != prevPrint; });
-
-                    //remove from model: do *not* store invalid file prints in sync.ffs_db!
-                    for (FilePair* file : std::span(dupFirst, dupLast))
-                        file->clearFilePrint<side>();
-                    it = dupLast - 1;
-                }
+    template <SelectSide side>
+    static void purgeDuplicates(std::vector<std::pair<AFS::FingerPrint, FilePair*>>& files,
+                                std::unordered_map<AFS::FingerPrint, FilePair*>& exOneSideById)
+    {
+        std::sort(files.begin(), files.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+        //collect unique file prints for files existing on one side only:
+        constexpr CompareFileResult oneSideOnlyTag = side == SelectSide::left ? FILE_LEFT_ONLY : FILE_RIGHT_ONLY;
 
-            //collect unique file prints for files existing on one side only:
-            constexpr CompareFileResult oneSideOnlyTag = side == SelectSide::left ? FILE_LEFT_ONLY : FILE_RIGHT_ONLY;
+        for (auto it = files.begin(); it != files.end();)
+        {
+            const AFS::FingerPrint filePrint = it->first;
+            const auto itLast = std::find_if(it + 1, files.end(), [filePrint](const auto& item) { return item.first != filePrint; });
 
-            for (FilePair* file : files)
-                if (file->getCategory() == oneSideOnlyTag)
-                    if (const AFS::FingerPrint filePrint = file->getFilePrint<side>();
-                        filePrint != 0) //skip duplicates marked by clearFilePrint()
-                        exOneSideById.emplace(filePrint, file);
+            if (itLast - it == 1)
+            {
+                if (it->second->getCategory() == oneSideOnlyTag)
+                    exOneSideById.emplace(filePrint, it->second);
+            }
+            else //duplicate file ID! NTFS hard link/symlink?
+                for (auto itDup = it; itDup != itLast; ++itDup)
+                    if (itDup->second->getFilePrint<side>() == filePrint)
+                        itDup->second->clearFilePrint<side>(); //remove from model: do *not* store invalid file prints in sync.ffs_db!
+            it = itLast;
         }
     }
 
-    void detectMovePairs(const InSyncFolder& container) const
+    void detectMovePairs(const InSyncFolder& container)
     {
         for (const auto& [fileName, dbAttrib] : container.files)
             findAndSetMovePair(dbAttrib);
@@ -459,10 +559,17 @@ private:
     }
 
     template <SelectSide side>
-    static bool sameSizeAndDate(const FilePair& file, const InSyncFile& dbFile)
+    bool sameSizeAndDate(const FilePair& file, const InSyncFile& dbFile) const
     {
-        return file.getFileSize<side>() == dbFile.fileSize &&
-               file.getLastWriteTime<side>() == selectParam<side>(dbFile.left, dbFile.right).modTime;
+        if (file.getFileSize<side>() != dbFile.fileSize)
+            return false;
+
+        const time_t modTimeDb = selectParam<side>(dbFile.left, dbFile.right).modTime;
+
+        if (file.getFilePrint<side>() == 0) //no file ID: device without sub-second (or even minute) precision, e.g. FTP => consider configured tolerance
+            return sameFileTime(file.getLastWriteTime<side>(), modTimeDb, fileTimeTolerance_, ignoreTimeShiftMinutes_);
+
+        return file.getLastWriteTime<side>() == modTimeDb;
         /* do NOT consider FAT_FILE_TIME_PRECISION_SEC:
             1. if DB contains file metadata collected during folder comparison we can be as precise as we want here
             2. if DB contains file metadata *estimated* directly after file copy:
@@ -475,7 +582,7 @@ private:
     }
 
     template <SelectSide side>
-    FilePair* getAssocFilePair(const InSyncFile& dbFile) const
+    FilePair* getAssocFilePair(const InSyncFile& dbFile)
     {
         const std::unordered_map<const InSyncFile*, FilePair*>& exOneSideByPath = selectParam<side>(exLeftOnlyByPath_, exRightOnlyByPath_);
         const std::unordered_map<AFS::FingerPrint,  FilePair*>& exOneSideById   = selectParam<side>(exLeftOnlyById_,   exRightOnlyById_);
@@ -486,16 +593,61 @@ private:
         //even if the association by path doesn't match time and size while the association by ID does!
         //there doesn't seem to be (any?) value in allowing this!
 
-        if (const AFS::FingerPrint filePrint = selectParam<side>(dbFile.left, dbFile.right).filePrint;
+        if (const AFS::FingerPrint filePrint = getMovePrint<side>(dbFile);
             filePrint != 0)
+        {
             if (const auto it = exOneSideById.find(filePrint);
                 it != exOneSideById.end())
                 return it->second;
+        }
+        else //device without file IDs (SFTP, FTP without "unique" fact)
+            return getAssocFilePairBySample<side>(dbFile);
 
         return nullptr;
     }
 
-    void findAndSetMovePair(const InSyncFile& dbFile) const
+    /*  fallback for devices without persistent file IDs:
+        - item name is *not* considered: renamed files and moved folders are found alike
+        - file size + modification time (within configured tolerance) + content sample: read the head of each candidate file => see getContentSample()
+        - no content sample in database (e.g. file not copied by FreeFileSync yet)? => size + time only
+        - ambiguous candidates: no match (e.g. same file copied to multiple locations)
+        - content is compared once more before moving: FolderPairSyncer::synchronizeFileInt()                     */
+    template <SelectSide side>
+    FilePair* getAssocFilePairBySample(const InSyncFile& dbFile)
+    {
+        const std::unordered_map<uint64_t, std::vector<FilePair*>>& exOneSideBySize = selectParam<side>(exLeftOnlyBySize_, exRightOnlyBySize_);
+
+        const auto it = exOneSideBySize.find(dbFile.fileSize);
+        if (it == exOneSideBySize.end())
+            return nullptr;
+
+        FilePair* match = nullptr;
+        for (FilePair* file : it->second)
+            if (!file->getMovePair() && //already matched with other database entry
+                sameSizeAndDate<side>(*file, dbFile) &&
+                (dbFile.contentSample == 0 || getContentSampleBuffered<side>(*file) == dbFile.contentSample))
+            {
+                if (match)
+                    return nullptr; //ambiguous
+                match = file;
+            }
+        return match;
+    }
+
+    template <SelectSide side>
+    uint64_t getContentSampleBuffered(const FilePair& file) //file exists on one side only => no need to distinguish sides in buffer
+    {
+        const auto [it, inserted] = contentSamples_.try_emplace(&file, 0);
+        if (inserted)
+            try
+            {
+                it->second = getContentSample(file.getAbstractPath<side>(), file.getFileSize<side>()); //throw FileError
+            }
+            catch (FileError&) {} //=> no match: file will be copied instead
+        return it->second;
+    }
+
+    void findAndSetMovePair(const InSyncFile& dbFile)
     {
         if (stillInSync(dbFile, cmpVar_, fileTimeTolerance_, ignoreTimeShiftMinutes_))
             if (FilePair* fileLeftOnly = getAssocFilePair<SelectSide::left>(dbFile))
@@ -510,7 +662,9 @@ private:
                                 //--------------- found a match ---------------
                             {
                                 //move pair is just a 'rename' => combine:
-                                if (&fileLeftOnly->parent() == &fileRightOnly->parent())
+                                if (&fileLeftOnly->parent() == &fileRightOnly->parent() &&
+                                    fileLeftOnly ->getFilePrint<SelectSide::left >() != 0 && //matched without file ID? => keep move pair:
+                                    fileRightOnly->getFilePrint<SelectSide::right>() != 0)    //content is verified before moving
                                 {
                                     fileLeftOnly->setSyncedTo<SelectSide::right>(fileLeftOnly->getFileSize<SelectSide::left>(),
                                                                                  fileRightOnly->getLastWriteTime<SelectSide::right>(), //lastWriteTimeTrg
@@ -542,8 +696,8 @@ private:
     const unsigned int fileTimeTolerance_;
     const std::vector<unsigned int> ignoreTimeShiftMinutes_;
 
-    std::vector<FilePair*> filesL_; //collection of *all* file items (with non-null filePrint)
-    std::vector<FilePair*> filesR_; // => detect duplicate file IDs
+    std::vector<std::pair<AFS::FingerPrint, FilePair*>> filesL_; //collection of *all* file items (with non-null file print)
+    std::vector<std::pair<AFS::FingerPrint, FilePair*>> filesR_; // => detect duplicate file IDs
 
     std::unordered_map<AFS::FingerPrint, FilePair*>  exLeftOnlyById_;
     std::unordered_map<AFS::FingerPrint, FilePair*> exRightOnlyById_;
@@ -551,6 +705,11 @@ private:
     std::unordered_map<const InSyncFile*, FilePair*>  exLeftOnlyByPath_;
     std::unordered_map<const InSyncFile*, FilePair*> exRightOnlyByPath_;
 
+    std::unordered_map<uint64_t /*file size*/, std::vector<FilePair*>>  exLeftOnlyBySize_; //files without file print
+    std::unordered_map<uint64_t /*file size*/, std::vector<FilePair*>> exRightOnlyBySize_; //
+
+    std::unordered_map<const FilePair*, uint64_t> contentSamples_; //read on demand: see getAssocFilePairBySample()
+
     /*  Detect Renamed Files:
 
          X  ->  |_|      Create right
@@ -565,9 +724,13 @@ private:
               |  (file ID, size, date)                   |  (file ID, size, date)
               |            or                            |            or
               |  (file path, size, date)                 |  (file path, size, date)
+              |            or                            |            or
+              |  (size, date, content sample) if no ID   |  (size, date, content sample) if no ID
              \|/                                        \|/
         file left only                             file right only
 
+        (size, date, content sample) match: content is compared before moving => fall back to delete + copy if different
+
        FAT caveat: file IDs are generally not stable when file is either moved or renamed!
          1. Move/rename operations on FAT cannot be detected reliably.
          2. database generally contains wrong file ID on FAT after renaming from .ffs_tmp files => correct file IDs in database only after next sync
@@ -579,30 +742,35 @@ private:
 class SetSyncDirViaChanges
 {
 public:
-    static void execute(BaseFolderPair& baseFolder, const InSyncFolder& dbFolder, const DirectionByChange& dirs)
-    { SetSyncDirViaChanges(baseFolder, dbFolder, dirs); }
+    //-> considering filter not relevant:
+    //  if stricter filter than last time: all ok;
+    //  if less strict filter (if file ex on both sides -> conflict, fine; if file ex. on one side: copy to other side: fine)
+    static std::vector<std::function<void()>> getTasks(BaseFolderPair& baseFolder, const InSyncFolder& dbFolder, const DirectionByChange& dirs)
+    { return getSubtreeTasks(std::shared_ptr<const SetSyncDirViaChanges>(new SetSyncDirViaChanges(baseFolder, dirs)), baseFolder, &dbFolder); }
 
 private:
-    SetSyncDirViaChanges(BaseFolderPair& baseFolder, const InSyncFolder& dbFolder, const DirectionByChange& dirs) :
+    SetSyncDirViaChanges(const BaseFolderPair& baseFolder, const DirectionByChange& dirs) :
         dirs_(dirs),
         cmpVar_                (baseFolder.getCompVariant()),
         fileTimeTolerance_     (baseFolder.getFileTimeTolerance()),
-        ignoreTimeShiftMinutes_(baseFolder.getIgnoredTimeShift())
+        ignoreTimeShiftMinutes_(baseFolder.getIgnoredTimeShift()) {}
+
+    using Context = const InSyncFolder*; //database entry of current folder (optional)
+    template <class Setter> friend std::vector<std::function<void()>> getSubtreeTasks(const std::shared_ptr<const Setter>& setter, ContainerObject& baseObj, const typename Setter::Context& baseCtx);
+
+    void recurse(ContainerObject& conObj, const InSyncFolder* dbFolder) const
     {
-        //-> considering filter not relevant:
-        //  if stricter filter than last time: all ok;
-        //  if less strict filter (if file ex on both sides -> conflict, fine; if file ex. on one side: copy to other side: fine)
-        recurse(baseFolder, &dbFolder);
+        processShallow(conObj, dbFolder);
+        for (FolderPair& folder : conObj.subfolders())
+            processDir(folder, dbFolder);
     }
 
-    void recurse(ContainerObject& conObj, const InSyncFolder* dbFolder) const
+    void processShallow(ContainerObject& conObj, const InSyncFolder* dbFolder) const
     {
         for (FilePair& file : conObj.files())
             processFile(file, dbFolder);
         for (SymlinkPair& symlink : conObj.symlinks())
             processSymlink(symlink, dbFolder);
-        for (FolderPair& folder : conObj.subfolders())
-            processDir(folder, dbFolder);
     }
 
     void processFile(FilePair& file, const InSyncFolder* dbFolder) const
@@ -688,14 +856,26 @@ private:
     }
 
     void processDir(FolderPair& folder, const InSyncFolder* dbFolder) const
+    {
+        if (const std::optional<Context> dbEntry = processFolderSelf(folder, dbFolder))
+            recurse(folder, *dbEntry);
+    }
+
+    std::optional<Context> processFolderSelf(FolderPair& folder, const InSyncFolder* dbFolder) const //returns none if child items were handled already
     {
         const CompareDirResult cat = folder.getDirCategory();
 
         //########### schedule abandoned temporary recycle bin directory for deletion  ##########
         if (cat == DIR_LEFT_ONLY && endsWith(folder.getItemName<SelectSide::left>(), AFS::TEMP_FILE_ENDING))
-            return setSyncDirectionRec(SyncDirection::left, folder); //
+        {
+            setSyncDirectionRec(SyncDirection::left, folder); //
+            return {};
+        }
         else if (cat == DIR_RIGHT_ONLY && endsWith(folder.getItemName<SelectSide::right>(), AFS::TEMP_FILE_ENDING))
-            return setSyncDirectionRec(SyncDirection::right, folder); //don't recurse below!
+        {
+            setSyncDirectionRec(SyncDirection::right, folder); //don't recurse below!
+            return {};
+        }
         //#######################################################################################
 
         //try to find corresponding database entry
@@ -721,7 +901,8 @@ private:
                 if (fsObj.getCategory() != FILE_EQUAL)
                     fsObj.setSyncDirConflict(txtDbAmbiguous_);
             };
-            return visitFSObjectRecursively(static_cast<FileSystemObject&>(folder), onFsItem, onFsItem, onFsItem);
+            visitFSObjectRecursively(static_cast<FileSystemObject&>(folder), onFsItem, onFsItem, onFsItem);
+            return {};
         }
         const InSyncFolder* dbEntry = dbEntryL ? dbEntryL : dbEntryR; //exactly one side nullptr? => change in upper/lower case!
 
@@ -742,8 +923,7 @@ private:
                 setSyncDirForChange(folder, changeL, changeR);
             }
         }
-
-        recurse(folder, dbEntry);
+        return dbEntry;
     }
 
     template <SelectSide side>
@@ -828,75 +1008,107 @@ std::vector<std::pair<BaseFolderPair*, SyncDirectionConfig>> fff::extractDirecti
 
 
 void fff::redetermineSyncDirection(const std::vector<std::pair<BaseFolderPair*, SyncDirectionConfig>>& directCfgs,
+                                   const std::map<AfsDevice, size_t>& deviceParallelOps,
+                                   PhaseCallback& callback /*throw X*/) //throw X
+{
+    LastSyncStateBuffer lastSyncStateBuf;
+    redetermineSyncDirection(directCfgs, lastSyncStateBuf, deviceParallelOps, callback); //throw X
+}
+
+
+void fff::redetermineSyncDirection(const std::vector<std::pair<BaseFolderPair*, SyncDirectionConfig>>& directCfgs,
+                                   LastSyncStateBuffer& lastSyncStateBuf,
+                                   const std::map<AfsDevice, size_t>& deviceParallelOps,
                                    PhaseCallback& callback /*throw X*/) //throw X
 {
     if (directCfgs.empty())
         return;
 
     std::unordered_set<const BaseFolderPair*> pairsToSkip;
-    std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> lastSyncStates;
+    std::vector<const BaseFolderPair*> baseFoldersForDbLoad;
+    for (const auto& [baseFolder, dirCfg] : directCfgs)
+        if (std::get_if<DirectionByChange>(&dirCfg.dirs))
+        {
+            if (allItemsCategoryEqual(*baseFolder)) //nothing to do: don't even try to open DB files
+                pairsToSkip.insert(baseFolder);
+            else
+                baseFoldersForDbLoad.push_back(baseFolder);
+        }
 
     //best effort: always set sync directions (even on DB load error and when user cancels during file loading)
-    ZEN_ON_SCOPE_EXIT
-    (
-        //*INDENT-OFF*
-        for (const auto& [baseFolder, dirCfg] : directCfgs)
-            if (!pairsToSkip.contains(baseFolder))
+    //=> not from a scope guard: thread groups are created and joined below, no business running inside a destructor
+    std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> lastSyncStates;
+    std::exception_ptr loadError;
+    try
+    {
+        //(try to) load sync-database files
+        lastSyncStates = lastSyncStateBuf.load(baseFoldersForDbLoad, deviceParallelOps,
+                                               callback /*throw X*/); //throw X
+
+        callback.updateStatus(_("Calculating sync directions...")); //throw X
+        callback.requestUiUpdate(true /*force*/); //throw X
+    }
+    catch (...) { loadError = std::current_exception(); }
+
+    //folder pairs are independent => calculate in parallel
+    //1. detect moved files (*before* setting sync directions: might combine moved files into single file pairs, which changes category!)
+    //   => needs complete base folder hierarchy: one task per folder pair
+    std::vector<std::function<void()>> moveTasks;
+    //2. set sync directions: one task per subtree for large hierarchies => split *after* move detection, see getSubtreeTasks()
+    std::vector<std::function<std::vector<std::function<void()>>()>> getDirTasks;
+
+    //*INDENT-OFF*
+    for (const auto& [baseFolder, dirCfg] : directCfgs)
+        if (!pairsToSkip.contains(baseFolder))
+        {
+            //if only one folder is selected instead of a pair, sync directions don't make sense: (user already received warning during comparison)
+            if (AFS::isNullPath(baseFolder->getAbstractPath<SelectSide::left >()) ||
+                AFS::isNullPath(baseFolder->getAbstractPath<SelectSide::right>()))
+            {
+                getDirTasks.push_back([baseFolder]
+                {
+                    return SetSyncDirViaDifferences::getTasks({.leftOnly   = SyncDirection::none,
+                                                               .rightOnly  = SyncDirection::none,
+                                                               .leftNewer  = SyncDirection::none,
+                                                               .rightNewer = SyncDirection::none}, *baseFolder);
+                });
+            }
+            else if (const DirectionByDiff* diffDirs = std::get_if<DirectionByDiff>(&dirCfg.dirs))
+                getDirTasks.push_back([baseFolder, diffDirs] { return SetSyncDirViaDifferences::getTasks(*diffDirs, *baseFolder); });
+            else
             {
-                //if only one folder is selected instead of a pair, sync directions don't make sense: (user already received warning during comparison)
-                if (AFS::isNullPath(baseFolder->getAbstractPath<SelectSide::left >()) ||
-                    AFS::isNullPath(baseFolder->getAbstractPath<SelectSide::right>()))
+                const DirectionByChange& changeDirs = std::get<DirectionByChange>(dirCfg.dirs);
+
+                auto it = lastSyncStates.find(baseFolder);
+                if (const InSyncFolder* lastSyncState = it != lastSyncStates.end() ? &it->second.ref() : nullptr)
                 {
-                    SetSyncDirViaDifferences::execute({.leftOnly   = SyncDirection::none,
-                                                       .rightOnly  = SyncDirection::none,
-                                                       .leftNewer  = SyncDirection::none,
-                                                       .rightNewer = SyncDirection::none}, *baseFolder);
+                    moveTasks  .push_back([baseFolder, lastSyncState] { DetectMovedFiles::execute(*baseFolder, *lastSyncState); });
+                    getDirTasks.push_back([baseFolder, lastSyncState, &changeDirs] { return SetSyncDirViaChanges::getTasks(*baseFolder, *lastSyncState, changeDirs); });
                 }
-                else if (const DirectionByDiff* diffDirs = std::get_if<DirectionByDiff>(&dirCfg.dirs))
-                    SetSyncDirViaDifferences::execute(*diffDirs, *baseFolder);
-                else
+                else //fallback:
                 {
-                    const DirectionByChange& changeDirs = std::get<DirectionByChange>(dirCfg.dirs);
-
-                    auto it = lastSyncStates.find(baseFolder);
-                    if (const InSyncFolder* lastSyncState = it != lastSyncStates.end() ? &it->second.ref() : nullptr)
-                    {
-                        //detect moved files (*before* setting sync directions: might combine moved files into single file pairs, which changes category!)
-                        DetectMovedFiles::execute(*baseFolder, *lastSyncState);                
+                    std::wstring msg = _("Database file is not available: Setting default directions for synchronization.");
+                    if (directCfgs.size() > 1)
+                        msg += SPACED_DASH + getShortDisplayNameForFolderPair(baseFolder->getAbstractPath<SelectSide::left >(),
+                                                                              baseFolder->getAbstractPath<SelectSide::right>());
+                    try { callback.logMessage(msg, PhaseCallback::MsgType::warning); /*throw X*/} catch (...) {};
 
-                        SetSyncDirViaChanges::execute(*baseFolder, *lastSyncState, changeDirs);
-                    }
-                    else //fallback:
-                    {
-                        std::wstring msg = _("Database file is not available: Setting default directions for synchronization.");
-                        if (directCfgs.size() > 1)
-                            msg += SPACED_DASH + getShortDisplayNameForFolderPair(baseFolder->getAbstractPath<SelectSide::left >(),
-                                                                                  baseFolder->getAbstractPath<SelectSide::right>());                        
-                        try { callback.logMessage(msg, PhaseCallback::MsgType::warning); /*throw X*/} catch (...) {};
-
-                        SetSyncDirViaDifferences::execute(getDiffDirDefault(changeDirs), *baseFolder);
-                    }
+                    getDirTasks.push_back([baseFolder, &changeDirs] { return SetSyncDirViaDifferences::getTasks(getDiffDirDefault(changeDirs), *baseFolder); });
                 }
             }
-        //*INDENT-ON*
-    );
-
-    std::vector<const BaseFolderPair*> baseFoldersForDbLoad;
-    for (const auto& [baseFolder, dirCfg] : directCfgs)
-        if (std::get_if<DirectionByChange>(&dirCfg.dirs))
-        {
-            if (allItemsCategoryEqual(*baseFolder)) //nothing to do: don't even try to open DB files
-                pairsToSkip.insert(baseFolder);
-            else
-                baseFoldersForDbLoad.push_back(baseFolder);
         }
+    //*INDENT-ON*
+
+    runTasks(moveTasks, Zstr("Detect Moved Files"));
+
+    std::vector<std::function<void()>> dirTasks;
+    for (const auto& getTasks : getDirTasks)
+        append(dirTasks, getTasks()); //main thread: see getSubtreeTasks()
 
-    //(try to) load sync-database files
-    lastSyncStates = loadLastSynchronousState(baseFoldersForDbLoad,
-                                              callback /*throw X*/); //throw X
+    runTasks(dirTasks, Zstr("Sync Directions"));
 
-    callback.updateStatus(_("Calculating sync directions...")); //throw X
-    callback.requestUiUpdate(true /*force*/); //throw X
+    if (loadError)
+        std::rethrow_exception(loadError); //throw X
 }
 
 //---------------------------------------------------------------------------------------------------------------
@@ -1332,7 +1544,7 @@ void copyToAlternateFolderFrom(const std::vector<const FileSystemObject*>& rowsT
                 {
                     percentReporter.updateDeltaAndStatus(bytesDelta); //throw X
                     callback.requestUiUpdate(); //throw X  => not reliably covered by PercentStatReporter::updateDeltaAndStatus()! e.g. during first few seconds: STATUS_PERCENT_DELAY!
-                });
+                }, nullptr /*notifySourceData*/);
 
                 if (result.errorModTime) //log only; no popup
                     callback.logMessage(result.errorModTime->toString(), PhaseCallback::MsgType::warning);
@@ -1875,7 +2087,7 @@ void TempFileBuffer::createTempFiles(const std::set<FileDescriptor>& workLoad, P
             {
                 percentReporter.updateDeltaAndStatus(bytesDelta); //throw X
                 callback.requestUiUpdate(); //throw X  => not reliably covered by PercentStatReporter::updateDeltaAndStatus()! e.g. during first few seconds: STATUS_PERCENT_DELAY!
-            });
+            }, nullptr /*notifySourceData*/);
             //result.errorModTime? => irrelevant for temp files!
             statReporter.reportDelta(1, 0);
 
@@ -11,6 +11,7 @@
 #include "file_hierarchy.h"
 #include "soft_filter.h"
 #include "process_callback.h"
+#include "db_file.h"
 
 
 namespace fff
@@ -21,6 +22,13 @@ void swapGrids(const MainConfiguration& mainCfg, FolderComparison& folderCmp,
 std::vector<std::pair<BaseFolderPair*, SyncDirectionConfig>> extractDirectionCfg(FolderComparison& folderCmp, const MainConfiguration& mainCfg);
 
 void redetermineSyncDirection(const std::vector<std::pair<BaseFolderPair*, SyncDirectionConfig>>& directCfgs,
+                              const std::map<AfsDevice, size_t>& deviceParallelOps,
+                              PhaseCallback& callback /*throw X*/); //throw X
+
+//reuse sync.ffs_db already loaded during comparison:
+void redetermineSyncDirection(const std::vector<std::pair<BaseFolderPair*, SyncDirectionConfig>>& directCfgs,
+                              LastSyncStateBuffer& lastSyncStateBuf,
+                              const std::map<AfsDevice, size_t>& deviceParallelOps,
                               PhaseCallback& callback /*throw X*/); //throw X
 
 void setSyncDirectionRec(SyncDirection newDirection, FileSystemObject& fsObj); //set new direction (recursively)
@@ -0,0 +1,94 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#ifndef ASYNC_ERROR_POLICY_H_8347289034752398
+#define ASYNC_ERROR_POLICY_H_8347289034752398
+
+#include <functional>
+#include <zen/format_unit.h>
+#include <zen/i18n.h>
+#include <zen/thread.h>
+#include "process_callback.h"
+
+
+namespace fff
+{
+//apply PhaseCallback::getErrorPolicy() directly on worker threads: no round trip to main thread
+//=> errors are queued for logging only: worker threads don't wait until main thread is ready
+class AsyncErrorPolicy
+{
+public:
+    explicit AsyncErrorPolicy(const PhaseCallback& cb) : policy_(cb.getErrorPolicy()) {}
+
+    //context of main thread: user may change "ignore errors" while running
+    void refresh(const PhaseCallback& cb)
+    {
+        assert(zen::runningOnMainThread());
+        std::optional<PhaseCallback::ErrorPolicy> policy = cb.getErrorPolicy();
+
+        std::lock_guard dummy(lockPolicy_);
+        policy_ = policy;
+    }
+
+    //context of worker thread: std::nullopt if main thread needs to decide
+    std::optional<PhaseCallback::Response> tryHandleError(const PhaseCallback::ErrorInfo& errorInfo,
+                                                          const std::function<void(std::wstring&& msg)>& notifyStatus /*throw ThreadStopRequest*/) //throw ThreadStopRequest
+    {
+        assert(!zen::runningOnMainThread());
+        std::optional<PhaseCallback::ErrorPolicy> policy;
+        {
+            std::lock_guard dummy(lockPolicy_);
+            policy = policy_;
+        }
+        if (!policy)
+            return std::nullopt;
+
+        if (errorInfo.retryNumber < policy->autoRetryCount)
+        {
+            queueLogMessage(errorInfo.msg + L"\n-> " + _("Automatic retry"), PhaseCallback::MsgType::info);
+
+            notifyStatus(_("Automatic retry") + (errorInfo.retryNumber == 0 ? L"" : L' ' + zen::formatNumber(errorInfo.retryNumber + 1)) +
+                         SPACED_DASH + _("Error") + L": " + zen::replaceCpy(errorInfo.msg, L'\n', L' ')); //throw ThreadStopRequest
+
+            const std::chrono::nanoseconds delay = errorInfo.failTime + policy->autoRetryDelay - std::chrono::steady_clock::now();
+            if (delay > std::chrono::nanoseconds(0))
+                zen::interruptibleSleep(delay); //throw ThreadStopRequest
+            return PhaseCallback::retry;
+        }
+
+        queueLogMessage(errorInfo.msg, PhaseCallback::MsgType::error);
+        return PhaseCallback::ignore;
+    }
+
+    //context of main thread, call repeatedly
+    void flushLog(PhaseCallback& cb) //throw X
+    {
+        assert(zen::runningOnMainThread());
+        std::vector<std::pair<std::wstring, PhaseCallback::MsgType>> logQueue;
+        {
+            std::lock_guard dummy(lockLog_);
+            logQueue.swap(logQueue_);
+        }
+        for (const auto& [msg, type] : logQueue)
+            cb.logMessage(msg, type); //throw X
+    }
+
+private:
+    void queueLogMessage(const std::wstring& msg, PhaseCallback::MsgType type)
+    {
+        std::lock_guard dummy(lockLog_); //short-lived: never held while calling back
+        logQueue_.emplace_back(msg, type);
+    }
+
+    std::mutex lockPolicy_;
+    std::optional<PhaseCallback::ErrorPolicy> policy_;
+
+    std::mutex lockLog_; //different lock than AsyncCallback::lockRequest_ which is held during main thread callbacks
+    std::vector<std::pair<std::wstring, PhaseCallback::MsgType>> logQueue_;
+};
+}
+
+#endif //ASYNC_ERROR_POLICY_H_8347289034752398
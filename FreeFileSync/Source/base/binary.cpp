@@ -5,22 +5,100 @@
 // *****************************************************************************
 
 #include "binary.h"
+#include <zen/file_io.h>
+#include <zen/open_ssl.h>
+#include "../afs/native.h"
 
 using namespace zen;
 using namespace fff;
 using AFS = AbstractFileSystem;
 
 
-bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath& filePath2, const IoCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, X
+namespace
+{
+/*  sampling pre-pass for large local files: compare a few blocks spread over the file *before* the full sequential comparison
+    => find differences near the end (e.g. media files with trailing metadata: ID3v1, MP4 "moov" atom) without reading everything else first
+    - native files only: for (S)FTP, Google Drive, MTP random access means a new request or even a new connection
+    - small files are excluded by the caller-known file size before opening anything
+    - the file handles are reused for the sequential comparison: pread() does not change the file position
+    - sample I/O is not reported as progress: it's a small bounded overhead, and most of it is page-cache-hot for the sequential pass
+
+    memcmp() itself is not the bottleneck: glibc already dispatches to SSE2/AVX2/EVEX variants at runtime          */
+constexpr uint64_t SAMPLING_MIN_FILE_SIZE = 64 * 1024 * 1024;
+constexpr uint64_t SAMPLING_BLOCK_COUNT = 8; //including last block; excluding first block: read first by the sequential pass anyway
+
+
+size_t readFullyAt(FileInputPlain& fileIn, std::byte* buffer, size_t bytesToRead, uint64_t offset) //throw FileError
+{
+    size_t bytesRead = 0;
+    while (bytesRead < bytesToRead)
+    {
+        const size_t bytesReadNow = fileIn.tryReadAt(buffer + bytesRead, bytesToRead - bytesRead, offset + bytesRead); //throw FileError; may return short; only 0 means EOF
+        if (bytesReadNow == 0) //end of file
+            break;
+        bytesRead += bytesReadNow;
+    }
+    return bytesRead;
+}
+
+
+bool sampledContentDiffers(FileInputPlain& fileIn1, FileInputPlain& fileIn2) //throw FileError
+{
+    const uint64_t fileSize = makeUnsigned(fileIn1.getStatBuffered().st_size); //throw FileError
+    if (fileSize < SAMPLING_MIN_FILE_SIZE ||
+        makeUnsigned(fileIn2.getStatBuffered().st_size) != fileSize) //changed since comparison? => leave details to the sequential comparison
+        return false;
+
+    const size_t blockSize = std::max(fileIn1.getBlockSize(), fileIn2.getBlockSize()); //throw FileError
+    assert(blockSize < SAMPLING_MIN_FILE_SIZE / SAMPLING_BLOCK_COUNT);
+
+    const std::unique_ptr<std::byte[]> buf(new std::byte[2 * blockSize]);
+    std::byte* const buf1 = buf.get();
+    std::byte* const buf2 = buf.get() + blockSize;
+
+    for (uint64_t i = SAMPLING_BLOCK_COUNT; i >= 1; --i) //start with the last block
+    {
+        const uint64_t offset = (fileSize - blockSize) * i / SAMPLING_BLOCK_COUNT; //i == SAMPLING_BLOCK_COUNT => last block
+
+        const size_t bytesRead1 = readFullyAt(fileIn1, buf1, blockSize, offset); //throw FileError
+        const size_t bytesRead2 = readFullyAt(fileIn2, buf2, blockSize, offset); //
+
+        if (bytesRead1 != bytesRead2 || //file size changed meanwhile?
+            std::memcmp(buf1, buf2, bytesRead1) != 0)
+            return true;
+    }
+    return false;
+}
+
+
+//continue with the handles opened for sampling: same behavior as InputStreamNative (afs/native.cpp)
+struct InputStreamPlain : public AFS::InputStream
+{
+    explicit InputStreamPlain(FileInputPlain& fileIn) : fileIn_(fileIn) {}
+
+    size_t getBlockSize() override { return fileIn_.getBlockSize(); } //throw FileError
+
+    size_t tryRead(void* buffer, size_t bytesToRead, const IoCallback& notifyUnbufferedIO /*throw X*/) override //throw FileError, ErrorFileLocked, X
+    {
+        const size_t bytesRead = fileIn_.tryRead(buffer, bytesToRead); //throw FileError, ErrorFileLocked
+        if (notifyUnbufferedIO) notifyUnbufferedIO(bytesRead); //throw X
+        return bytesRead;
+    }
+
+    std::optional<AFS::StreamAttributes> tryGetAttributesFast() override { return {}; } //not needed for comparison
+
+private:
+    FileInputPlain& fileIn_;
+};
+
+
+bool streamsHaveSameContent(AFS::InputStream& stream1, AFS::InputStream& stream2, const IoCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, X
 {
     int64_t totalBytesNotified = 0;
     IoCallback /*[!] as expected by InputStream::tryRead()*/ notifyIoDiv = IOCallbackDivider(notifyUnbufferedIO, totalBytesNotified);
 
-    const std::unique_ptr<AFS::InputStream> stream1 = AFS::getInputStream(filePath1); //throw FileError
-    const std::unique_ptr<AFS::InputStream> stream2 = AFS::getInputStream(filePath2); //
-
-    const size_t blockSize1 = stream1->getBlockSize(); //throw FileError
-    const size_t blockSize2 = stream2->getBlockSize(); //
+    const size_t blockSize1 = stream1.getBlockSize(); //throw FileError
+    const size_t blockSize2 = stream2.getBlockSize(); //
 
     const size_t bufCapacity = blockSize2 - 1 + blockSize1 + blockSize2;
 
@@ -32,14 +110,14 @@ bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath
     size_t buf1PosEnd = 0;
     for (;;)
     {
-        const size_t bytesRead1 = stream1->tryRead(buf1 + buf1PosEnd, blockSize1, notifyIoDiv); //throw FileError, X; may return short; only 0 means EOF
+        const size_t bytesRead1 = stream1.tryRead(buf1 + buf1PosEnd, blockSize1, notifyIoDiv); //throw FileError, X; may return short; only 0 means EOF
 
         if (bytesRead1 == 0) //end of file
         {
             size_t buf1Pos = 0;
             while (buf1Pos < buf1PosEnd)
             {
-                const size_t bytesRead2 = stream2->tryRead(buf2, blockSize2, notifyIoDiv); //throw FileError, X; may return short; only 0 means EOF
+                const size_t bytesRead2 = stream2.tryRead(buf2, blockSize2, notifyIoDiv); //throw FileError, X; may return short; only 0 means EOF
 
                 if (bytesRead2 == 0 ||//end of file
                     bytesRead2 > buf1PosEnd - buf1Pos)
@@ -50,7 +128,7 @@ bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath
 
                 buf1Pos += bytesRead2;
             }
-            return stream2->tryRead(buf2, blockSize2, notifyIoDiv) == 0; //throw FileError, X; expect EOF
+            return stream2.tryRead(buf2, blockSize2, notifyIoDiv) == 0; //throw FileError, X; expect EOF
         }
         else
         {
@@ -59,7 +137,7 @@ bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath
             size_t buf1Pos = 0;
             while (buf1PosEnd - buf1Pos >= blockSize2)
             {
-                const size_t bytesRead2 = stream2->tryRead(buf2, blockSize2, notifyIoDiv); //throw FileError, X; may return short; only 0 means EOF
+                const size_t bytesRead2 = stream2.tryRead(buf2, blockSize2, notifyIoDiv); //throw FileError, X; may return short; only 0 means EOF
 
                 if (bytesRead2 == 0) //end of file
                     return false;
@@ -77,3 +155,93 @@ bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath
         }
     }
 }
+}
+
+
+bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath& filePath2, uint64_t fileSize, const IoCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, X
+{
+    if (fileSize >= SAMPLING_MIN_FILE_SIZE)
+        if (const Zstring& nativePath1 = getNativeItemPath(filePath1); !nativePath1.empty())
+            if (const Zstring& nativePath2 = getNativeItemPath(filePath2); !nativePath2.empty())
+            {
+                FileInputPlain fileIn1(nativePath1); //throw FileError, ErrorFileLocked
+                FileInputPlain fileIn2(nativePath2); //
+
+                if (sampledContentDiffers(fileIn1, fileIn2)) //throw FileError
+                    return false;
+
+                InputStreamPlain stream1(fileIn1);
+                InputStreamPlain stream2(fileIn2);
+                return streamsHaveSameContent(stream1, stream2, notifyUnbufferedIO); //throw FileError, X
+            }
+
+    const std::unique_ptr<AFS::InputStream> stream1 = AFS::getInputStream(filePath1); //throw FileError
+    const std::unique_ptr<AFS::InputStream> stream2 = AFS::getInputStream(filePath2); //
+
+    return streamsHaveSameContent(*stream1, *stream2, notifyUnbufferedIO); //throw FileError, X
+}
+
+
+std::string fff::getFileContentMd5(const AbstractPath& filePath, const IoCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, X
+{
+    if (std::optional<std::string> md5 = AFS::tryGetFileMd5Fast(filePath)) //throw FileError
+        return std::move(*md5);
+
+    try
+    {
+        Md5Stream md5Stream; //throw SysError
+
+        const std::unique_ptr<AFS::InputStream> streamIn = AFS::getInputStream(filePath); //throw FileError
+        const size_t blockSize = streamIn->getBlockSize(); //throw FileError
+        const std::unique_ptr<std::byte[]> buf(new std::byte[blockSize]);
+
+        while (const size_t bytesRead = streamIn->tryRead(buf.get(), blockSize, notifyUnbufferedIO)) //throw FileError, X; may return short; only 0 means EOF
+            md5Stream.update(buf.get(), bytesRead);
+
+        return md5Stream.finalize(); //throw SysError
+    }
+    catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(AFS::getDisplayPath(filePath))), e.toString()); }
+}
+
+
+void ContentSampleStream::update(const void* buffer, size_t bytes)
+{
+    const size_t sampleBytes = std::min<uint64_t>(fileSize_, CONTENT_SAMPLE_SIZE);
+    if (bytesSeen_ < sampleBytes)
+    {
+        const size_t bytesNew = std::min(bytes, sampleBytes - bytesSeen_);
+        hashStream_.update(buffer, bytesNew);
+        bytesSeen_ += bytesNew;
+    }
+}
+
+
+uint64_t ContentSampleStream::finalize() const
+{
+    if (fileSize_ == 0 || bytesSeen_ != std::min<uint64_t>(fileSize_, CONTENT_SAMPLE_SIZE))
+        return 0;
+
+    return std::max<uint64_t>(hashStream_.finalize(), 1); //0 is reserved for "unknown"
+}
+
+
+uint64_t fff::getContentSample(const AbstractPath& filePath, uint64_t fileSize) //throw FileError
+{
+    if (fileSize == 0)
+        return 0;
+
+    ContentSampleStream sampleStream(fileSize);
+    const std::unique_ptr<AFS::InputStream> streamIn = AFS::getInputStream(filePath); //throw FileError
+    const size_t blockSize = streamIn->getBlockSize(); //throw FileError
+    const std::unique_ptr<std::byte[]> buf(new std::byte[blockSize]);
+
+    for (size_t bytesTotal = 0; bytesTotal < CONTENT_SAMPLE_SIZE;)
+    {
+        const size_t bytesRead = streamIn->tryRead(buf.get(), blockSize, nullptr /*notifyUnbufferedIO*/); //throw FileError; may return short; only 0 means EOF
+        if (bytesRead == 0) //end of file
+            break;
+        sampleStream.update(buf.get(), bytesRead);
+        bytesTotal += bytesRead;
+    }
+    return sampleStream.finalize(); //file size changed meanwhile? => 0: no match
+}
@@ -7,6 +7,7 @@
 #ifndef BINARY_H_3941281398513241134
 #define BINARY_H_3941281398513241134
 
+#include <zen/crc.h>
 #include "../afs/abstract.h"
 
 
@@ -14,7 +15,36 @@ namespace fff
 {
 bool filesHaveSameContent(const AbstractPath& filePath1,
                           const AbstractPath& filePath2,
+                          uint64_t fileSize, //expected for both files: large local files are sampled first
                           const zen::IoCallback& notifyUnbufferedIO  /*throw X*/); //throw FileError, X
+
+//read full file content (unless server reports MD5 for free, e.g. Google Drive); raw bytes (see zen::Md5Stream)
+std::string getFileContentMd5(const AbstractPath& filePath,
+                              const zen::IoCallback& notifyUnbufferedIO /*throw X*/); //throw FileError, X
+
+
+/*  content sample: hash of file size and the first CONTENT_SAMPLE_SIZE bytes
+    - find moved files on devices without file IDs (SFTP, FTP): stored in sync.ffs_db, see DetectMovedFiles
+    - reading the head of a file is a single request even for (S)FTP: no random access needed
+    - 0 means "unknown" (e.g. empty file)                                                              */
+constexpr size_t CONTENT_SAMPLE_SIZE = 64 * 1024;
+
+uint64_t getContentSample(const AbstractPath& filePath, uint64_t fileSize); //throw FileError
+
+//collect content sample from data arriving in blocks, e.g. during file copy
+class ContentSampleStream
+{
+public:
+    explicit ContentSampleStream(uint64_t fileSize) : fileSize_(fileSize), hashStream_(fileSize /*seed*/) {}
+
+    void update(const void* buffer, size_t bytes);
+    uint64_t finalize() const; //0 if not all sample bytes were seen (e.g. server-side copy)
+
+private:
+    const uint64_t fileSize_;
+    zen::Xxh64Stream hashStream_;
+    size_t bytesSeen_ = 0;
+};
 }
 
 #endif //BINARY_H_3941281398513241134
@@ -8,6 +8,7 @@
 #include <zen/perf.h>
 #include <zen/process_priority.h>
 #include <zen/time.h>
+#include <zen/symlink_target.h>
 #include "algorithm.h"
 #include "parallel_scan.h"
 #include "dir_exist_async.h"
@@ -183,14 +184,193 @@ ResolvedBaseFolders initializeBaseFolders(const std::vector<FolderPairCfg>& fpCf
 
 //#############################################################################################################################
 
+//restrict folder traversal to items from a change list (e.g. reported by RealTimeSync) + their parent folders
+class ChangedItemsFilter : public PathFilter
+{
+public:
+    ChangedItemsFilter(const FilterRef& filter, const FilterRef& changedItems) : filter_(filter), changedItems_(changedItems) {}
+
+    bool passFileFilter(const Zstring& relFilePath) const override
+    {
+        return filter_      .ref().passFileFilter(relFilePath) && //short-circuit behavior
+               changedItems_.ref().passFileFilter(relFilePath);
+    }
+
+    bool passDirFilter(const Zstring& relDirPath, bool* childItemMightMatch) const override //same as CombinedFilter
+    {
+        if (filter_.ref().passDirFilter(relDirPath, childItemMightMatch))
+            return changedItems_.ref().passDirFilter(relDirPath, childItemMightMatch);
+        else
+        {
+            if (childItemMightMatch && *childItemMightMatch)
+                changedItems_.ref().passDirFilter(relDirPath, childItemMightMatch);
+            return false;
+        }
+    }
+
+    bool isNull() const override { return false; }
+
+    FilterRef copyFilterAddingExclusion(const Zstring& excludePhrase) const override
+    {
+        return makeSharedRef<ChangedItemsFilter>(filter_.ref().copyFilterAddingExclusion(excludePhrase), changedItems_);
+    }
+
+private:
+    std::strong_ordering compareSameType(const PathFilter& other) const override
+    {
+        assert(typeid(*this) == typeid(other)); //always given in this context!
+        const ChangedItemsFilter& rhs = static_cast<const ChangedItemsFilter&>(other);
+
+        if (const std::strong_ordering cmp = filter_ <=> rhs.filter_;
+            cmp != std::strong_ordering::equal)
+            return cmp;
+
+        return changedItems_ <=> rhs.changedItems_;
+    }
+
+    const FilterRef filter_;
+    const FilterRef changedItems_;
+};
+
+
+//native base folder path + symlink-resolved path (RealTimeSync may report either, e.g. fanotify reports final paths)
+//native path + symlink-resolved path (if different): last element
+std::vector<Zstring> getNativeAliases(const Zstring& nativePath)
+{
+    std::vector<Zstring> aliases{nativePath};
+    try
+    {
+        if (const Zstring resolvedPath = getSymlinkResolvedPath(nativePath); //throw FileError
+            resolvedPath != nativePath)
+            aliases.push_back(resolvedPath);
+    }
+    catch (FileError&) {} //folder existence was already checked => error will show during scan
+    return aliases;
+}
+
+
+std::vector<Zstring> getNativeFolderAliases(const AbstractPath& folderPath)
+{
+    if (const Zstring& nativePath = getNativeItemPath(folderPath);
+        !nativePath.empty())
+        return getNativeAliases(nativePath);
+    return {};
+}
+
+
+bool isItemOrParentOf(const Zstring& itemPath, const Zstring& folderPath)
+{
+    return itemPath == folderPath || startsWith(appendSeparator(folderPath), appendSeparator(itemPath));
+}
+
+
+bool isChildOf(const Zstring& itemPath, const Zstring& folderPath)
+{
+    return startsWith(itemPath, appendSeparator(folderPath));
+}
+
+
+//return filter phrase for changed items below base folders, or none if a full scan is required
+//items not below the base folders are ignored: caller must ensure each item is covered by *some* folder pair!
+std::optional<Zstring> getChangedItemsPhrase(const std::vector<Zstring>& folderAliases /*both sides*/, const std::vector<Zstring>& changedItemPaths)
+{
+    //file names not expressible as filter phrase (see path_filter.cpp::parseFilterPhrase()) => scan parent folder instead
+    auto isFilterSafe = [](const Zstring& relPath)
+    {
+        return relPath == trimCpy(relPath) && !endsWith(relPath, Zstr(':')) &&
+               std::none_of(relPath.begin(), relPath.end(), [](Zchar c)
+        {
+            return c == Zstr('*') || c == Zstr('?') || c == FILTER_ITEM_SEPARATOR || c == Zstr('\n') || c == Zstr('\\');
+        });
+    };
+
+    Zstring phrase;
+    for (const Zstring& itemPath : changedItemPaths)
+        for (const Zstring& folderPath : folderAliases)
+        {
+            if (isItemOrParentOf(itemPath, folderPath)) //base folder (or parent) changed
+                return std::nullopt;
+
+            if (const Zstring folderPathPf = appendSeparator(folderPath);
+                startsWith(itemPath, folderPathPf))
+            {
+                Zstring relPath(itemPath.begin() + folderPathPf.size(), itemPath.end());
+
+                while (!relPath.empty() && !isFilterSafe(relPath))
+                    relPath = beforeLast(relPath, FILE_NAME_SEPARATOR, IfNotFoundReturn::none);
+
+                if (relPath.empty())
+                    return std::nullopt;
+
+                phrase += FILE_NAME_SEPARATOR + relPath + Zstr('\n');
+            }
+        }
+    return phrase; //empty if no changes for this folder pair
+}
+
+
+//fill in unchanged items from last synchronous state: items already in "folderCont" (changed items and their parent folders) take precedence
+template <SelectSide side>
+void addUnchangedItems(FolderContainer& folderCont, const InSyncFolder& dbFolder, const Zstring& parentRelPathPf,
+                       const PathFilter& filter, const PathFilter& changedItems)
+{
+    std::unordered_set<ZstringNorm> scannedItems;
+    for (const auto& [fileName, attr] : folderCont.files)
+        scannedItems.insert(fileName);
+    for (const auto& [linkName, attr] : folderCont.symlinks)
+        scannedItems.insert(linkName);
+
+    std::unordered_map<ZstringNorm, FolderContainer*> scannedFolders;
+    for (auto& [folderName, attrAndSub] : folderCont.folders)
+        scannedFolders.emplace(folderName, &attrAndSub.second);
+
+    for (const auto& [fileName, dbFile] : dbFolder.files)
+        if (const Zstring relPath = parentRelPathPf + fileName.normStr;
+            filter.passFileFilter(relPath) && !changedItems.passFileFilter(relPath) && !scannedItems.contains(fileName))
+        {
+            const InSyncDescrFile& descr = selectParam<side>(dbFile.left, dbFile.right);
+            folderCont.addFile(fileName.normStr, {.modTime = descr.modTime, .fileSize = dbFile.fileSize, .filePrint = descr.filePrint});
+        }
+
+    for (const auto& [linkName, dbLink] : dbFolder.symlinks)
+        if (const Zstring relPath = parentRelPathPf + linkName.normStr;
+            filter.passFileFilter(relPath) && !changedItems.passFileFilter(relPath) && !scannedItems.contains(linkName))
+            folderCont.addSymlink(linkName.normStr, {.modTime = selectParam<side>(dbLink.left, dbLink.right).modTime});
+
+    for (const auto& [folderName, dbSubFolder] : dbFolder.folders)
+    {
+        const Zstring relPath = parentRelPathPf + folderName.normStr;
+
+        bool changedChildMightMatch = true;
+        if (changedItems.passDirFilter(relPath, &changedChildMightMatch)) //complete subtree was scanned
+            continue;
+
+        bool childItemMightMatch = true;
+        if (!filter.passDirFilter(relPath, &childItemMightMatch) && !childItemMightMatch)
+            continue; //keep excluded parent folders of included items: see parallelFolderScan()
+
+        auto it = scannedFolders.find(folderName);
+        FolderContainer& subFolderCont = it != scannedFolders.end() ? *it->second : folderCont.addFolder(folderName.normStr, FolderAttributes());
+
+        addUnchangedItems<side>(subFolderCont, dbSubFolder, relPath + FILE_NAME_SEPARATOR, filter, changedItems);
+    }
+}
+
+
 class ComparisonBuffer
 {
 public:
     ComparisonBuffer(const FolderStatus& folderStatus,
                      unsigned int fileTimeTolerance,
+                     const std::map<AfsDevice, size_t>& deviceParallelOps,
+                     const std::optional<ChangeList>& changeList,
+                     LastSyncStateBuffer& lastSyncStateBuf,
                      ProcessCallback& callback) :
         fileTimeTolerance_(fileTimeTolerance),
+        deviceParallelOps_(deviceParallelOps),
         folderStatus_(folderStatus),
+        changeList_(changeList),
+        lastSyncStateBuf_(lastSyncStateBuf),
         cb_(callback) {}
 
     FolderComparison execute(const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad);
@@ -204,6 +384,16 @@ private:
     SharedRef<BaseFolderPair> compareBySize    (const ResolvedFolderPair& fp, const FolderPairCfg& fpConfig) const;
     std::vector<SharedRef<BaseFolderPair>> compareByContent(const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad) const;
 
+    struct PartialScan
+    {
+        DirectoryKey fullKey; //as expected by performComparison()
+        DirectoryKey scanKey; //restricted to changed items
+        FilterRef changedItems;
+        SelectSide side;
+        SharedRef<const InSyncFolder> lastSyncState;
+    };
+    std::vector<PartialScan> preparePartialScans(const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad) const;
+
     SharedRef<BaseFolderPair> performComparison(const ResolvedFolderPair& fp,
                                                 const FolderPairCfg& fpCfg,
                                                 std::vector<FilePair*>& undefinedFiles,
@@ -222,12 +412,139 @@ private:
     };
 
     const unsigned int fileTimeTolerance_;
+    const std::map<AfsDevice, size_t>& deviceParallelOps_;
     const FolderStatus& folderStatus_;
+    const std::optional<ChangeList>& changeList_; //optional: items changed since last sync
+    LastSyncStateBuffer& lastSyncStateBuf_; //load sync.ffs_db once per comparison: shared with redetermineSyncDirection()
     std::map<DirectoryKey, DirectoryValue> folderBuffer_; //contains entries for *all* scanned folders!
     ProcessCallback& cb_;
 };
 
 
+std::vector<ComparisonBuffer::PartialScan> ComparisonBuffer::preparePartialScans(const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad) const
+{
+    if (!changeList_)
+        return {};
+
+    //changes are complete only for watched folders: e.g. RealTimeSync monitoring one side only
+    std::vector<Zstring> watchedFolderPaths; //symlink-resolved
+    for (const Zstring& folderPath : changeList_->watchedFolderPaths)
+        watchedFolderPaths.push_back(getNativeAliases(folderPath).back());
+
+    auto isWatched = [&](const AbstractPath& folderPath)
+    {
+        const std::vector<Zstring>& aliases = getNativeFolderAliases(folderPath);
+        if (!aliases.empty())
+            for (const Zstring& watchedPath : watchedFolderPaths) //symlinks below watched folder are not followed => compare resolved paths
+                if (aliases.back() == watchedPath || isChildOf(aliases.back(), watchedPath))
+                    return true;
+        return false;
+    };
+
+    //folders read by more than one folder pair: scan completely
+    std::map<DirectoryKey, int> keyUseCount;
+    for (const auto& [folderPair, fpCfg] : workLoad)
+    {
+        ++keyUseCount[{folderPair.folderPathLeft,  fpCfg.filter.nameFilter, fpCfg.handleSymlinks}];
+        ++keyUseCount[{folderPair.folderPathRight, fpCfg.filter.nameFilter, fpCfg.handleSymlinks}];
+    }
+
+    //change lists are created by RealTimeSync => native paths only
+    std::vector<std::vector<Zstring>> folderAliasesByPair;
+    for (const auto& [folderPair, fpCfg] : workLoad)
+    {
+        std::vector<Zstring>& folderAliases = folderAliasesByPair.emplace_back(getNativeFolderAliases(folderPair.folderPathLeft));
+        append(folderAliases, getNativeFolderAliases(folderPair.folderPathRight));
+    }
+
+    //change outside of all base folders? e.g. different symlink path, or list written for another configuration => don't miss it!
+    auto isCoveredByComparison = [&](const Zstring& itemPath)
+    {
+        for (const std::vector<Zstring>& folderAliases : folderAliasesByPair)
+            for (const Zstring& folderPath : folderAliases)
+                if (isChildOf(itemPath, folderPath) || isItemOrParentOf(itemPath, folderPath))
+                    return true;
+        return false;
+    };
+    for (const Zstring& itemPath : changeList_->changedItemPaths)
+        if (!isCoveredByComparison(itemPath))
+        {
+            cb_.logMessage(replaceCpy(_("Changed item %x is not part of the comparison: Scanning all items."), L"%x", fmtPath(itemPath)), PhaseCallback::MsgType::info); //throw X
+            return {};
+        }
+
+    std::vector<SharedRef<BaseFolderPair>> dbBaseFolders; //just for loading sync.ffs_db
+    std::vector<std::pair<const FolderPairCfg*, Zstring /*changed items phrase*/>> candidates;
+
+    for (size_t i = 0; i < workLoad.size(); ++i)
+        if (const auto& [folderPair, fpCfg] = workLoad[i];
+            getBaseFolderStatus(folderPair.folderPathLeft ) == BaseFolderStatus::existing &&
+            getBaseFolderStatus(folderPair.folderPathRight) == BaseFolderStatus::existing &&
+            keyUseCount[{folderPair.folderPathLeft,  fpCfg.filter.nameFilter, fpCfg.handleSymlinks}] == 1 &&
+            keyUseCount[{folderPair.folderPathRight, fpCfg.filter.nameFilter, fpCfg.handleSymlinks}] == 1 &&
+            //only two-way-like variants update sync.ffs_db on each sync => for other variants the last synchronous state of unchanged items is outdated
+            std::get_if<DirectionByChange>(&fpCfg.directionCfg.dirs) &&
+            !getNativeItemPath(folderPair.folderPathLeft ).empty() &&
+            !getNativeItemPath(folderPair.folderPathRight).empty())
+        {
+            if (!isWatched(folderPair.folderPathLeft) ||
+                !isWatched(folderPair.folderPathRight))
+                cb_.logMessage(_("Folders are not monitored for changes: Scanning all items.") + L' ' +
+                               getShortDisplayNameForFolderPair(folderPair.folderPathLeft, folderPair.folderPathRight), PhaseCallback::MsgType::info); //throw X
+            else if (const std::optional<Zstring> changedItemsPhrase = getChangedItemsPhrase(folderAliasesByPair[i], changeList_->changedItemPaths))
+            {
+                dbBaseFolders.push_back(makeSharedRef<BaseFolderPair>(folderPair.folderPathLeft,  BaseFolderStatus::existing,
+                                                                      folderPair.folderPathRight, BaseFolderStatus::existing,
+                                                                      fpCfg.filter.nameFilter, fpCfg.compareVar, fileTimeTolerance_, fpCfg.ignoreTimeShiftMinutes));
+                candidates.emplace_back(&fpCfg, *changedItemsPhrase);
+            }
+        }
+
+    if (candidates.empty())
+        return {};
+
+    std::vector<const BaseFolderPair*> baseFoldersForDbLoad;
+    for (const SharedRef<BaseFolderPair>& baseFolder : dbBaseFolders)
+        baseFoldersForDbLoad.push_back(&baseFolder.ref());
+
+    const std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> lastSyncStates =
+        lastSyncStateBuf_.load(baseFoldersForDbLoad, deviceParallelOps_, cb_); //throw X
+
+    std::vector<PartialScan> output;
+    for (size_t i = 0; i < candidates.size(); ++i)
+        //no database => no last synchronous state => full scan
+        if (auto it = lastSyncStates.find(baseFoldersForDbLoad[i]);
+            it != lastSyncStates.end())
+        {
+            const BaseFolderPair& baseFolder = *baseFoldersForDbLoad[i];
+            const auto& [fpCfg, changedItemsPhrase] = candidates[i];
+
+            //database lists in-sync items only: failed, conflicting or excluded items of the last sync would be lost
+            if (!it->second.ref().allItemsInSync)
+            {
+                cb_.logMessage(_("Last synchronization did not complete: Scanning all items.") + L' ' +
+                               getShortDisplayNameForFolderPair(baseFolder.getAbstractPath<SelectSide::left >(),
+                                                                baseFolder.getAbstractPath<SelectSide::right>()), PhaseCallback::MsgType::info); //throw X
+                continue;
+            }
+
+            const FilterRef changedItems = makeSharedRef<NameFilter>(changedItemsPhrase, Zstring());
+            const FilterRef scanFilter = makeSharedRef<ChangedItemsFilter>(fpCfg->filter.nameFilter, changedItems);
+
+            output.push_back({{baseFolder.getAbstractPath<SelectSide::left>(), fpCfg->filter.nameFilter, fpCfg->handleSymlinks},
+                {baseFolder.getAbstractPath<SelectSide::left>(), scanFilter, fpCfg->handleSymlinks}, changedItems, SelectSide::left, it->second});
+
+            output.push_back({{baseFolder.getAbstractPath<SelectSide::right>(), fpCfg->filter.nameFilter, fpCfg->handleSymlinks},
+                {baseFolder.getAbstractPath<SelectSide::right>(), scanFilter, fpCfg->handleSymlinks}, changedItems, SelectSide::right, it->second});
+
+            cb_.logMessage(_("Scanning changed items only:") + L' ' +
+                           getShortDisplayNameForFolderPair(baseFolder.getAbstractPath<SelectSide::left >(),
+                                                            baseFolder.getAbstractPath<SelectSide::right>()), PhaseCallback::MsgType::info); //throw X
+        }
+    return output;
+}
+
+
 FolderComparison ComparisonBuffer::execute(const std::vector<std::pair<ResolvedFolderPair, FolderPairCfg>>& workLoad)
 {
     std::set<DirectoryKey> foldersToRead;
@@ -242,6 +559,14 @@ FolderComparison ComparisonBuffer::execute(const std::vector<std::pair<ResolvedF
                 foldersToRead.emplace(DirectoryKey{folderPair.folderPathRight, fpCfg.filter.nameFilter, fpCfg.handleSymlinks});
         }
 
+    //change list available: scan changed items only and take the rest from last synchronous state
+    const std::vector<PartialScan> partialScans = preparePartialScans(workLoad); //throw X
+    for (const PartialScan& ps : partialScans)
+    {
+        foldersToRead.erase(ps.fullKey);
+        foldersToRead.insert(ps.scanKey);
+    }
+
     //------------------------------------------------------------------
     StopWatch scanTime;
     int itemsReported = 0;
@@ -255,9 +580,25 @@ FolderComparison ComparisonBuffer::execute(const std::vector<std::pair<ResolvedF
     };
 
     folderBuffer_ = parallelFolderScan(foldersToRead,
-    [&](const PhaseCallback::ErrorInfo& errorInfo) { return cb_.reportError(errorInfo); }, //throw X
-    onStatusUpdate, //throw X
-    UI_UPDATE_INTERVAL / 2); //every ~25 ms
+                                       cb_, //throw X
+                                       onStatusUpdate, //throw X
+                                       UI_UPDATE_INTERVAL / 2); //every ~25 ms
+
+    for (const PartialScan& ps : partialScans)
+    {
+        auto node = folderBuffer_.extract(ps.scanKey);
+        assert(!node.empty());
+        if (!node.empty())
+        {
+            if (ps.side == SelectSide::left)
+                addUnchangedItems<SelectSide::left >(node.mapped().folderCont, ps.lastSyncState.ref(), Zstring(), ps.fullKey.filter.ref(), ps.changedItems.ref());
+            else
+                addUnchangedItems<SelectSide::right>(node.mapped().folderCont, ps.lastSyncState.ref(), Zstring(), ps.fullKey.filter.ref(), ps.changedItems.ref());
+
+            node.key() = ps.fullKey;
+            folderBuffer_.insert(std::move(node));
+        }
+    }
 
     //------------------------------------------------------------------
     const int64_t totalTimeSec = std::chrono::duration_cast<std::chrono::seconds>(scanTime.elapsed()).count();
@@ -414,23 +755,46 @@ SharedRef<BaseFolderPair> ComparisonBuffer::compareByTimeSize(const ResolvedFold
 
 namespace
 {
-void categorizeSymlinkByContent(SymlinkPair& symlink, PhaseCallback& callback)
+//categorize symlinks that exist on both sides
+void categorizeSymlinksByContent(const std::vector<SymlinkPair*>& symlinks, const std::map<AfsDevice, size_t>& deviceParallelOps, PhaseCallback& callback) //throw X
 {
-    //categorize symlinks that exist on both sides
-    callback.updateStatus(replaceCpy(_("Resolving symbolic link %x"), L"%x", fmtPath(AFS::getDisplayPath(symlink.getAbstractPath<SelectSide::left >())))); //throw X
-    callback.updateStatus(replaceCpy(_("Resolving symbolic link %x"), L"%x", fmtPath(AFS::getDisplayPath(symlink.getAbstractPath<SelectSide::right>())))); //throw X
+    //resolving a symlink means one round-trip per side (e.g. libssh2_sftp_readlink) => don't run thousands of them serially on the main thread
+    //=> run on worker threads: per-device parallelism, see massParallelExecute()
+    const std::wstring txtResolvingSymlink = _("Resolving symbolic link %x");
 
-    bool equalContent = false;
-    const std::wstring errMsg = tryReportingError([&]
+    //each work item accesses *both* devices => group by device pair
+    std::map<std::pair<AfsDevice, AfsDevice>, std::vector<std::pair<AbstractPath, ParallelWorkItem>>> devicePairWorkload;
+
+    for (SymlinkPair* symlink : symlinks)
+        devicePairWorkload[{symlink->getAbstractPath<SelectSide::left >().afsDevice,
+                            symlink->getAbstractPath<SelectSide::right>().afsDevice}].
+        emplace_back(symlink->getAbstractPath<SelectSide::left>(), [symlink, &txtResolvingSymlink](ParallelContext& ctx) //throw ThreadStopRequest
     {
-        equalContent = AFS::equalSymlinkContent(symlink.getAbstractPath<SelectSide::left >(),
-                                                symlink.getAbstractPath<SelectSide::right>()); //throw FileError
-    }, callback); //throw X
+        ctx.acb.updateStatus(replaceCpy(txtResolvingSymlink, L"%x", fmtPath(AFS::getDisplayPath(ctx.itemPath)))); //throw ThreadStopRequest
 
-    if (!errMsg.empty())
-        symlink.setCategoryConflict(utfTo<Zstringc>(errMsg));
-    else
-        symlink.setContentCategory(equalContent ? FileContentCategory::equal : FileContentCategory::different);
+        bool equalContent = false;
+        const std::wstring errMsg = tryReportingError([&]
+        {
+            equalContent = AFS::equalSymlinkContent(symlink->getAbstractPath<SelectSide::left >(),
+                                                    symlink->getAbstractPath<SelectSide::right>()); //throw FileError
+        }, ctx.acb); //throw ThreadStopRequest
+
+        //each task owns its SymlinkPair exclusively => no locking needed
+        if (!errMsg.empty())
+            symlink->setCategoryConflict(utfTo<Zstringc>(errMsg));
+        else
+            symlink->setContentCategory(equalContent ? FileContentCategory::equal : FileContentCategory::different);
+    });
+
+    for (const auto& [devicePair, parallelWorkload] : devicePairWorkload)
+    {
+        //each task sends requests to both devices => respect the lower limit
+        const size_t parallelOps = std::min(getMassParallelOps(deviceParallelOps, devicePair.first),
+                                            getMassParallelOps(deviceParallelOps, devicePair.second));
+
+        massParallelExecute(parallelWorkload, {{devicePair.first, parallelOps}},
+                            Zstr("Resolve symlinks"), callback /*throw X*/); //throw X
+    }
 }
 }
 
@@ -443,8 +807,8 @@ SharedRef<BaseFolderPair> ComparisonBuffer::compareBySize(const ResolvedFolderPa
     SharedRef<BaseFolderPair> output = performComparison(fp, fpConfig, uncategorizedFiles, uncategorizedLinks);
 
     //finish symlink categorization
-    for (SymlinkPair* symlink : uncategorizedLinks)
-        categorizeSymlinkByContent(*symlink, cb_); //"compare by size" has the semantics of a quick content-comparison!
+    categorizeSymlinksByContent(uncategorizedLinks, deviceParallelOps_, cb_); //throw X
+    //"compare by size" has the semantics of a quick content-comparison!
     //harmonize with algorithm.cpp, stillInSync()!
 
     //categorize files that exist on both sides
@@ -463,16 +827,55 @@ SharedRef<BaseFolderPair> ComparisonBuffer::compareBySize(const ResolvedFolderPa
 }
 
 
+namespace
+{
+template <SelectSide side> inline
+bool unchangedSinceSync(const FilePair& file, const InSyncFile& dbFile)
+{
+    const InSyncDescrFile& descrDb = selectParam<side>(dbFile.left, dbFile.right);
+
+    return file.getFileSize<side>() == dbFile.fileSize &&
+           file.getLastWriteTime<side>() == descrDb.modTime && //exact match: no time tolerance! DB contains the values from last comparison or file copy
+           file.getFilePrint<side>() != 0 && //no file print (e.g. SFTP, FTP)? => file might have been replaced preserving size and time: can't tell => compare content
+           file.getFilePrint<side>() == descrDb.filePrint;
+}
+
+
+//find files that were found equal by content during last sync and are unchanged on *both* sides since
+//=> no need to read even a single byte
+//only one side unchanged? still compared bytewise: the content sample in sync.ffs_db (see getContentSample()) only covers the head of the file
+void collectUnchangedSinceSync(const ContainerObject& conObj, const InSyncFolder& dbFolder, std::unordered_set<const FilePair*>& unchangedFiles)
+{
+    for (const FilePair& file : conObj.files())
+        if (!file.isEmpty<SelectSide::left>() && !file.isEmpty<SelectSide::right>() &&
+            file.hasEquivalentItemNames()) //case-sensitive file name match is a database invariant!
+            if (const auto it = dbFolder.files.find(file.getItemName<SelectSide::left>());
+                it != dbFolder.files.end())
+                if (const InSyncFile& dbFile = it->second;
+                    dbFile.cmpVar == CompareVariant::content &&
+                    unchangedSinceSync<SelectSide::left >(file, dbFile) &&
+                    unchangedSinceSync<SelectSide::right>(file, dbFile))
+                    unchangedFiles.insert(&file);
+
+    for (const FolderPair& folder : conObj.subfolders())
+        if (!folder.isEmpty<SelectSide::left>() && !folder.isEmpty<SelectSide::right>())
+            if (const auto it = dbFolder.folders.find(folder.getItemName<SelectSide::left>());
+                it != dbFolder.folders.end())
+                collectUnchangedSinceSync(folder, it->second, unchangedFiles);
+}
+}
+
+
 namespace parallel
 {
 //--------------------------------------------------------------
 //ATTENTION CALLBACKS: they also run asynchronously *outside* the singleThread lock!
 //--------------------------------------------------------------
 inline
-bool filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath& filePath2, //throw FileError, X
+bool filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath& filePath2, uint64_t fileSize, //throw FileError, X
                           const IoCallback& notifyUnbufferedIO /*throw X*/,
                           std::mutex& singleThread)
-{ return parallelScope([=] { return filesHaveSameContent(filePath1, filePath2, notifyUnbufferedIO); /*throw FileError, X*/ }, singleThread); }
+{ return parallelScope([=] { return filesHaveSameContent(filePath1, filePath2, fileSize, notifyUnbufferedIO); /*throw FileError, X*/ }, singleThread); }
 }
 
 
@@ -499,7 +902,8 @@ void categorizeFileByContent(FilePair& file, const std::wstring& txtComparingCon
         };
 
         haveSameContent = parallel::filesHaveSameContent(file.getAbstractPath<SelectSide::left >(),
-                                                         file.getAbstractPath<SelectSide::right>(), notifyUnbufferedIO, singleThread); //throw FileError, ThreadStopRequest
+                                                         file.getAbstractPath<SelectSide::right>(),
+                                                         file.getFileSize<SelectSide::left>(), notifyUnbufferedIO, singleThread); //throw FileError, ThreadStopRequest
         statReporter.reportDelta(1, 0);
     }, acb); //throw ThreadStopRequest
 
@@ -538,17 +942,42 @@ std::vector<SharedRef<BaseFolderPair>> ComparisonBuffer::compareByContent(const
 
     const Zstringc txtConflictSkippedBinaryComparison = getConflictSkippedBinaryComparison(); //avoid premature pess.: save memory via ref-counted string
 
+    std::vector<std::vector<FilePair*>> undefinedFilesByPair;
+    std::vector<SymlinkPair*> uncategorizedLinks;
+    std::vector<const BaseFolderPair*> baseFoldersForDbLoad;
+
     for (const auto& [folderPair, fpCfg] : workLoad)
     {
-        std::vector<FilePair*> undefinedFiles;
-        std::vector<SymlinkPair*> uncategorizedLinks;
+        std::vector<FilePair*>& undefinedFiles = undefinedFilesByPair.emplace_back();
         //run basis scan and retrieve candidates for binary comparison (files existing on both sides)
-        output.push_back(performComparison(folderPair, fpCfg, undefinedFiles, uncategorizedLinks));
+        output.push_back(performComparison(folderPair, fpCfg, undefinedFiles, uncategorizedLinks)); //[!] appends to uncategorizedLinks
+
+        //sync.ffs_db is only maintained for two-way-like sync variants
+        if (std::get_if<DirectionByChange>(&fpCfg.directionCfg.dirs) && !undefinedFiles.empty())
+            baseFoldersForDbLoad.push_back(&output.back().ref());
+    }
+
+    //finish symlink categorization: all folder pairs at once
+    categorizeSymlinksByContent(uncategorizedLinks, deviceParallelOps_, cb_); //throw X
+
+    //(try to) load sync-database files: skip binary comparison for files that are unchanged since last found equal by content
+    //=> buffered: redetermineSyncDirection() and preparePartialScans() use the same DB without reading it again
+    const std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> lastSyncStates =
+        lastSyncStateBuf_.load(baseFoldersForDbLoad, deviceParallelOps_, cb_ /*throw X*/); //throw X
+
+    for (size_t i = 0; i < output.size(); ++i)
+    {
+        const BaseFolderPair& baseFolder = output[i].ref();
+
+        std::unordered_set<const FilePair*> unchangedFiles;
+        if (const auto it = lastSyncStates.find(&baseFolder);
+            it != lastSyncStates.end())
+            collectUnchangedSinceSync(baseFolder, it->second.ref(), unchangedFiles);
 
         RingBuffer<FilePair*> filesToCompareBytewise;
         //content comparison of file content happens AFTER finding corresponding files and AFTER filtering
         //in order to separate into two processes (scanning and comparing)
-        for (FilePair* file : undefinedFiles)
+        for (FilePair* file : undefinedFilesByPair[i])
             //pre-check: files have different content if they have a different file size (must not be FILE_EQUAL: see InSyncFile)
             if (file->getFileSize<SelectSide::left>() != file->getFileSize<SelectSide::right>())
                 file->setContentCategory(FileContentCategory::different);
@@ -559,16 +988,14 @@ std::vector<SharedRef<BaseFolderPair>> ComparisonBuffer::compareByContent(const
                 assert(file->getContentCategory() == FileContentCategory::unknown); //=default
                 if (!file->isActive())
                     file->setCategoryConflict(txtConflictSkippedBinaryComparison);
+                else if (unchangedFiles.contains(file))
+                    file->setContentCategory(FileContentCategory::equal);
                 else
                     filesToCompareBytewise.push_back(file);
             }
         if (!filesToCompareBytewise.empty())
-            addToBinaryWorkload(output.back().ref().getAbstractPath<SelectSide::left >(),
-                                output.back().ref().getAbstractPath<SelectSide::right>(), std::move(filesToCompareBytewise));
-
-        //finish symlink categorization
-        for (SymlinkPair* symlink : uncategorizedLinks)
-            categorizeSymlinkByContent(*symlink, cb_);
+            addToBinaryWorkload(baseFolder.getAbstractPath<SelectSide::left >(),
+                                baseFolder.getAbstractPath<SelectSide::right>(), std::move(filesToCompareBytewise));
     }
 
     //finish categorization: compare files (that have same size) bytewise...
@@ -589,7 +1016,7 @@ std::vector<SharedRef<BaseFolderPair>> ComparisonBuffer::compareByContent(const
 
         std::mutex singleThread; //only a single worker thread may run at a time, except for parallel file I/O
 
-        AsyncCallback acb;                       //
+        AsyncCallback acb(cb_);                  //
         std::function<void()> scheduleMoreTasks; //manage life time: enclose ThreadGroup!
 
         ThreadGroup<std::function<void()>> tg(std::numeric_limits<size_t>::max(), Zstr("Binary Comparison"));
@@ -1068,6 +1495,8 @@ FolderComparison fff::compare(WarningDialogs& warnings,
                               bool createDirLocks,
                               std::unique_ptr<LockHolder>& dirLocks,
                               const std::vector<FolderPairCfg>& fpCfgList,
+                              const std::map<AfsDevice, size_t>& deviceParallelOps,
+                              const std::optional<ChangeList>& changeList,
                               ProcessCallback& callback /*throw X*/) //throw X
 {
     //indicator at the very beginning of the log to make sense of "total time"
@@ -1166,25 +1595,28 @@ FolderComparison fff::compare(WarningDialogs& warnings,
     try
     {
         FolderComparison output;
-        //reduce peak memory by restricting lifetime of ComparisonBuffer to have ended when loading potentially huge InSyncFolder instance in redetermineSyncDirection()
         {
-            //------------------- fill directory buffer: traverse/read folders --------------------------
-            ComparisonBuffer cmpBuf(resInfo.baseFolderStatus,
-                                    fileTimeTolerance, callback);
-            //PERF_START;
-            output = cmpBuf.execute(workLoad);
-            //PERF_STOP;
-        }
-        assert(output.size() == fpCfgList.size());
-
-        //--------- set initial sync-direction --------------------------------------------------
-        std::vector<std::pair<BaseFolderPair*, SyncDirectionConfig>> directCfgs;
-        for (auto it = output.begin(); it != output.end(); ++it)
-            directCfgs.emplace_back(&it->ref(), fpCfgList[it - output.begin()].directionCfg);
+            LastSyncStateBuffer lastSyncStateBuf; //sync.ffs_db might be needed for partial scan, content comparison *and* sync directions: load only once
+            //=> release potentially huge InSyncFolder instances right after setting sync directions
+            {
+                //reduce peak memory by restricting lifetime of ComparisonBuffer to have ended when loading potentially huge InSyncFolder instance in redetermineSyncDirection()
+                //------------------- fill directory buffer: traverse/read folders --------------------------
+                ComparisonBuffer cmpBuf(resInfo.baseFolderStatus,
+                                        fileTimeTolerance, deviceParallelOps, changeList, lastSyncStateBuf, callback);
+                //PERF_START;
+                output = cmpBuf.execute(workLoad);
+                //PERF_STOP;
+            }
+            assert(output.size() == fpCfgList.size());
 
-        redetermineSyncDirection(directCfgs,
-                                 callback); //throw X
+            //--------- set initial sync-direction --------------------------------------------------
+            std::vector<std::pair<BaseFolderPair*, SyncDirectionConfig>> directCfgs;
+            for (auto it = output.begin(); it != output.end(); ++it)
+                directCfgs.emplace_back(&it->ref(), fpCfgList[it - output.begin()].directionCfg);
 
+            redetermineSyncDirection(directCfgs, lastSyncStateBuf, deviceParallelOps,
+                                     callback); //throw X
+        }
         return output;
     }
     catch (const std::bad_alloc& e)
@@ -31,6 +31,14 @@ struct FolderPairCfg
 
 std::vector<FolderPairCfg> extractCompareCfg(const MainConfiguration& mainCfg); //fill FolderPairCfg and resolve folder pairs
 
+
+//items changed since last sync, e.g. reported by RealTimeSync: native paths
+struct ChangeList
+{
+    std::vector<Zstring> watchedFolderPaths; //changes are complete for these folders only
+    std::vector<Zstring> changedItemPaths;
+};
+
 //FFS core routine:     output.size() == fpCfgList.size() or 0 on fatal error
 FolderComparison compare(WarningDialogs& warnings,
                          unsigned int fileTimeTolerance,
@@ -39,6 +47,9 @@ FolderComparison compare(WarningDialogs& warnings,
                          bool createDirLocks,
                          std::unique_ptr<LockHolder>& dirLocks, //out
                          const std::vector<FolderPairCfg>& fpCfgList,
+                         const std::map<AfsDevice, size_t>& deviceParallelOps,
+                         //optional: scan changed items only and take the rest from sync.ffs_db
+                         const std::optional<ChangeList>& changeList,
                          ProcessCallback& callback /*throw X*/); //throw X
 }
 
@@ -21,7 +21,7 @@ namespace
 //-------------------------------------------------------------------------------------------------------------------------------
 const char DB_FILE_DESCR[] = "FreeFileSync";
 const int DB_FILE_VERSION   = 11; //2020-02-07
-const int DB_STREAM_VERSION =  5; //2023-07-29
+const int DB_STREAM_VERSION =  7; //2026-10-18
 //-------------------------------------------------------------------------------------------------------------------------------
 
 struct SessionData
@@ -234,6 +234,7 @@ public:
         };
 
         StreamGenerator generator;
+        writeNumber<int8_t>(generator.streamOutSmallNum_, dbFolder.allItemsInSync);
         //PERF_START
         generator.recurse(dbFolder);
         //PERF_STOP
@@ -275,6 +276,7 @@ private:
 
             writeFileDescr(inSyncData.left);
             writeFileDescr(inSyncData.right);
+            writeNumber<uint64_t>(streamOutBigNum_, inSyncData.contentSample);
         }
 
         writeNumber<uint32_t>(streamOutSmallNum_, static_cast<uint32_t>(container.symlinks.size()));
@@ -373,6 +375,8 @@ public:
             }
             else if (streamVersion == 3 || //TODO: remove migration code at some time! 2021-02-14
                      streamVersion == 4 || //TODO: remove migration code at some time! 2023-07-29
+                     streamVersion == 5 || //TODO: remove migration code at some time! 2026-10-18
+                     streamVersion == 6 || //TODO: remove migration code at some time! 2026-10-18
                      streamVersion == DB_STREAM_VERSION)
             {
                 MemoryStreamIn& streamInPart1 = leadStreamLeft ? streamInL : streamInR;
@@ -395,6 +399,8 @@ public:
                                     decompress(bufText),     //
                                     decompress(bufSmallNum), //throw SysError
                                     decompress(bufBigNum));  //
+                if (streamVersion >= 6)
+                    output.ref().allItemsInSync = readNumber<int8_t>(parser.streamInSmallNum_) != 0; //throw SysErrorUnexpectedEos
                 if (leadStreamLeft)
                     parser.recurse<SelectSide::left>(output.ref()); //throw SysError
                 else
@@ -433,9 +439,13 @@ private:
             const InSyncDescrFile descrL = readFileDescr(); //throw SysErrorUnexpectedEos
             const InSyncDescrFile descrT = readFileDescr(); //
 
+            uint64_t contentSample = 0;
+            if (streamVersion_ >= 7) //TODO: remove migration code at some time! 2026-10-18
+                contentSample = readNumber<uint64_t>(streamInBigNum_); //throw SysErrorUnexpectedEos
+
             container.addFile(itemName,
                               selectParam<leadSide>(descrL, descrT),
-                              selectParam<leadSide>(descrT, descrL), cmpVar, fileSize);
+                              selectParam<leadSide>(descrT, descrL), cmpVar, fileSize, contentSample);
         }
 
         size_t linkCount = readNumber<uint32_t>(streamInSmallNum_);
@@ -512,7 +522,7 @@ private:
                 /*const auto fileIdL =*/ readContainer<std::string>(inputLeft_);
                 const time_t modTimeR = readNumber<int64_t>(inputRight_);
                 /*const auto fileIdR =*/ readContainer<std::string>(inputRight_);
-                container.addFile(itemName, InSyncDescrFile{modTimeL, AFS::FingerPrint()}, InSyncDescrFile{modTimeR, AFS::FingerPrint()}, cmpVar, fileSize);
+                container.addFile(itemName, InSyncDescrFile{modTimeL, AFS::FingerPrint()}, InSyncDescrFile{modTimeR, AFS::FingerPrint()}, cmpVar, fileSize, 0 /*contentSample*/);
             }
 
             size_t linkCount = readNumber<uint32_t>(inputBoth_);
@@ -567,6 +577,8 @@ public:
     {
         LastSynchronousStateUpdater updater(baseFolder.getCompVariant(), baseFolder.getFilter());
         updater.recurse(baseFolder, Zstring(), dbFolder);
+
+        dbFolder.allItemsInSync = updater.allItemsInSync_;
     }
 
 private:
@@ -596,20 +608,34 @@ private:
                     const Zstring& fileName = file.getItemName<SelectSide::left>();
                     assert(file.getFileSize<SelectSide::left>() == file.getFileSize<SelectSide::right>());
 
-                    //create or update new "in-sync" state
-                    dbFiles.insert_or_assign(fileName, InSyncFile
+                    const InSyncFile dbFileNew
                     {
                         .left     = InSyncDescrFile{file.getLastWriteTime<SelectSide::left >(), file.getFilePrint<SelectSide::left >()},
                         .right    = InSyncDescrFile{file.getLastWriteTime<SelectSide::right>(), file.getFilePrint<SelectSide::right>()},
                         .cmpVar   = activeCmpVar_,
                         .fileSize = file.getFileSize<SelectSide::left>(),
-                    });
+                        .contentSample = file.getContentSample(),
+                    };
+                    //create or update new "in-sync" state
+                    auto [it, inserted] = dbFiles.try_emplace(fileName, dbFileNew);
+                    if (!inserted)
+                    {
+                        //file not copied during this sync: keep content sample if file is unchanged
+                        const uint64_t contentSampleOld = it->second.contentSample;
+                        const bool unchanged = it->second.fileSize      == dbFileNew.fileSize      &&
+                                               it->second.left .modTime == dbFileNew.left .modTime &&
+                                               it->second.right.modTime == dbFileNew.right.modTime;
+                        it->second = dbFileNew;
+                        if (it->second.contentSample == 0 && unchanged)
+                            it->second.contentSample = contentSampleOld;
+                    }
                     toPreserve.insert(fileName);
                 }
                 else //not in sync: preserve last synchronous state
                 {
                     toPreserve.insert(file.getItemName<SelectSide::left >()); //left/right may differ in case!
                     toPreserve.insert(file.getItemName<SelectSide::right>()); //
+                    allItemsInSync_ = false;
                 }
             }
 
@@ -650,6 +676,7 @@ private:
                 {
                     toPreserve.insert(symlink.getItemName<SelectSide::left >()); //left/right may differ in case!
                     toPreserve.insert(symlink.getItemName<SelectSide::right>()); //
+                    allItemsInSync_ = false;
                 }
             }
 
@@ -686,6 +713,7 @@ private:
                     toPreserve.emplace(folder.getItemName<SelectSide::left >(), &folder); //names differing (in case)? => treat like any other folder rename
                     toPreserve.emplace(folder.getItemName<SelectSide::right>(), &folder); //=> no *new* database entries even if child items are in sync
                     //BUT: update existing one: there should be only *one* DB entry after a folder rename (matching either folder name on left or right)
+                    allItemsInSync_ = false;
                 }
             }
 
@@ -731,6 +759,7 @@ private:
 
     const PathFilter& filter_; //filter used while scanning directory: generates view on actual files!
     const CompareVariant activeCmpVar_;
+    bool allItemsInSync_ = true;
 };
 
 
@@ -792,6 +821,7 @@ std::pair<DbStreams::const_iterator,
 //#######################################################################################################################################
 
 std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> fff::loadLastSynchronousState(const std::vector<const BaseFolderPair*>& baseFolders,
+        const std::map<AfsDevice, size_t>& deviceParallelOps,
         PhaseCallback& callback /*throw X*/) //throw X
 {
     std::set<AbstractPath> dbFilePaths;
@@ -828,7 +858,7 @@ std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> fff::lo
             }, ctx.acb);
         });
 
-        massParallelExecute(parallelWorkload,
+        massParallelExecute(parallelWorkload, deviceParallelOps,
                             Zstr("Load sync.ffs_db"), callback /*throw X*/); //throw X
     }
     //----------------------------------------------------------------
@@ -874,7 +904,44 @@ std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> fff::lo
 }
 
 
+std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> LastSyncStateBuffer::load(const std::vector<const BaseFolderPair*>& baseFolders,
+        const std::map<AfsDevice, size_t>& deviceParallelOps,
+        PhaseCallback& callback /*throw X*/) //throw X
+{
+    auto getKey = [](const BaseFolderPair& baseFolder) { return std::pair(baseFolder.getAbstractPath<SelectSide::left >(), baseFolder.getAbstractPath<SelectSide::right>()); };
+
+    std::vector<const BaseFolderPair*> baseFoldersToLoad;
+    for (const BaseFolderPair* baseFolder : baseFolders)
+        if (!lastSyncStates_.contains(getKey(*baseFolder)))
+            baseFoldersToLoad.push_back(baseFolder);
+
+    if (!baseFoldersToLoad.empty())
+    {
+        const std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> loaded =
+            loadLastSynchronousState(baseFoldersToLoad, deviceParallelOps, callback); //throw X
+
+        for (const BaseFolderPair* baseFolder : baseFoldersToLoad)
+            if (baseFolder->getFolderStatus<SelectSide::left >() == BaseFolderStatus::existing && //don't buffer: folder existence may differ for
+                baseFolder->getFolderStatus<SelectSide::right>() == BaseFolderStatus::existing)   //another BaseFolderPair with same paths
+            {
+                auto it = loaded.find(baseFolder);
+                lastSyncStates_.emplace(getKey(*baseFolder), it != loaded.end() ? it->second.ptr() : nullptr);
+            }
+    }
+
+    std::unordered_map<const BaseFolderPair*, SharedRef<const InSyncFolder>> output;
+    for (const BaseFolderPair* baseFolder : baseFolders)
+        if (baseFolder->getFolderStatus<SelectSide::left >() == BaseFolderStatus::existing &&
+            baseFolder->getFolderStatus<SelectSide::right>() == BaseFolderStatus::existing)
+            if (auto it = lastSyncStates_.find(getKey(*baseFolder));
+                it != lastSyncStates_.end() && it->second)
+                output.emplace(baseFolder, SharedRef<const InSyncFolder>(it->second));
+    return output;
+}
+
+
 void fff::saveLastSynchronousState(const BaseFolderPair& baseFolder, bool transactionalCopy,
+                                   const std::map<AfsDevice, size_t>& deviceParallelOps,
                                    PhaseCallback& callback /*throw X*/) //throw X
 {
     const AbstractPath dbPathL = getDatabaseFilePath<SelectSide::left >(baseFolder);
@@ -907,7 +974,7 @@ void fff::saveLastSynchronousState(const BaseFolderPair& baseFolder, bool transa
             loadSuccess = errMsg.empty();
         });
 
-        massParallelExecute(parallelWorkload,
+        massParallelExecute(parallelWorkload, deviceParallelOps,
                             Zstr("Load sync.ffs_db"), callback /*throw X*/); //throw X
 
         if (!loadSuccessL || !loadSuccessR)
@@ -1038,10 +1105,10 @@ void fff::saveLastSynchronousState(const BaseFolderPair& baseFolder, bool transa
         });
     }
 
-    massParallelExecute(parallelWorkloadSave,
+    massParallelExecute(parallelWorkloadSave, deviceParallelOps,
                         Zstr("Save sync.ffs_db"), callback /*throw X*/); //throw X
     //----------------------------------------------------------------
     if (saveSuccessL && saveSuccessR)
-        massParallelExecute(parallelWorkloadMove,
+        massParallelExecute(parallelWorkloadMove, deviceParallelOps,
                             Zstr("Move sync.ffs_db"), callback /*throw X*/); //throw X
 }
@@ -36,6 +36,7 @@ struct InSyncFile
     InSyncDescrFile right; //
     CompareVariant cmpVar = CompareVariant::timeSize; //the one active while finding "file in sync"
     uint64_t fileSize = 0; //file size must be identical on both sides!
+    uint64_t contentSample = 0; //optional: see getContentSample() in binary.h
 };
 
 struct InSyncSymlink
@@ -57,6 +58,9 @@ struct InSyncFolder
     FileList    files;
     SymlinkList symlinks; //non-followed symlinks
 
+    bool allItemsInSync = false; //base folder only: no out-of-sync items (conflicts, errors, excluded) were left after last sync
+    //=> database describes *all* items (within filter), not just the in-sync ones: required for partial comparison, see comparison.cpp
+
     //convenience
     InSyncFolder& addFolder(const Zstring& folderName)
     {
@@ -65,9 +69,9 @@ struct InSyncFolder
         return it->second;
     }
 
-    void addFile(const Zstring& fileName, const InSyncDescrFile& descrL, const InSyncDescrFile& descrR, CompareVariant cmpVar, uint64_t fileSize)
+    void addFile(const Zstring& fileName, const InSyncDescrFile& descrL, const InSyncDescrFile& descrR, CompareVariant cmpVar, uint64_t fileSize, uint64_t contentSample)
     {
-            files.emplace(fileName, InSyncFile {descrL, descrR, cmpVar, fileSize});
+            files.emplace(fileName, InSyncFile {descrL, descrR, cmpVar, fileSize, contentSample});
         assert(inserted);
     }
 
@@ -80,9 +84,23 @@ struct InSyncFolder
 
 
 std::unordered_map<const BaseFolderPair*, zen::SharedRef<const InSyncFolder>> loadLastSynchronousState(const std::vector<const BaseFolderPair*>& baseFolders,
+        const std::map<AfsDevice, size_t>& deviceParallelOps,
         PhaseCallback& callback /*throw X*/); //throw X
 
+//load each sync.ffs_db at most once, e.g. during comparison *and* while setting sync directions: avoid duplicate I/O and error reports
+class LastSyncStateBuffer
+{
+public:
+    //same as loadLastSynchronousState(), but base folders that were already requested are not loaded again
+    std::unordered_map<const BaseFolderPair*, zen::SharedRef<const InSyncFolder>> load(const std::vector<const BaseFolderPair*>& baseFolders,
+                                                                                      const std::map<AfsDevice, size_t>& deviceParallelOps,
+                                                                                      PhaseCallback& callback /*throw X*/); //throw X
+private:
+    std::map<std::pair<AbstractPath, AbstractPath>, std::shared_ptr<const InSyncFolder>> lastSyncStates_; //nullptr: not available (no DB, load error)
+};
+
 void saveLastSynchronousState(const BaseFolderPair& baseFolder, bool transactionalCopy, //throw X
+                              const std::map<AfsDevice, size_t>& deviceParallelOps,
                               PhaseCallback& callback /*throw X*/);
 }
 
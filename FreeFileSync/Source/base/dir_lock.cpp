@@ -20,6 +20,8 @@
     #include <fcntl.h>  //open()
     #include <unistd.h> //close()
     #include <signal.h> //kill()
+    #include <sys/file.h> //flock()
+    #include <sys/vfs.h>  //fstatfs()
 
 using namespace zen;
 using namespace fff;
@@ -294,6 +296,113 @@ ProcessStatus getProcessStatus(const LockInformation& lockInfo) //throw FileErro
 }
 
 
+/*  advisory lock held by the lock owner for the lifetime of the lock file:
+    - dropped by the kernel when the owning process exits (even after a crash) => no need to wait for missing life signs
+    - flock() rather than fcntl(): fcntl() locks are per process and would be released when LifeSigns closes its file handle!
+    - local file systems only: network file systems may not support flock(), or emulate it (NFS: via fcntl() => lockd might hang)
+    - lock files are still written and receive life signs => compatible with lock owners on other computers or older versions  */
+bool isLocalFileSystem(int fd) //noexcept
+{
+    struct statfs info = {};
+    if (::fstatfs(fd, &info) != 0)
+        return false;
+
+    switch (static_cast<uint32_t>(info.f_type)) //https://man7.org/linux/man-pages/man2/statfs.2.html
+    {
+        case 0x6969:     //NFS_SUPER_MAGIC
+        case 0x517B:     //SMB_SUPER_MAGIC
+        case 0xFF534D42: //CIFS_MAGIC_NUMBER
+        case 0xFE534D42: //SMB2_MAGIC_NUMBER
+        case 0x65735546: //FUSE_SUPER_MAGIC: e.g. sshfs, GVFS
+        case 0x73757245: //CODA_SUPER_MAGIC
+        case 0x5346414F: //AFS_SUPER_MAGIC
+        case 0x00C36400: //CEPH_SUPER_MAGIC
+        case 0x01021997: //V9FS_MAGIC
+            return false;
+    }
+    return true;
+}
+
+
+//returns -1 if not available => waiting processes rely on life signs only
+int acquireAdvisoryLock(const Zstring& lockFilePath) //noexcept
+{
+    const int fdLockFile = ::open(lockFilePath.c_str(), O_RDONLY | O_CLOEXEC); //flock() doesn't need write access
+    if (fdLockFile == -1)
+        return -1;
+
+    //don't block: waiting process might be probing right now (=> fall back to life signs)
+    if (isLocalFileSystem(fdLockFile) && ::flock(fdLockFile, LOCK_EX | LOCK_NB) == 0)
+        return fdLockFile;
+
+    ::close(fdLockFile);
+    return -1;
+}
+
+
+enum class AdvisoryLockStatus
+{
+    unknown, //not supported or lock owner doesn't use advisory locks
+    held,
+    released,
+};
+
+class AdvisoryLockObserver
+{
+public:
+    explicit AdvisoryLockObserver(const Zstring& lockFilePath) : lockFilePath_(lockFilePath)
+    {
+        fdLockFile_ = ::open(lockFilePath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fdLockFile_ != -1 && !isLocalFileSystem(fdLockFile_))
+        {
+            ::close(fdLockFile_);
+            fdLockFile_ = -1;
+        }
+    }
+
+    ~AdvisoryLockObserver() { if (fdLockFile_ != -1) ::close(fdLockFile_); }
+
+    AdvisoryLockStatus getStatus() //noexcept
+    {
+        if (fdLockFile_ == -1)
+            return AdvisoryLockStatus::unknown;
+
+        if (::flock(fdLockFile_, LOCK_SH | LOCK_NB) != 0)
+        {
+            if (errno != EWOULDBLOCK)
+                return AdvisoryLockStatus::unknown;
+
+            lockSeen_ = true;
+            return AdvisoryLockStatus::held;
+        }
+        ::flock(fdLockFile_, LOCK_UN); //don't keep the lock owner from acquiring it (e.g. if it hasn't yet)
+
+        //owner deletes lock file *before* releasing the advisory lock => file still existing: owner is gone
+        return lockSeen_ ? AdvisoryLockStatus::released : AdvisoryLockStatus::unknown;
+    }
+
+    //false if lock file was deleted or replaced by a new lock in the meantime
+    bool isObservedFile() const //noexcept
+    {
+        struct stat fdInfo   = {};
+        struct stat pathInfo = {};
+        return fdLockFile_ != -1 &&
+               ::fstat(fdLockFile_, &fdInfo) == 0 &&
+               ::stat(lockFilePath_.c_str(), &pathInfo) == 0 &&
+               fdInfo.st_dev == pathInfo.st_dev &&
+               fdInfo.st_ino == pathInfo.st_ino;
+    }
+
+private:
+    AdvisoryLockObserver           (const AdvisoryLockObserver&) = delete;
+    AdvisoryLockObserver& operator=(const AdvisoryLockObserver&) = delete;
+
+    const Zstring lockFilePath_;
+    int fdLockFile_ = -1;
+    bool lockSeen_ = false;
+};
+
+
 DEFINE_NEW_FILE_ERROR(ErrorFileNotExisting)
 uint64_t getLockFileSize(const Zstring& filePath) //throw FileError, ErrorFileNotExisting
 {
@@ -337,6 +446,9 @@ void waitOnDirLock(const Zstring& lockFilePath, const DirLockCallback& notifySta
     catch (FileError&) {} //logfile may be only partly written -> this is no error!
     //------------------------------------------------------------------------------
 
+    AdvisoryLockObserver advLockObserver(lockFilePath);
+    AdvisoryLockStatus advLockStatus = AdvisoryLockStatus::unknown;
+
     uint64_t fileSizeOld = 0;
     auto lastLifeSign = std::chrono::steady_clock::now();
 
@@ -349,6 +461,13 @@ void waitOnDirLock(const Zstring& lockFilePath, const DirLockCallback& notifySta
         }
         catch (ErrorFileNotExisting&) { return; } //what we are waiting for...
 
+        if (advLockStatus == AdvisoryLockStatus::released)
+        {
+            if (!advLockObserver.isObservedFile())
+                return; //another process has placed a new lock => wait on this one instead
+            lockOwnderDead = true; //=> no need to wait DETECT_ABANDONED_INTERVAL sec
+        }
+
         const auto lastCheckTime = std::chrono::steady_clock::now();
 
         if (fileSizeNew != fileSizeOld) //received life sign from lock
@@ -394,7 +513,7 @@ void waitOnDirLock(const Zstring& lockFilePath, const DirLockCallback& notifySta
         const auto delayUntil = std::min(std::chrono::steady_clock::now() + POLL_LIFE_SIGN_INTERVAL,
                                          lastLifeSign + DETECT_ABANDONED_INTERVAL);
 
-        for (auto now = std::chrono::steady_clock::now(); now < delayUntil; now = std::chrono::steady_clock::now())
+        for (auto now = std::chrono::steady_clock::now(); now < delayUntil && advLockStatus != AdvisoryLockStatus::released; now = std::chrono::steady_clock::now())
         {
             if (notifyStatus)
             {
@@ -408,6 +527,10 @@ void waitOnDirLock(const Zstring& lockFilePath, const DirLockCallback& notifySta
                     notifyStatus(std::wstring(infoMsg)); //throw X
             }
             std::this_thread::sleep_for(cbInterval);
+
+            advLockStatus = advLockObserver.getStatus(); //noexcept
+            if (advLockStatus == AdvisoryLockStatus::held) //lock owner is alive for sure, even if life signs are late (e.g. slow disk)
+                lastLifeSign = std::chrono::steady_clock::now();
         }
     }
 }
@@ -466,6 +589,8 @@ public:
             ::waitOnDirLock(lockFilePath, notifyStatus, cbInterval); //throw FileError
         }
 
+        fdAdvisoryLock_ = ::acquireAdvisoryLock(lockFilePath); //noexcept
+
         lifeSignthread_ = InterruptibleThread(LifeSigns(lockFilePath));
     }
 
@@ -479,6 +604,10 @@ public:
             ::releaseLock(lockFilePath_); //throw FileError
         }
         catch (const FileError& e) { logExtraError(e.toString()); } //inform user about remnant lock files *somehow*!
+
+        //*after* deleting the lock file: waiting processes must not mistake us for a crashed process
+        if (fdAdvisoryLock_ != -1)
+            ::close(fdAdvisoryLock_); //releases advisory lock
     }
 
 private:
@@ -486,6 +615,7 @@ private:
     SharedDirLock& operator=(const DirLock&) = delete;
 
     const Zstring lockFilePath_;
+    int fdAdvisoryLock_ = -1;
     InterruptibleThread lifeSignthread_;
 };
 
@@ -20,6 +20,7 @@ namespace fff
     - ownership shared between all object instances refering to a specific lock location(= GUID)
     - can be copied safely and efficiently! (ref-counting)
     - detects and resolves abandoned locks (instantly if lock is associated with local pc, else after 30 seconds)
+    - local file systems: release/crash of the lock owner is noticed within "cbInterval" (advisory lock via flock())
     - temporary locks created during abandoned lock resolution keep "lockFilePath"'s extension
     - race-free (Windows, almost on Linux(NFS))
     - NOT thread-safe! (1. global LockAdmin 2. locks for directory aliases should be created sequentially to detect duplicate locks!)         */
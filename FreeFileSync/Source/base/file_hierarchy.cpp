@@ -594,3 +594,17 @@ std::wstring fff::getSyncOpDescription(const FileSystemObject& fsObj)
     assert(false);
     return std::wstring();
 }
+
+
+size_t fff::countItemsUpTo(const ContainerObject& conObj, size_t countMax)
+{
+    size_t itemCount = conObj.files().size() + conObj.symlinks().size() + conObj.subfolders().size();
+
+    for (const FolderPair& folder : conObj.subfolders())
+    {
+        if (itemCount >= countMax)
+            break;
+        itemCount += countItemsUpTo(folder, countMax - itemCount);
+    }
+    return itemCount;
+}
@@ -465,8 +465,16 @@ public:
 
     template <SelectSide side> void removeItem();
 
+    //call before child items are modified in parallel: then their notifications only *read* this folder and its parents, see notifySyncCfgChanged()
+    void invalidateSyncOperation() { notifySyncCfgChanged(); }
+
 private:
-    void notifySyncCfgChanged() override { syncOpBuffered_ = {}; FileSystemObject::notifySyncCfgChanged(); }
+    void notifySyncCfgChanged() override
+    {
+        if (syncOpBuffered_) //already invalidated? => don't write: sync directions are set for subtrees in parallel (see algorithm.cpp)
+            syncOpBuffered_ = {};
+        FileSystemObject::notifySyncCfgChanged();
+    }
 
     mutable std::optional<SyncOperation> syncOpBuffered_; //determining sync-op for directory may be expensive as it depends on child-objects => buffer
 
@@ -502,6 +510,9 @@ public:
     template <SelectSide side> AFS::FingerPrint getFilePrint() const;
     template <SelectSide side> void clearFilePrint();
 
+    uint64_t getContentSample() const { return contentSample_; }
+    void setContentSample(uint64_t contentSample) { contentSample_ = contentSample; }
+
 
     void setMovePair(FilePair* ref); //reference to corresponding moved/renamed file
     FilePair* getMovePair() const; //may be nullptr
@@ -542,6 +553,8 @@ private:
 
     FileContentCategory contentCategory_ = FileContentCategory::unknown;
     Zstringc categoryDescr_; //optional: custom category description (e.g. FileContentCategory::conflict or invalidTime)
+
+    uint64_t contentSample_ = 0; //optional: same for both sides after sync (file copy, move), see getContentSample() in binary.h => stored in sync.ffs_db
 };
 
 //------------------------------------------------------------------
@@ -603,6 +616,14 @@ std::wstring getSyncOpDescription(const FileSystemObject& fsObj);
 
 //------------------------------------------------------------------
 
+//evaluating a hierarchy on worker threads (SyncStatistics, sync directions) doesn't pay off for fewer items: thread start-up and split overhead dominate
+constexpr size_t PARALLEL_HIERARCHY_ITEMS_MIN = 10'000;
+
+//number of contained items (recursively), but stop counting at "countMax": cheap check for large hierarchies
+size_t countItemsUpTo(const ContainerObject& conObj, size_t countMax);
+
+//------------------------------------------------------------------
+
 namespace impl
 {
 template <class Function1, class Function2, class Function3>
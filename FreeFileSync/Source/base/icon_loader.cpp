@@ -6,6 +6,7 @@
 
 #include "icon_loader.h"
 #include <zen/thread.h> //includes <std/thread.hpp>
+#include <wx/image.h>
 
     #include <gtk/gtk.h>
     #include <sys/stat.h>
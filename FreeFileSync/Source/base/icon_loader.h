@@ -9,7 +9,8 @@
 
 #include <zen/zstring.h>
 #include <wx+/image_holder.h>
-#include <wx/image.h>
+
+class wxImage; //keep wxWidgets out of afs/native.cpp (e.g. for the headless benchmark)
 
 
 namespace fff
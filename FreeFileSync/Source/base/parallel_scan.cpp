@@ -5,6 +5,7 @@
 // *****************************************************************************
 
 #include "parallel_scan.h"
+#include "async_error_policy.h"
 #include <chrono>
 #include <zen/thread.h>
 #include <zen/scope_guard.h>
@@ -42,12 +43,17 @@ const int FOLDER_TRAVERSAL_LEVEL_MAX = 100;
 class AsyncCallback
 {
 public:
-    AsyncCallback(size_t threadsToFinish, std::chrono::milliseconds cbInterval) : threadsToFinish_(threadsToFinish), cbInterval_(cbInterval) {}
+    AsyncCallback(size_t threadsToFinish, std::chrono::milliseconds cbInterval, const PhaseCallback& cb) :
+        threadsToFinish_(threadsToFinish), cbInterval_(cbInterval), errorPolicy_(cb) {}
 
-    //blocking call: context of worker thread
+    //blocking call: context of worker thread (non-blocking if error policy is set)
     AFS::TraverserCallback::HandleError reportError(const AFS::TraverserCallback::ErrorInfo& errorInfo) //throw ThreadStopRequest
     {
         assert(!runningOnMainThread());
+        if (const std::optional<PhaseCallback::Response> rv = errorPolicy_.tryHandleError({errorInfo.msg, errorInfo.failTime, errorInfo.retryNumber},
+        [this](std::wstring&& msg) { reportCurrentFile(msg); })) //throw ThreadStopRequest
+            return toHandleError(*rv);
+
         std::unique_lock dummy(lockRequest_);
         interruptibleWait(conditionReadyForNewRequest_, dummy, [this] { return !errorRequest_ && !errorResponse_; }); //throw ThreadStopRequest
 
@@ -68,7 +74,7 @@ public:
     }
 
     //context of main thread
-    void waitUntilDone(const TravErrorCb& onError, const TravStatusCb& onStatusUpdate) //throw X
+    void waitUntilDone(PhaseCallback& cb, const TravStatusCb& onStatusUpdate) //throw X
     {
         assert(runningOnMainThread());
         for (;;)
@@ -81,30 +87,26 @@ public:
                 if (!rv) //time-out + condition not met
                     break;
 
+                errorPolicy_.flushLog(cb); //throw X; preserve log order
+
                 if (errorRequest_ && !errorResponse_)
                 {
                     assert(threadsToFinish_ != 0);
-                    switch (onError({errorRequest_->msg, errorRequest_->failTime, errorRequest_->retryNumber})) //throw X
-                    {
-                        case PhaseCallback::ignore:
-                            errorResponse_ = AFS::TraverserCallback::HandleError::ignore;
-                            break;
-
-                        case PhaseCallback::retry:
-                            errorResponse_ = AFS::TraverserCallback::HandleError::retry;
-                            break;
-                    }
+                    errorResponse_ = toHandleError(cb.reportError({errorRequest_->msg, errorRequest_->failTime, errorRequest_->retryNumber})); //throw X
                     conditionHaveResponse_.notify_all(); //instead of notify_one(); work around bug: https://svn.boost.org/trac/boost/ticket/7796
                 }
                 if (threadsToFinish_ == 0)
                 {
                     dummy.unlock();
+                    errorPolicy_.flushLog(cb); //throw X
                     onStatusUpdate(getStatusLine(), itemsScanned_); //throw X; one last call for accurate stat-reporting!
                     return;
                 }
             }
 
             //call member functions outside of mutex scope:
+            errorPolicy_.flushLog(cb); //throw X
+            errorPolicy_.refresh(cb);
             onStatusUpdate(getStatusLine(), itemsScanned_); //throw X
         }
     }
@@ -165,6 +167,18 @@ public:
     }
 
 private:
+    static AFS::TraverserCallback::HandleError toHandleError(PhaseCallback::Response response)
+    {
+        switch (response)
+        {
+            case PhaseCallback::ignore:
+                return AFS::TraverserCallback::HandleError::ignore;
+            case PhaseCallback::retry:
+                break;
+        }
+        return AFS::TraverserCallback::HandleError::retry;
+    }
+
     std::wstring getStatusLine() //context of main thread, call repreatedly
     {
         assert(runningOnMainThread());
@@ -200,6 +214,8 @@ private:
     std::atomic<int> notifyingThreadIdx_{0}; //CAVEAT: do NOT use boost::thread::id: https://svn.boost.org/trac/boost/ticket/5754
     const std::chrono::milliseconds cbInterval_;
 
+    AsyncErrorPolicy errorPolicy_;
+
     //---- status updates II (lock-free) ----
     std::atomic<int> itemsScanned_{0}; //std:atomic is uninitialized by default!
 };
@@ -406,7 +422,7 @@ DirCallback::HandleError DirCallback::reportError(const ErrorInfo& errorInfo, co
 
 
 std::map<DirectoryKey, DirectoryValue> fff::parallelFolderScan(const std::set<DirectoryKey>& foldersToRead,
-                                                               const TravErrorCb& onError, const TravStatusCb& onStatusUpdate,
+                                                               PhaseCallback& cb, const TravStatusCb& onStatusUpdate,
                                                                std::chrono::milliseconds cbInterval)
 {
     std::map<DirectoryKey, DirectoryValue> output;
@@ -421,7 +437,7 @@ std::map<DirectoryKey, DirectoryValue> fff::parallelFolderScan(const std::set<Di
         perDeviceFolders[key.folderPath.afsDevice].insert(key);
 
     //communication channel used by threads
-    AsyncCallback acb(perDeviceFolders.size() /*threadsToFinish*/, cbInterval); //manage life time: enclose InterruptibleThread's!!!
+    AsyncCallback acb(perDeviceFolders.size() /*threadsToFinish*/, cbInterval, cb); //manage life time: enclose InterruptibleThread's!!!
 
     std::vector<InterruptibleThread> worker;
     ZEN_ON_SCOPE_SUCCESS( for (InterruptibleThread& wt : worker) wt.join(); ); //no stop needed in success case => preempt ~InterruptibleThread()
@@ -459,7 +475,7 @@ std::map<DirectoryKey, DirectoryValue> fff::parallelFolderScan(const std::set<Di
             AFS::traverseFolderRecursive(afsDevice, travWorkload, parallelOps); //throw ThreadStopRequest
         });
     }
-    acb.waitUntilDone(onError, onStatusUpdate); //throw X
+    acb.waitUntilDone(cb, onStatusUpdate); //throw X
 
     return output;
 }
@@ -43,11 +43,10 @@ struct DirectoryValue
 //Attention: 1. ensure directory filtering is applied later to exclude filtered folders which have been kept as parent folders
 //           2. remove folder aliases (e.g. case differences) *before* calling this function!!!
 
-using TravErrorCb  = std::function<PhaseCallback::Response(const PhaseCallback::ErrorInfo& errorInfo)>;
 using TravStatusCb = std::function<void(const std::wstring& statusLine, int itemsTotal)>;
 
 std::map<DirectoryKey, DirectoryValue> parallelFolderScan(const std::set<DirectoryKey>& foldersToRead,
-                                                          const TravErrorCb& onError, const TravStatusCb& onStatusUpdate, //NOT optional
+                                                          PhaseCallback& cb /*throw X; errors + logging*/, const TravStatusCb& onStatusUpdate, //NOT optional
                                                           std::chrono::milliseconds cbInterval);
 }
 
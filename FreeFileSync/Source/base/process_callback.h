@@ -10,6 +10,7 @@
 #include <string>
 #include <cstdint>
 #include <chrono>
+#include <optional>
 
 
 namespace fff
@@ -64,6 +65,15 @@ struct PhaseCallback
     };
     virtual Response reportError(const ErrorInfo& errorInfo) = 0; //throw X; recoverable error
 
+    //errors are handled without user interaction? (e.g. "ignore errors" is set)
+    //=> worker threads may apply this policy themselves instead of waiting for reportError() on main thread
+    struct ErrorPolicy
+    {
+        size_t autoRetryCount = 0; //then ignore
+        std::chrono::seconds autoRetryDelay{0};
+    };
+    virtual std::optional<ErrorPolicy> getErrorPolicy() const { return {}; } //context of main thread; may change while running
+
     virtual void reportFatalError(const std::wstring& msg)   = 0; //throw X; non-recoverable error
 };
 
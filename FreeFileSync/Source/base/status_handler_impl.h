@@ -11,6 +11,7 @@
 #include <zen/file_error.h>
 #include <zen/thread.h>
 #include "process_callback.h"
+#include "async_error_policy.h"
 #include "speed_test.h"
 
 
@@ -19,7 +20,7 @@ namespace fff
 class AsyncCallback
 {
 public:
-    AsyncCallback() {}
+    explicit AsyncCallback(const PhaseCallback& cb) : errorPolicy_(cb) {}
 
     //non-blocking: context of worker thread (and main thread, see reportStats())
     void updateDataProcessed(int itemsDelta, int64_t bytesDelta) //noexcept!
@@ -61,10 +62,13 @@ public:
         conditionNewRequest.notify_all();
     }
 
-    //blocking call: context of worker thread
+    //blocking call: context of worker thread (non-blocking if error policy is set)
     PhaseCallback::Response reportError(const PhaseCallback::ErrorInfo& errorInfo) //throw ThreadStopRequest
     {
         assert(!zen::runningOnMainThread());
+        if (const std::optional<PhaseCallback::Response> rv = errorPolicy_.tryHandleError(errorInfo, [this](std::wstring&& msg) { updateStatus(std::move(msg)); })) //throw ThreadStopRequest
+            return *rv;
+
         std::unique_lock dummy(lockRequest_);
         zen::interruptibleWait(conditionReadyForNewRequest_, dummy, [this] { return !errorRequest_ && !errorResponse_; }); //throw ThreadStopRequest
 
@@ -121,6 +125,8 @@ public:
                 if (!rv) //time-out + condition not met
                     break;
 
+                errorPolicy_.flushLog(cb); //throw X; preserve log order: queued errors precede a worker's next blocking request
+
                 if (logMsgRequest_)
                 {
                     cb.logMessage(logMsgRequest_->msg, logMsgRequest_->type); //throw X
@@ -150,6 +156,8 @@ public:
             }
 
             //call back outside of mutex scope:
+            errorPolicy_.flushLog(cb); //throw X
+            errorPolicy_.refresh(cb);
             cb.updateStatus(getStatusMsg()); //throw X
             reportStats(cb);
         }
@@ -281,6 +289,8 @@ private:
     };
     struct WarningResponse { bool warningActive = false; };
 
+    AsyncErrorPolicy errorPolicy_;
+
     //---- main <-> worker communication channel ----
     std::mutex lockRequest_;
     std::condition_variable conditionReadyForNewRequest_;
@@ -498,7 +508,20 @@ using ParallelWorkItem = std::function<void(ParallelContext& ctx)> /*throw Threa
 
 namespace
 {
+/*  reuse the "parallel file operations" setting instead of a separate one for metadata tasks:
+    it's the user's statement of how many concurrent connections/requests the device tolerates (SSH MaxStartups, FTP per-IP limits,
+    Google Drive rate limits) => metadata tasks run into the same limits; these phases don't overlap with file copies anyway
+    - not set explicitly: use AFS::getDefaultParallelOps(), the file copy default of 1 would serialize cheap round trips
+    - set explicitly, including 1: respect it, e.g. a server allowing only a single connection             */
+size_t getMassParallelOps(const std::map<AfsDevice, size_t>& deviceParallelOps, const AfsDevice& afsDevice)
+{
+    const auto itParOps = deviceParallelOps.find(afsDevice);
+    return itParOps != deviceParallelOps.end() ? itParOps->second : AFS::getDefaultParallelOps(afsDevice);
+}
+
+
 void massParallelExecute(const std::vector<std::pair<AbstractPath, ParallelWorkItem>>& workload,
+                         const std::map<AfsDevice, size_t>& deviceParallelOps, //devices not found: use AFS::getDefaultParallelOps()
                          const Zstring& threadGroupName,
                          PhaseCallback& callback /*throw X*/) //throw X
 {
@@ -511,7 +534,7 @@ void massParallelExecute(const std::vector<std::pair<AbstractPath, ParallelWorkI
     if (perDeviceWorkload.empty())
         return; //[!] otherwise AsyncCallback::notifyAllDone() is never called!
 
-    AsyncCallback acb;                                               //manage life time: enclose ThreadGroup's!!!
+    AsyncCallback acb(callback);                                     //manage life time: enclose ThreadGroup's!!!
     std::atomic<size_t> activeDeviceCount(perDeviceWorkload.size()); //
 
     //---------------------------------------------------------------------------------------------------------
@@ -523,7 +546,9 @@ void massParallelExecute(const std::vector<std::pair<AbstractPath, ParallelWorkI
         const size_t statusPrio = deviceThreadGroups.size();
 
         const Zstring& deviceGroupName = threadGroupName + Zstr(' ') + utfTo<Zstring>(AFS::getDisplayPath(AbstractPath(afsDevice, AfsPath())));
-        deviceThreadGroups.emplace_back(1, deviceGroupName);
+        const size_t parallelOps = getMassParallelOps(deviceParallelOps, afsDevice);
+
+        deviceThreadGroups.emplace_back(std::clamp<size_t>(parallelOps, 1, wl.size()), deviceGroupName);
         auto& threadGroup = deviceThreadGroups.back();
 
         for (const std::pair<AbstractPath, ParallelWorkItem>* item : wl)
@@ -193,14 +193,10 @@ size_t fff::getDeviceParallelOps(const std::map<AfsDevice, size_t>& deviceParall
 
 void fff::setDeviceParallelOps(std::map<AfsDevice, size_t>& deviceParallelOps, const AfsDevice& afsDevice, size_t parallelOps)
 {
-    assert(parallelOps > 0);
-    if (!AFS::isNullDevice(afsDevice))
-    {
-        if (parallelOps > 1)
-            deviceParallelOps[afsDevice] = parallelOps;
-        else
-            deviceParallelOps.erase(afsDevice);
-    }
+    if (parallelOps == 0) //back to default
+        deviceParallelOps.erase(afsDevice);
+    else if (!AFS::isNullDevice(afsDevice))
+        deviceParallelOps[afsDevice] = parallelOps; //store 1, too: user may want to force a single thread instead of AFS::getDefaultParallelOps()
 }
 
 
@@ -216,6 +212,19 @@ void fff::setDeviceParallelOps(std::map<AfsDevice, size_t>& deviceParallelOps, c
 }
 
 
+bool fff::haveDeviceParallelOps(const std::map<AfsDevice, size_t>& deviceParallelOps, const Zstring& folderPathPhrase)
+{
+    return deviceParallelOps.contains(createAbstractPath(folderPathPhrase).afsDevice);
+}
+
+
+size_t fff::getDeviceParallelOpsCfg(const std::map<AfsDevice, size_t>& deviceParallelOps, const AfsDevice& afsDevice)
+{
+    auto it = deviceParallelOps.find(afsDevice);
+    return it != deviceParallelOps.end() ? it->second : 0;
+}
+
+
 std::wstring fff::getSymbol(CompareFileResult cmpRes)
 {
     switch (cmpRes)
@@ -345,7 +345,7 @@ struct MainConfiguration
     LocalPairConfig firstPair; //there needs to be at least one pair!
     std::vector<LocalPairConfig> additionalPairs;
 
-    std::map<AfsDevice, size_t /*parallel operations*/> deviceParallelOps; //should only include devices with >= 2  parallel ops
+    std::map<AfsDevice, size_t /*parallel operations*/> deviceParallelOps; //only devices set explicitly: 1 forces a single thread also for metadata tasks (see massParallelExecute())
 
     bool ignoreErrors = false; //true: errors will still be logged
     size_t autoRetryCount = 0;
@@ -364,9 +364,11 @@ struct MainConfiguration
 
 
 size_t getDeviceParallelOps(const std::map<AfsDevice, size_t>& deviceParallelOps, const AfsDevice& afsDevice);
-void   setDeviceParallelOps(      std::map<AfsDevice, size_t>& deviceParallelOps, const AfsDevice& afsDevice, size_t parallelOps);
+void   setDeviceParallelOps(      std::map<AfsDevice, size_t>& deviceParallelOps, const AfsDevice& afsDevice, size_t parallelOps); //0: remove => default
 size_t getDeviceParallelOps(const std::map<AfsDevice, size_t>& deviceParallelOps, const Zstring& folderPathPhrase);
 void   setDeviceParallelOps(      std::map<AfsDevice, size_t>& deviceParallelOps, const Zstring& folderPathPhrase, size_t parallelOps);
+bool   haveDeviceParallelOps(const std::map<AfsDevice, size_t>& deviceParallelOps, const Zstring& folderPathPhrase); //set explicitly?
+size_t getDeviceParallelOpsCfg(const std::map<AfsDevice, size_t>& deviceParallelOps, const AfsDevice& afsDevice); //0 if not set explicitly
 
 
 std::optional<CompareVariant> getCommonCompVariant(const MainConfiguration& mainCfg);
@@ -12,6 +12,7 @@
 #include "status_handler_impl.h"
 #include "versioning.h"
 #include "binary.h"
+#include <zen/open_ssl.h>
 #include "../afs/concrete.h"
 #include "../afs/native.h"
 
@@ -32,8 +33,77 @@ const size_t CONFLICTS_PREVIEW_MAX = 25; //=> consider memory consumption, log f
 
 SyncStatistics::SyncStatistics(const FolderComparison& folderCmp)
 {
+    /*  statistics are re-evaluated after each sync config change in the GUI => don't stall on comparisons with millions of rows
+        => evaluate independent subtrees in parallel and merge in traversal order (=> same conflict preview as serial evaluation)
+
+        caveat: FolderPair::getSyncOperation() buffers its result, and evaluates (=> buffers) direct child folders
+        => a folder is evaluated only by the task owning its subtree, or *before* going parallel when split from its children  */
+    struct WorkItem
+    {
+        const ContainerObject* conObj;
+        const FolderPair* folder; //== conObj, or nullptr for base folder
+        bool recursive;
+    };
+    std::vector<WorkItem> workItems;
+    size_t itemCount = 0; //up to PARALLEL_HIERARCHY_ITEMS_MIN
     for (const BaseFolderPair& baseFolder : asRange(folderCmp))
-        recurse(baseFolder);
+    {
+        workItems.push_back({&baseFolder, nullptr, true});
+        if (itemCount < PARALLEL_HIERARCHY_ITEMS_MIN)
+            itemCount += countItemsUpTo(baseFolder, PARALLEL_HIERARCHY_ITEMS_MIN - itemCount);
+    }
+
+    const size_t threadCount = itemCount < PARALLEL_HIERARCHY_ITEMS_MIN ? 1 : //small comparison: don't split at all
+                               std::max<size_t>(std::thread::hardware_concurrency(), 1); //hardware_concurrency() == 0 if "not computable or well defined"
+
+    //split top-level subtrees: good enough load-balancing for typical folder hierarchies
+    for (int level = 0; threadCount > 1 && level < 3 && workItems.size() < 4 * threadCount; ++level)
+    {
+        std::vector<WorkItem> workItemsSplit;
+        for (const WorkItem& wi : workItems)
+            if (wi.recursive && !wi.conObj->subfolders().empty())
+            {
+                if (wi.folder)
+                    wi.folder->getSyncOperation(); //pre-evaluate on main thread: see above
+
+                workItemsSplit.push_back({wi.conObj, wi.folder, false /*recursive*/});
+                for (const FolderPair& subFolder : wi.conObj->subfolders())
+                    workItemsSplit.push_back({&subFolder, &subFolder, true /*recursive*/});
+            }
+            else
+                workItemsSplit.push_back(wi);
+
+        workItems.swap(workItemsSplit);
+    }
+
+    auto evalWorkItem = [](const WorkItem& wi, SyncStatistics& stats)
+    {
+        if (wi.folder)
+            stats.processFolder(*wi.folder);
+
+        if (wi.recursive)
+            stats.recurse(*wi.conObj);
+        else
+            stats.processShallow(*wi.conObj);
+    };
+
+    if (threadCount == 1 || workItems.size() <= 1)
+        for (const WorkItem& wi : workItems)
+            evalWorkItem(wi, *this);
+    else
+    {
+        std::vector<SyncStatistics> workItemStats(workItems.size(), SyncStatistics());
+        {
+            ThreadGroup<std::function<void()>> tg(std::min(threadCount, workItems.size()), Zstr("Sync Statistics"));
+
+            for (size_t i = 0; i < workItems.size(); ++i)
+                tg.run([&evalWorkItem, &wi = workItems[i], &stats = workItemStats[i]] { evalWorkItem(wi, stats); });
+
+            tg.wait();
+        }
+        for (const SyncStatistics& stats : workItemStats)
+            merge(stats);
+    }
 }
 
 
@@ -52,13 +122,24 @@ SyncStatistics::SyncStatistics(const FilePair& file)
 
 inline
 void SyncStatistics::recurse(const ContainerObject& conObj)
+{
+    processShallow(conObj);
+
+    for (const FolderPair& folder : conObj.subfolders())
+    {
+        processFolder(folder);
+        recurse(folder); //since we model logical stats, we recurse, even if deletion variant is "recycler" or "versioning + same volume", which is a single physical operation!
+    }
+}
+
+
+inline
+void SyncStatistics::processShallow(const ContainerObject& conObj)
 {
     for (const FilePair& file : conObj.files())
         processFile(file);
     for (const SymlinkPair& symlink : conObj.symlinks())
         processLink(symlink);
-    for (const FolderPair& folder : conObj.subfolders())
-        processFolder(folder);
 
     rowsTotal_ += conObj.subfolders().size();
     rowsTotal_ += conObj.files     ().size();
@@ -66,6 +147,25 @@ void SyncStatistics::recurse(const ContainerObject& conObj)
 }
 
 
+void SyncStatistics::merge(const SyncStatistics& other)
+{
+    createLeft_  += other.createLeft_;
+    createRight_ += other.createRight_;
+    updateLeft_  += other.updateLeft_;
+    updateRight_ += other.updateRight_;
+    deleteLeft_  += other.deleteLeft_;
+    deleteRight_ += other.deleteRight_;
+
+    bytesToProcess_ += other.bytesToProcess_;
+    rowsTotal_      += other.rowsTotal_;
+
+    conflictCount_ += other.conflictCount_;
+    for (const std::wstring& conflict : other.conflictsPreview_)
+        if (conflictsPreview_.size() < CONFLICTS_PREVIEW_MAX)
+            conflictsPreview_.push_back(conflict);
+}
+
+
 inline
 void SyncStatistics::logConflict(const FileSystemObject& fsObj)
 {
@@ -241,8 +341,6 @@ void SyncStatistics::processFolder(const FolderPair& folder)
         case SO_EQUAL:
             break;
     }
-
-    recurse(folder); //since we model logical stats, we recurse, even if deletion variant is "recycler" or "versioning + same volume", which is a single physical operation!
 }
 
 
@@ -386,6 +484,15 @@ std::vector<FolderPairSyncCfg> fff::extractSyncCfg(const MainConfiguration& main
 
 namespace
 {
+inline
+bool hasVersioningLimits(const FolderPairSyncCfg& folderPairCfg) //same check as in applyVersioningLimit()
+{
+    return folderPairCfg.handleDeletion == DeletionVariant::versioning &&
+           folderPairCfg.versioningStyle != VersioningStyle::replace &&
+           (folderPairCfg.versionMaxAgeDays > 0 || folderPairCfg.versionCountMax > 0);
+}
+
+
 //test if user accidentally selected the wrong folders to sync
 bool significantDifferenceDetected(const SyncStatistics& folderPairStat)
 {
@@ -656,20 +763,33 @@ void flushFileBuffers(const Zstring& nativeFilePath) //throw FileError
 
     if (::fsync(fdFile) != 0)
         THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(nativeFilePath)), "fsync");
+
+    //fsync() alone leaves the (now clean) pages in the OS cache => subsequent read would not see the disk at all
+    //POSIX_FADV_DONTNEED only drops pages already written, which is all of them after fsync()
+    //best effort: only a hint, file content is safely on disk already => failure only means verification might be served from cache
+    ::posix_fadvise(fdFile, 0 /*offset*/, 0 /*len*/, POSIX_FADV_DONTNEED); //"len == 0" means "end of the file"
 }
 
 
-void verifyFiles(const AbstractPath& sourcePath, const AbstractPath& targetPath, const IoCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, X
+void verifyFiles(const AbstractPath& sourcePath, const AbstractPath& targetPath, uint64_t fileSize,
+                 const std::optional<std::string>& sourceMd5 /*hashed during copy*/, const IoCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, X
 {
     try
     {
-        //do like "copy /v": 1. flush target file buffers, 2. read again as usual (using OS buffers)
-        // => it seems OS buffers are not invalidated by this: snake oil???
+        //1. flush target file buffers and evict them from OS cache 2. read target again
         if (const Zstring& targetPathNative = getNativeItemPath(targetPath);
             !targetPathNative.empty())
             flushFileBuffers(targetPathNative); //throw FileError
 
-        if (!filesHaveSameContent(sourcePath, targetPath, notifyUnbufferedIO)) //throw FileError, X
+        bool sameContent = false;
+        if (sourceMd5) //=> no need to read source again (which would likely be served from OS cache anyway)
+            sameContent = getFileContentMd5(targetPath, notifyUnbufferedIO) == *sourceMd5; //throw FileError, X
+        else if (std::optional<std::string> sourceMd5Fast = AFS::tryGetFileMd5Fast(sourcePath)) //throw FileError
+            sameContent = getFileContentMd5(targetPath, notifyUnbufferedIO) == *sourceMd5Fast; //throw FileError, X; e.g. server-side copy within Google Drive
+        else
+            sameContent = filesHaveSameContent(sourcePath, targetPath, fileSize, notifyUnbufferedIO); //throw FileError, X
+
+        if (!sameContent)
             throw FileError(replaceCpy(replaceCpy(_("%x and %y have different content."),
                                                   L"%x", L'\n' + fmtPath(AFS::getDisplayPath(sourcePath))),
                                        L"%y", L'\n' + fmtPath(AFS::getDisplayPath(targetPath))));
@@ -710,6 +830,10 @@ inline
 void moveAndRenameItem(const AbstractPath& pathFrom, const AbstractPath& pathTo, std::mutex& singleThread) //throw FileError, ErrorMoveUnsupported
 { parallelScope([pathFrom, pathTo] { AFS::moveAndRenameItem(pathFrom, pathTo); /*throw FileError, ErrorMoveUnsupported*/ }, singleThread); }
 
+inline
+bool filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath& filePath2, uint64_t fileSize, const IoCallback& notifyUnbufferedIO /*throw X*/, std::mutex& singleThread) //throw FileError, X
+{ return parallelScope([=] { return fff::filesHaveSameContent(filePath1, filePath2, fileSize, notifyUnbufferedIO); /*throw FileError, X*/ }, singleThread); }
+
 inline
 AbstractPath getSymlinkResolvedPath(const AbstractPath& linkPath, std::mutex& singleThread) //throw FileError
 { return parallelScope([linkPath] { return AFS::getSymlinkResolvedPath(linkPath); /*throw FileError*/ }, singleThread); }
@@ -748,11 +872,12 @@ AFS::FileCopyResult copyFileTransactional(const AbstractPath& sourcePath, const
                                           bool transactionalCopy,
                                           const std::function<void()>& onDeleteTargetFile /*throw X*/,
                                           const IoCallback& notifyUnbufferedIO /*throw X*/,
+                                          const IoDataCallback& notifySourceData /*throw X*/,
                                           std::mutex& singleThread)
 {
     return parallelScope([=]
     {
-        return AFS::copyFileTransactional(sourcePath, sourceAttr, targetPath, copyFilePermissions, transactionalCopy, onDeleteTargetFile, notifyUnbufferedIO); //throw FileError, ErrorFileLocked, X
+        return AFS::copyFileTransactional(sourcePath, sourceAttr, targetPath, copyFilePermissions, transactionalCopy, onDeleteTargetFile, notifyUnbufferedIO, notifySourceData); //throw FileError, ErrorFileLocked, X
     }, singleThread);
 }
 
@@ -778,8 +903,8 @@ void revisionFolder(FileVersioner& versioner,
 { parallelScope([=, &versioner] { versioner.revisionFolder(folderPath, relativePath, onBeforeFileMove, onBeforeFolderMove, notifyUnbufferedIO); /*throw FileError, X*/ }, singleThread); }
 
 inline
-void verifyFiles(const AbstractPath& sourcePath, const AbstractPath& targetPath, const IoCallback& notifyUnbufferedIO /*throw X*/, std::mutex& singleThread) //throw FileError, X
-{ parallelScope([=] { ::verifyFiles(sourcePath, targetPath, notifyUnbufferedIO); /*throw FileError, X*/ }, singleThread); }
+void verifyFiles(const AbstractPath& sourcePath, const AbstractPath& targetPath, uint64_t fileSize, const std::optional<std::string>& sourceMd5, const IoCallback& notifyUnbufferedIO /*throw X*/, std::mutex& singleThread) //throw FileError, X
+{ parallelScope([=] { ::verifyFiles(sourcePath, targetPath, fileSize, sourceMd5, notifyUnbufferedIO); /*throw FileError, X*/ }, singleThread); }
 
 }
 
@@ -795,7 +920,9 @@ public:
                     DeletionVariant deletionVariant,
                     const AbstractPath& versioningFolderPath,
                     VersioningStyle versioningStyle,
-                    time_t syncStartTime); //nothrow!
+                    bool versioningLimits,
+                    time_t syncStartTime,
+                    size_t versioningParallelOps); //nothrow!
 
     //clean-up temporary directory (recycle bin optimization)
     void tryCleanup(PhaseCallback& cb /*throw X*/); //throw X
@@ -804,6 +931,8 @@ public:
     void removeLinkWithCallback(const AbstractPath& linkPath,    const Zstring& relPath, bool beforeOverwrite, AsyncItemStatReporter& statReporter, std::mutex& singleThread);  //
     void removeDirWithCallback (const AbstractPath& dirPath,     const Zstring& relPath, AsyncItemStatReporter& statReporter, std::mutex& singleThread);                        //
 
+    VersionIndexDelta getVersionIndexDelta() const { return versioner_ ? versioner_->getIndexDelta() : VersionIndexDelta(); }
+
 private:
     DeletionHandler           (const DeletionHandler&) = delete;
     DeletionHandler& operator=(const DeletionHandler&) = delete;
@@ -839,7 +968,7 @@ private:
     {
         assert(deletionVariant_ == DeletionVariant::versioning);
         if (!versioner_)
-            versioner_.emplace(versioningFolderPath_, versioningStyle_, syncStartTime_); //throw FileError
+            versioner_.emplace(versioningFolderPath_, versioningStyle_, versioningLimits_, syncStartTime_, versioningParallelOps_); //throw FileError
         return *versioner_;
     }
 
@@ -856,7 +985,9 @@ private:
     //used only for DeletionVariant::versioning:
     const AbstractPath versioningFolderPath_;
     const VersioningStyle versioningStyle_;
+    const bool versioningLimits_;
     const time_t syncStartTime_;
+    const size_t versioningParallelOps_;
     std::optional<FileVersioner> versioner_;
 
     //buffer status texts:
@@ -883,14 +1014,18 @@ DeletionHandler::DeletionHandler(const AbstractPath& baseFolderPath,
                                  DeletionVariant deletionVariant,
                                  const AbstractPath& versioningFolderPath,
                                  VersioningStyle versioningStyle,
-                                 time_t syncStartTime) :
+                                 bool versioningLimits,
+                                 time_t syncStartTime,
+                                 size_t versioningParallelOps) :
     recyclerMissingReportOnce_(recyclerMissingReportOnce),
     warnRecyclerMissing_(warnRecyclerMissing),
     deletionVariant_(deletionVariant),
     baseFolderPath_(baseFolderPath),
     versioningFolderPath_(versioningFolderPath),
     versioningStyle_(versioningStyle),
-    syncStartTime_(syncStartTime) {}
+    versioningLimits_(versioningLimits),
+    syncStartTime_(syncStartTime),
+    versioningParallelOps_(versioningParallelOps) {}
 
 
 void DeletionHandler::tryCleanup(PhaseCallback& cb /*throw X*/) //throw X
@@ -1211,6 +1346,7 @@ public:
         bool failSafeFileCopy;
         DeletionHandler& delHandlerLeft;
         DeletionHandler& delHandlerRight;
+        const std::map<AfsDevice, size_t>& deviceParallelOps;
     };
 
     static void runSync(SyncCtx& syncCtx, BaseFolderPair& baseFolder, PhaseCallback& cb)
@@ -1276,7 +1412,8 @@ private:
                                              const AbstractPath& targetPath,
                                              const std::function<void()>& onDeleteTargetFile /*throw X*/, //optional!
                                              AsyncItemStatReporter& statReporter, //ThreadStopRequest
-                                             const std::wstring& statusMsg); //throw FileError, ThreadStopRequest, X
+                                             const std::wstring& statusMsg,
+                                             uint64_t& contentSample); //throw FileError, ThreadStopRequest, X; see getContentSample()
 
     DeletionHandler& delHandlerLeft_;
     DeletionHandler& delHandlerRight_;
@@ -1331,16 +1468,25 @@ void FolderPairSyncer::runPass(PassNo pass, SyncCtx& syncCtx, BaseFolderPair& ba
 {
     std::mutex singleThread; //only a single worker thread may run at a time, except for parallel file I/O
 
-    AsyncCallback acb;                                //
+    AsyncCallback acb(cb);                            //
     FolderPairSyncer fps(syncCtx, singleThread, acb); //manage life time: enclose InterruptibleThread's!!!
-    Workload workload(1, acb);
+
+    //e.g. SFTP: threads share the channels of one SSH connection => keep multiple small-file copies in flight
+    const size_t threadCount = std::max(getDeviceParallelOps(syncCtx.deviceParallelOps, baseFolder.getAbstractPath<SelectSide::left >().afsDevice),
+                                        getDeviceParallelOps(syncCtx.deviceParallelOps, baseFolder.getAbstractPath<SelectSide::right>().afsDevice));
+
+    Workload workload(threadCount, acb);
     workload.addWorkItems(fps.getFolderLevelWorkItems(pass, baseFolder, workload)); //initial workload: set *before* threads get access!
 
     std::vector<InterruptibleThread> worker;
     ZEN_ON_SCOPE_EXIT( for (InterruptibleThread& wt : worker) wt.requestStop(); ); //stop *all* at the same time before join!
 
-    size_t threadIdx = 0;
-    Zstring threadName = Zstr("Sync");
+    for (size_t threadIdx = 0; threadIdx < threadCount; ++threadIdx)
+    {
+        Zstring threadName = Zstr("Sync");
+        if (threadCount > 1)
+            threadName += Zstr('[') + numberTo<Zstring>(threadIdx + 1) + Zstr('/') + numberTo<Zstring>(threadCount) + Zstr(']');
+
         worker.emplace_back([threadIdx, &singleThread, &acb, &workload, threadName = std::move(threadName)]
         {
             setCurrentThreadName(threadName);
@@ -1354,6 +1500,7 @@ void FolderPairSyncer::runPass(PassNo pass, SyncCtx& syncCtx, BaseFolderPair& ba
                 workItem(); //throw ThreadStopRequest
             }
         });
+    }
     acb.waitUntilDone(UI_UPDATE_INTERVAL / 2 /*every ~25 ms*/, cb); //throw X
 }
 
@@ -1443,6 +1590,7 @@ RingBuffer<Workload::WorkItems> FolderPairSyncer::getFolderLevelWorkItems(PassNo
     3. start file move (via targets)
         - name-clash with other folder/symlink (=> obscure!): fall back to delete and copy
         - ErrorMoveUnsupported:                               fall back to delete and copy
+        - no file IDs and different content:                  fall back to delete and copy (ErrorMoveUnsupported)
         - ignored error:                                      fall back to delete and copy
 
   __________________
@@ -1787,12 +1935,13 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
             AsyncItemStatReporter statReporter(1, file.getFileSize<sideSrc>(), acb_);
             try
             {
+                uint64_t contentSample = 0;
                 const AFS::FileCopyResult result = copyFileWithCallback({file.getAbstractPath<sideSrc>(), file.getAttributes<sideSrc>()},
                                                                         targetPath,
                                                                         nullptr, //onDeleteTargetFile: nothing to delete
                                                                         //if existing: undefined behavior! (e.g. fail/overwrite/auto-rename)
                                                                         statReporter,
-                                                                        statusMsg); //throw FileError, ThreadStopRequest
+                                                                        statusMsg, contentSample); //throw FileError, ThreadStopRequest
                 statReporter.reportDelta(1, 0);
 
                 //update FilePair
@@ -1802,6 +1951,7 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
                                           result.targetFilePrint,
                                           result.sourceFilePrint,
                                           false, file.isFollowedSymlink<sideSrc>());
+                file.setContentSample(contentSample);
 
                 if (result.errorModTime) //log only; no popup
                     acb_.logMessage(result.errorModTime->toString(), PhaseCallback::MsgType::warning); //throw ThreadStopRequest
@@ -1862,6 +2012,30 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
 
                 AsyncItemStatReporter statReporter(1, 0, acb_);
 
+                //move pair found without file IDs (size and date only, see DetectMovedFiles)? => don't move a different file!
+                if (fileFrom->getFilePrint<sideTrg>() == 0 ||
+                    fileTo  ->getFilePrint<sideSrc>() == 0)
+                {
+                    const AbstractPath pathSrc = fileTo->getAbstractPath<sideSrc>();
+
+                    //both files are read: not part of the expected bytes, but still worth reporting (e.g. slow SFTP)
+                    PercentStatReporter percentReporter(replaceCpy(txtVerifyingFile_, L"%x", fmtPath(AFS::getDisplayPath(pathFrom))),
+                                                        2 * fileTo->getFileSize<sideSrc>(), statReporter);
+
+                    //callback runs *outside* singleThread_ lock! => fine
+                    auto notifyUnbufferedIO = [&](int64_t bytesDelta)
+                    {
+                        percentReporter.updateDeltaAndStatus(bytesDelta); //throw ThreadStopRequest
+                        interruptionPoint(); //throw ThreadStopRequest => not reliably covered by PercentStatReporter::updateDeltaAndStatus()!
+                    };
+
+                    if (!parallel::filesHaveSameContent(pathSrc, pathFrom, fileTo->getFileSize<sideSrc>(), notifyUnbufferedIO, singleThread_)) //throw FileError, ThreadStopRequest
+                        throw ErrorMoveUnsupported(AFS::generateMoveErrorMsg(pathFrom, pathTo), //=> fall back to delete + copy
+                                                   replaceCpy(replaceCpy(_("%x and %y have different content."),
+                                                                         L"%x", L'\n' + fmtPath(AFS::getDisplayPath(pathSrc))),
+                                                              L"%y", L'\n' + fmtPath(AFS::getDisplayPath(pathFrom))));
+                }
+
                 //already existing: undefined behavior! (e.g. fail/overwrite)
                 parallel::moveAndRenameItem(pathFrom, pathTo, singleThread_); //throw FileError, ErrorMoveUnsupported
 
@@ -1918,11 +2092,12 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
                 //file.removeItem<sideTrg>(); -> doesn't make sense for isFollowedSymlink(); "file, sideTrg" evaluated below!
             };
 
+            uint64_t contentSample = 0;
             const AFS::FileCopyResult result = copyFileWithCallback({file.getAbstractPath<sideSrc>(), file.getAttributes<sideSrc>()},
                                                                     targetPathResolvedNew,
                                                                     onDeleteTargetFile,
                                                                     statReporter,
-                                                                    statusMsg); //throw FileError, ThreadStopRequest
+                                                                    statusMsg, contentSample); //throw FileError, ThreadStopRequest
             statReporter.reportDelta(1, 0);
             //we model "delete + copy" as ONE logical operation
 
@@ -1934,6 +2109,7 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
                                       result.sourceFilePrint,
                                       file.isFollowedSymlink<sideTrg>(),
                                       file.isFollowedSymlink<sideSrc>());
+            file.setContentSample(contentSample);
 
             if (result.errorModTime) //log only; no popup
                 acb_.logMessage(result.errorModTime->toString(), PhaseCallback::MsgType::warning); //throw ThreadStopRequest
@@ -2270,7 +2446,8 @@ AFS::FileCopyResult FolderPairSyncer::copyFileWithCallback(const FileDescriptor&
                                                            const AbstractPath& targetPath,
                                                            const std::function<void()>& onDeleteTargetFile /*throw X*/,
                                                            AsyncItemStatReporter& statReporter /*throw ThreadStopRequest*/,
-                                                           const std::wstring& statusMsg) //throw FileError, ThreadStopRequest, X
+                                                           const std::wstring& statusMsg,
+                                                           uint64_t& contentSample) //throw FileError, ThreadStopRequest, X
 {
     const AbstractPath& sourcePath = sourceDescr.path;
     const AFS::StreamAttributes sourceAttr{sourceDescr.attr.modTime, sourceDescr.attr.fileSize, sourceDescr.attr.filePrint};
@@ -2279,6 +2456,29 @@ AFS::FileCopyResult FolderPairSyncer::copyFileWithCallback(const FileDescriptor&
     {
         PercentStatReporter percentReporter(statusMsg, sourceDescr.attr.fileSize, statReporter);
 
+        //content sample for sync.ffs_db: find moved files on devices without file IDs
+        ContentSampleStream sampleStream(sourceDescr.attr.fileSize);
+
+        //verification: hash source content while copying => only the target needs to be read again
+        std::optional<Md5Stream> sourceMd5Stream;
+        uint64_t sourceBytesHashed = 0;
+        if (verifyCopiedFiles_)
+            try
+            {
+                sourceMd5Stream.emplace(); //throw SysError
+            }
+            catch (const SysError& e) { statReporter.logMessage(e.toString(), PhaseCallback::MsgType::warning); /*throw ThreadStopRequest*/ } //=> fall back to full comparison
+
+        auto notifySourceData = [&](const void* buffer, size_t bytes) //callback runs *outside* singleThread_ lock! => fine
+        {
+            sampleStream.update(buffer, bytes);
+            if (sourceMd5Stream)
+            {
+                sourceMd5Stream->update(buffer, bytes);
+                sourceBytesHashed += bytes;
+            }
+        };
+
         //already existing + no onDeleteTargetFile: undefined behavior! (e.g. fail/overwrite/auto-rename)
         const AFS::FileCopyResult result = parallel::copyFileTransactional(sourcePathTmp, sourceAttr, //throw FileError, ErrorFileLocked, ThreadStopRequest, X
                                                                            targetPath,
@@ -2296,7 +2496,7 @@ AFS::FileCopyResult FolderPairSyncer::copyFileWithCallback(const FileDescriptor&
             percentReporter.updateDeltaAndStatus(bytesDelta); //throw ThreadStopRequest
             interruptionPoint(); //throw ThreadStopRequest => not reliably covered by PercentStatReporter::updateDeltaAndStatus()!
         },
-        singleThread_);
+        notifySourceData, singleThread_);
 
         //#################### Verification #############################
         if (verifyCopiedFiles_)
@@ -2310,10 +2510,17 @@ AFS::FileCopyResult FolderPairSyncer::copyFileWithCallback(const FileDescriptor&
             //callback runs *outside* singleThread_ lock! => fine
             auto verifyCallback = [&](int64_t bytesDelta) { interruptionPoint(); }; //throw ThreadStopRequest
 
-            parallel::verifyFiles(sourcePathTmp, targetPath, verifyCallback, singleThread_); //throw FileError, ThreadStopRequest
+            //source hash is incomplete for server-side copies (e.g. within Google Drive) => verifyFiles() falls back
+            std::optional<std::string> sourceMd5;
+            if (sourceMd5Stream && sourceBytesHashed == result.fileSize)
+                try { sourceMd5 = sourceMd5Stream->finalize(); /*throw SysError*/ }
+                catch (const SysError& e) { statReporter.logMessage(e.toString(), PhaseCallback::MsgType::warning); /*throw ThreadStopRequest*/ }
+
+            parallel::verifyFiles(sourcePathTmp, targetPath, result.fileSize, sourceMd5, verifyCallback, singleThread_); //throw FileError, ThreadStopRequest
         }
         //#################### /Verification #############################
 
+        contentSample = result.fileSize == sourceDescr.attr.fileSize ? sampleStream.finalize() : 0; //0 if source data not seen (e.g. server-side copy)
         return result;
     };
 
@@ -2425,6 +2632,7 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
                       bool runWithBackgroundPriority,
                       const std::vector<FolderPairSyncCfg>& syncConfig,
                       FolderComparison& folderCmp,
+                      const std::map<AfsDevice, size_t>& deviceParallelOps,
                       WarningDialogs& warnings,
                       ProcessCallback& callback /*throw X*/) //throw X
 {
@@ -2614,10 +2822,8 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
         checkVersioningBasePaths.emplace_back(baseFolder.getAbstractPath<SelectSide::right>(), &baseFolder.getFilter());
 
         //prepare: versioning folder paths differing only in case
-        if (folderPairCfg.handleDeletion == DeletionVariant::versioning &&
-            folderPairCfg.versioningStyle != VersioningStyle::replace)
-            if (folderPairCfg.versionMaxAgeDays > 0 || folderPairCfg.versionCountMax > 0) //same check as in applyVersioningLimit()
-                checkVersioningLimitPaths.insert(versioningFolderPath);
+        if (hasVersioningLimits(folderPairCfg))
+            checkVersioningLimitPaths.insert(versioningFolderPath);
 
         //check if more than 50% of total number of files/dirs will be created/overwritten/deleted
         if (significantDifferenceDetected(folderPairStat))
@@ -2848,6 +3054,7 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
     //-------------------end of basic checks------------------------------------------
 
     std::set<VersioningLimitFolder> versionLimitFolders;
+    std::map<AbstractPath, VersionIndexDelta> versionIndexDeltas;
 
     bool recyclerMissingReportOnce = false; //prompt user only *once* per sync, not per failed item!
 
@@ -2867,6 +3074,7 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
         void reportWarning(const std::wstring& msg, bool& warningActive) override { logMessage(msg, MsgType::warning); /*ignore*/ }
         Response reportError     (const ErrorInfo& errorInfo)            override { logMessage(errorInfo.msg, MsgType::error); return Response::ignore; }
         void     reportFatalError(const std::wstring& msg)               override { logMessage(msg, MsgType::error); /*ignore*/ }
+        std::optional<ErrorPolicy> getErrorPolicy() const                override { return ErrorPolicy(); } //always ignore
 
     private:
         ProcessCallback& cb_;
@@ -2874,6 +3082,27 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
 
     try
     {
+        //claim version indexes before creating the first version: no limits => no index
+        {
+            std::set<AbstractPath> versioningFolderPaths;
+
+            for (size_t folderIndex = 0; folderIndex < folderCmp.size(); ++folderIndex)
+                if (!skipFolderPair[folderIndex] && getCUD(folderPairStats[folderIndex]) > 0)
+                    if (const FolderPairSyncCfg& folderPairCfg = syncConfig[folderIndex];
+                        hasVersioningLimits(folderPairCfg))
+                        versioningFolderPaths.insert(createAbstractPath(folderPairCfg.versioningFolderPhrase));
+
+            versionIndexDeltas = claimVersionIndex(versioningFolderPaths, deviceParallelOps,
+                                                   callback /*throw X*/); //throw X
+        }
+
+        //segmented transfer of large files: extra connections only for devices with explicitly configured parallel operations
+        //=> all of them shared by the file transfers: stay within what the user allows for the server
+        for (const auto& [afsDevice, parallelOps] : deviceParallelOps)
+            setDeviceTransferSessionsMax(afsDevice, parallelOps > 1 ? parallelOps - 1 : 0);
+        ZEN_ON_SCOPE_EXIT(for (const auto& [afsDevice, parallelOps] : deviceParallelOps)
+                              setDeviceTransferSessionsMax(afsDevice, 0));
+
         //loop through all directory pairs
         for (size_t folderIndex = 0; folderIndex < folderCmp.size(); ++folderIndex)
         {
@@ -2902,7 +3131,7 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
             auto guardDbSave = makeGuard<ScopeGuardRunMode::onFail>([&]
             {
                 if (folderPairCfg.saveSyncDB)
-                    saveLastSynchronousState(baseFolder, failSafeFileCopy,
+                    saveLastSynchronousState(baseFolder, failSafeFileCopy, deviceParallelOps,
                                              callbackNoThrow);
             });
 
@@ -2933,7 +3162,9 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
                                             folderPairCfg.handleDeletion,
                                             versioningFolderPath,
                                             folderPairCfg.versioningStyle,
-                                            std::chrono::system_clock::to_time_t(syncStartTime));
+                                            hasVersioningLimits(folderPairCfg),
+                                            std::chrono::system_clock::to_time_t(syncStartTime),
+                                            getDeviceParallelOps(deviceParallelOps, versioningFolderPath.afsDevice));
 
                 DeletionHandler delHandlerR(baseFolder.getAbstractPath<SelectSide::right>(),
                                             recyclerMissingReportOnce,
@@ -2941,7 +3172,9 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
                                             folderPairCfg.handleDeletion,
                                             versioningFolderPath,
                                             folderPairCfg.versioningStyle,
-                                            std::chrono::system_clock::to_time_t(syncStartTime));
+                                            hasVersioningLimits(folderPairCfg),
+                                            std::chrono::system_clock::to_time_t(syncStartTime),
+                                            getDeviceParallelOps(deviceParallelOps, versioningFolderPath.afsDevice));
 
                 //always (try to) clean up, even if synchronization is aborted!
                 auto guardDelCleanup = makeGuard<ScopeGuardRunMode::onFail>([&]
@@ -2955,6 +3188,7 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
                 {
                     verifyCopiedFiles, copyPermissionsFp, failSafeFileCopy,
                     delHandlerL, delHandlerR,
+                    deviceParallelOps,
                 };
                 FolderPairSyncer::runSync(syncCtx, baseFolder, callback);
 
@@ -2963,28 +3197,37 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
                 delHandlerR.tryCleanup(callback); //
                 guardDelCleanup.dismiss();
 
-                if (folderPairCfg.handleDeletion == DeletionVariant::versioning &&
-                    folderPairCfg.versioningStyle != VersioningStyle::replace)
-                    versionLimitFolders.insert(
+                if (hasVersioningLimits(folderPairCfg))
                 {
-                    versioningFolderPath,
-                    folderPairCfg.versionMaxAgeDays,
-                    folderPairCfg.versionCountMin,
-                    folderPairCfg.versionCountMax
-                });
+                    versionLimitFolders.insert(
+                    {
+                        versioningFolderPath,
+                        folderPairCfg.versionMaxAgeDays,
+                        folderPairCfg.versionCountMin,
+                        folderPairCfg.versionCountMax
+                    });
+
+                    VersionIndexDelta& indexDelta = versionIndexDeltas[versioningFolderPath];
+                    for (const DeletionHandler* delHandler : {&delHandlerL, &delHandlerR})
+                    {
+                        const VersionIndexDelta delta = delHandler->getVersionIndexDelta();
+                        append(indexDelta.newItems, delta.newItems);
+                        indexDelta.incomplete |= delta.incomplete;
+                    }
+                }
             }
 
             //(try to gracefully) write database file
             if (folderPairCfg.saveSyncDB)
             {
-                saveLastSynchronousState(baseFolder, failSafeFileCopy,
+                saveLastSynchronousState(baseFolder, failSafeFileCopy, deviceParallelOps,
                                          callback /*throw X*/); //throw X
                 guardDbSave.dismiss(); //[!] dismiss *after* "graceful" try: user might cancel during DB write: ensure DB is still written
             }
         }
         //-----------------------------------------------------------------------------------------------------
 
-        applyVersioningLimit(versionLimitFolders,
+        applyVersioningLimit(versionLimitFolders, versionIndexDeltas, deviceParallelOps,
                              callback /*throw X*/); //throw X
     }
     catch (const std::exception& e)
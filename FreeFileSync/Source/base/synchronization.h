@@ -42,12 +42,16 @@ public:
     int conflictCount() const { return conflictCount_; }
 
 private:
-    void recurse(const ContainerObject& conObj);
+    SyncStatistics() {}
+
+    void recurse       (const ContainerObject& conObj);
+    void processShallow(const ContainerObject& conObj); //direct child files and symlinks only
+    void merge(const SyncStatistics& other);
     void logConflict(const FileSystemObject& fsObj);
 
     void processFile  (const FilePair& file);
     void processLink  (const SymlinkPair& symlink);
-    void processFolder(const FolderPair& folder);
+    void processFolder(const FolderPair& folder); //folder only, not its child items
 
     int createLeft_  = 0;
     int createRight_ = 0;
@@ -96,6 +100,7 @@ void synchronize(const std::chrono::system_clock::time_point& syncStartTime,
                  bool runWithBackgroundPriority,
                  const std::vector<FolderPairSyncCfg>& syncConfig, //CONTRACT: syncConfig and folderCmp correspond row-wise!
                  FolderComparison& folderCmp,                      //
+                 const std::map<AfsDevice, size_t>& deviceParallelOps,
                  WarningDialogs& warnings,
                  ProcessCallback& callback /*throw X*/); //throw X
 }
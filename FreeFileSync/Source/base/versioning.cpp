@@ -5,6 +5,9 @@
 // *****************************************************************************
 
 #include "versioning.h"
+#include <zen/crc.h>
+#include <zen/guid.h>
+#include <zen/zlib_wrap.h>
 #include "parallel_scan.h"
 #include "status_handler_impl.h"
 #include "dir_exist_async.h"
@@ -73,7 +76,7 @@ time_t fff::impl::parseVersionedFolderName(const Zstring& folderName)
 }
 
 
-AbstractPath FileVersioner::generateVersionedPath(const Zstring& relativePath) const
+Zstring FileVersioner::generateVersionedRelPath(const Zstring& relativePath) const
 {
     assert(isValidRelPath(relativePath));
     assert(!relativePath.empty());
@@ -93,7 +96,45 @@ AbstractPath FileVersioner::generateVersionedPath(const Zstring& relativePath) c
                    std::pair(syncStartTime_, getItemName(relativePath)));
             break;
     }
-    return AFS::appendRelPath(versioningFolderPath_, versionedRelPath);
+    return versionedRelPath;
+}
+
+
+void FileVersioner::addToVersionIndex(const Zstring& versionedRelPath, bool isSymlink) const
+{
+    if (versioningLimits_) //no versioning limits => no index needed
+        indexDelta_.access([&](VersionIndexDelta& delta) { delta.newItems.emplace_back(versionedRelPath, isSymlink); });
+}
+
+
+void FileVersioner::addFolderToVersionIndex(const Zstring& versionedRelPath) const //noexcept
+{
+    if (!versioningLimits_)
+        return;
+
+    std::vector<std::pair<Zstring, bool /*isSymlink*/>> newItems;
+    try
+    {
+        [&](this const auto& self, const Zstring& relPath) -> void //throw FileError
+        {
+            std::vector<Zstring> folderNames;
+
+            AFS::traverseFolder(AFS::appendRelPath(versioningFolderPath_, relPath), //throw FileError
+            [&](const AFS::FileInfo&    fi) { newItems.emplace_back(appendPath(relPath, fi.itemName), false); },
+            [&](const AFS::FolderInfo&  fi) { folderNames.push_back(fi.itemName); },
+            [&](const AFS::SymlinkInfo& si) { newItems.emplace_back(appendPath(relPath, si.itemName), true); });
+
+            for (const Zstring& folderName : folderNames)
+                self(appendPath(relPath, folderName)); //throw FileError
+        }(versionedRelPath);
+    }
+    catch (FileError&) //versions not recorded would be missed => rebuild index
+    {
+        indexDelta_.access([](VersionIndexDelta& delta) { delta.incomplete = true; });
+        return;
+    }
+
+    indexDelta_.access([&](VersionIndexDelta& delta) { append(delta.newItems, newItems); });
 }
 
 
@@ -218,7 +259,8 @@ void FileVersioner::revisionFileImpl(const FileDescriptor& fileDescr, const Zstr
 {
     const AbstractPath& filePath = fileDescr.path;
 
-    const AbstractPath targetPath = generateVersionedPath(relativePath);
+    const Zstring targetRelPath = generateVersionedRelPath(relativePath);
+    const AbstractPath targetPath = AFS::appendRelPath(versioningFolderPath_, targetRelPath);
     const AFS::StreamAttributes fileAttr{fileDescr.attr.modTime, fileDescr.attr.fileSize, fileDescr.attr.filePrint};
 
     if (onBeforeMove)
@@ -232,9 +274,11 @@ void FileVersioner::revisionFileImpl(const FileDescriptor& fileDescr, const Zstr
         /*const AFS::FileCopyResult result =*/ AFS::copyFileTransactional(filePath, fileAttr, targetPath, //throw FileError, ErrorFileLocked, X
                                                                           false, //copyFilePermissions
                                                                           false,  //transactionalCopy: not needed for versioning! partial copy will be overwritten next time
-                                                                          nullptr /*onDeleteTargetFile*/, notifyUnbufferedIO);
+                                                                          nullptr /*onDeleteTargetFile*/, notifyUnbufferedIO, nullptr /*notifySourceData*/);
         //result.errorModTime? => irrelevant for versioning!
     });
+
+    addToVersionIndex(targetRelPath, false /*isSymlink*/);
 }
 
 
@@ -251,16 +295,97 @@ void FileVersioner::revisionSymlink(const AbstractPath& linkPath, const Zstring&
 void FileVersioner::revisionSymlinkImpl(const AbstractPath& linkPath, const Zstring& relativePath, //throw FileError
                                         const std::function<void(const std::wstring& displayPathFrom, const std::wstring& displayPathTo)>& onBeforeMove) const
 {
-
-    const AbstractPath targetPath = generateVersionedPath(relativePath);
+    const Zstring targetRelPath = generateVersionedRelPath(relativePath);
+    const AbstractPath targetPath = AFS::appendRelPath(versioningFolderPath_, targetRelPath);
 
     if (onBeforeMove)
         onBeforeMove(AFS::getDisplayPath(linkPath), AFS::getDisplayPath(targetPath));
 
     moveExistingItemToVersioning(linkPath, targetPath, [&] { AFS::copySymlink(linkPath, targetPath, false /*copy filesystem permissions*/); }); //throw FileError
+
+    addToVersionIndex(targetRelPath, true /*isSymlink*/);
 }
 
 
+/*  move items on up to "parallelOps" threads:
+    - callbacks are called on the calling thread only: e.g. AsyncCallback::updateStatus() requires a sync worker thread
+    - first error is rethrown on the calling thread; remaining moves are stopped when ItemMover goes out of scope   */
+class FileVersioner::ItemMover
+{
+public:
+    ItemMover(size_t parallelOps, const IoCallback& notifyUnbufferedIO) :
+        parallelOps_(parallelOps),
+        notifyUnbufferedIO_(notifyUnbufferedIO) {}
+
+    void run(std::function<void(const IoCallback& notifyUnbufferedIO)>&& moveItem) //throw FileError, X
+    {
+        if (parallelOps_ == 1) //no threads needed
+            return moveItem(notifyUnbufferedIO_); //throw FileError, X
+
+        waitUntil([&] { return itemsPending_ < parallelOps_; }); //throw FileError, X
+        {
+            std::lock_guard dummy(lockItems_);
+            ++itemsPending_;
+        }
+
+        threadGroup_.run([this, moveItem = std::move(moveItem)]
+        {
+            std::exception_ptr itemError;
+            try
+            {
+                moveItem([this](int64_t bytesDelta) { bytesDelta_ += bytesDelta; interruptionPoint(); }); //throw FileError, ThreadStopRequest
+            }
+            catch (...) { itemError = std::current_exception(); }
+            {
+                std::lock_guard dummy(lockItems_);
+                --itemsPending_;
+                if (itemError && !firstError_)
+                    firstError_ = itemError;
+            }
+            conditionItemDone_.notify_all();
+        });
+    }
+
+    void waitAll() { waitUntil([&] { return itemsPending_ == 0; }); } //throw FileError, X
+
+private:
+    ItemMover           (const ItemMover&) = delete;
+    ItemMover& operator=(const ItemMover&) = delete;
+
+    template <class Predicate>
+    void waitUntil(Predicate pred) //throw FileError, X
+    {
+        for (;;)
+        {
+            if (const int64_t bytesDelta = bytesDelta_.exchange(0); bytesDelta != 0)
+                if (notifyUnbufferedIO_) notifyUnbufferedIO_(bytesDelta); //throw X
+
+            interruptionPoint(); //throw ThreadStopRequest
+
+            std::unique_lock dummy(lockItems_);
+            if (firstError_)
+                std::rethrow_exception(firstError_); //throw FileError, ThreadStopRequest
+
+            if (pred())
+                return;
+
+            conditionItemDone_.wait_for(dummy, UI_UPDATE_INTERVAL / 2); //report copied bytes in the meantime
+        }
+    }
+
+    const size_t parallelOps_;
+    const IoCallback notifyUnbufferedIO_;
+
+    std::mutex lockItems_;
+    std::condition_variable conditionItemDone_;
+    size_t itemsPending_ = 0;
+    std::exception_ptr firstError_;
+    std::atomic<int64_t> bytesDelta_{0};
+
+    ThreadGroup<std::function<void()>> threadGroup_{parallelOps_, Zstr("Versioning")}; //declare last: stop and join threads *before* members above are destroyed
+};
+
+
 void FileVersioner::revisionFolder(const AbstractPath& folderPath, const Zstring& relativePath, //throw FileError, X
                                    const std::function<void(const std::wstring& displayPathFrom, const std::wstring& displayPathTo)>& onBeforeFileMove   /*throw X*/,
                                    const std::function<void(const std::wstring& displayPathFrom, const std::wstring& displayPathTo)>& onBeforeFolderMove /*throw X*/,
@@ -275,18 +400,62 @@ void FileVersioner::revisionFolder(const AbstractPath& folderPath, const Zstring
 
         if (*type == AFS::ItemType::symlink) //on Linux there is just one type of symlink, and since we do revision file symlinks, we should revision dir symlinks as well!
             revisionSymlinkImpl(folderPath, relativePath, onBeforeFileMove); //throw FileError
+        else if (tryMoveFolderAsWhole(folderPath, relativePath))
+        {
+            if (onBeforeFolderMove) onBeforeFolderMove(AFS::getDisplayPath(folderPath), AFS::getDisplayPath(generateVersionedPath(relativePath)));
+        }
         else
-            revisionFolderImpl(folderPath, relativePath, onBeforeFileMove, onBeforeFolderMove, notifyUnbufferedIO); //throw FileError, X
+        {
+            ItemMover itemMover(parallelOps_, notifyUnbufferedIO);
+            revisionFolderImpl(folderPath, relativePath, onBeforeFileMove, onBeforeFolderMove, itemMover); //throw FileError, X
+        }
     }
     else //even if the folder does not exist anymore, significant I/O work was done => report
         if (onBeforeFolderMove) onBeforeFolderMove(AFS::getDisplayPath(folderPath), AFS::getDisplayPath(AFS::appendRelPath(versioningFolderPath_, relativePath)));
 }
 
 
+bool FileVersioner::tryMoveFolderAsWhole(const AbstractPath& folderPath, const Zstring& relativePath) const //noexcept
+{
+    //VersioningStyle::timestampFile: every file needs a new name
+    if (versioningStyle_ == VersioningStyle::timestampFile)
+        return false;
+
+    const Zstring targetRelPath = generateVersionedRelPath(relativePath);
+    const AbstractPath targetPath = AFS::appendRelPath(versioningFolderPath_, targetRelPath);
+    try
+    {
+        try
+        {
+            //already existing: fail (AFS::moveAndRenameItem() does not replace)
+            AFS::moveAndRenameItem(folderPath, targetPath); //throw FileError, ErrorMoveUnsupported
+        }
+        catch (ErrorMoveUnsupported&) { throw; }
+        catch (FileError&)
+        {
+            //target folder existing, e.g. older version with VersioningStyle::replace => merge item by item
+            if (AFS::itemExists(targetPath)) //throw FileError
+                return false;
+
+            //parent folder missing => create + retry
+            if (const std::optional<AbstractPath> targetParentPath = AFS::getParentPath(targetPath))
+                AFS::createFolderIfMissingRecursion(*targetParentPath); //throw FileError
+
+            AFS::moveAndRenameItem(folderPath, targetPath); //throw FileError, ErrorMoveUnsupported
+        }
+    }
+    catch (FileError&) { return false; } //e.g. ErrorMoveUnsupported: different devices
+    //or access denied for some child item (Windows: file in use) => per-item moves report the specific errors
+
+    addFolderToVersionIndex(targetRelPath); //noexcept
+    return true;
+}
+
+
 void FileVersioner::revisionFolderImpl(const AbstractPath& folderPath, const Zstring& relPath, //throw FileError, X
                                        const std::function<void(const std::wstring& displayPathFrom, const std::wstring& displayPathTo)>& onBeforeFileMove,
                                        const std::function<void(const std::wstring& displayPathFrom, const std::wstring& displayPathTo)>& onBeforeFolderMove,
-                                       const IoCallback& notifyUnbufferedIO /*throw X*/) const
+                                       ItemMover& itemMover) const
 {
 
     //create target directories only when needed in moveFileToVersioning(): avoid empty directories!
@@ -300,6 +469,7 @@ void FileVersioner::revisionFolderImpl(const AbstractPath& folderPath, const Zst
         [&](const AFS::FolderInfo&  fi) { folders .push_back(fi); },
         [&](const AFS::SymlinkInfo& si) { symlinks.push_back(si); });
 
+        //onBeforeFileMove is called here rather than in revisionFileImpl(): see ItemMover
         for (const AFS::FileInfo& fileInfo : files)
         {
             const FileDescriptor fileDescr
@@ -307,20 +477,40 @@ void FileVersioner::revisionFolderImpl(const AbstractPath& folderPath, const Zst
                 .path = AFS::appendRelPath(folderPath, fileInfo.itemName),
                 .attr = {fileInfo.modTime, fileInfo.fileSize, fileInfo.filePrint, false /*isFollowedSymlink*/},
             };
+            const Zstring relPathItem = appendPath(relPath, fileInfo.itemName);
+
+            if (onBeforeFileMove)
+                onBeforeFileMove(AFS::getDisplayPath(fileDescr.path), AFS::getDisplayPath(generateVersionedPath(relPathItem)));
 
-            revisionFileImpl(fileDescr, appendPath(relPath, fileInfo.itemName), onBeforeFileMove, notifyUnbufferedIO); //throw FileError, X
+            itemMover.run([this, fileDescr, relPathItem](const IoCallback& notifyUnbufferedIO)
+            {
+                revisionFileImpl(fileDescr, relPathItem, nullptr /*onBeforeMove*/, notifyUnbufferedIO); //throw FileError, X
+            });
         }
 
         for (const AFS::SymlinkInfo& linkInfo : symlinks)
-            revisionSymlinkImpl(AFS::appendRelPath(folderPath, linkInfo.itemName),
-                                appendPath(relPath, linkInfo.itemName), onBeforeFileMove); //throw FileError
+        {
+            const AbstractPath linkPath = AFS::appendRelPath(folderPath, linkInfo.itemName);
+            const Zstring relPathItem = appendPath(relPath, linkInfo.itemName);
+
+            if (onBeforeFileMove)
+                onBeforeFileMove(AFS::getDisplayPath(linkPath), AFS::getDisplayPath(generateVersionedPath(relPathItem)));
+
+            itemMover.run([this, linkPath, relPathItem](const IoCallback& /*notifyUnbufferedIO*/)
+            {
+                revisionSymlinkImpl(linkPath, relPathItem, nullptr /*onBeforeMove*/); //throw FileError
+            });
+        }
     }
 
     //move folders recursively
     for (const AFS::FolderInfo& folderInfo : folders)
         revisionFolderImpl(AFS::appendRelPath(folderPath, folderInfo.itemName), //throw FileError, X
                            appendPath(relPath, folderInfo.itemName),
-                           onBeforeFileMove, onBeforeFolderMove, notifyUnbufferedIO);
+                           onBeforeFileMove, onBeforeFolderMove, itemMover);
+
+    itemMover.waitAll(); //throw FileError, X
+
     //delete source
     if (onBeforeFolderMove)
         onBeforeFolderMove(AFS::getDisplayPath(folderPath), AFS::getDisplayPath(AFS::appendRelPath(versioningFolderPath_, relPath)));
@@ -332,70 +522,258 @@ void FileVersioner::revisionFolderImpl(const AbstractPath& folderPath, const Zst
 
 namespace
 {
-struct VersionInfo
+using VersionItems = std::unordered_map<Zstring, bool /*isSymlink*/>; //relPath (relative to versioning folder) => isSymlink
+
+struct VersionIndex
 {
-    time_t       versionTime = 0;
-    AbstractPath filePath;
-    bool         isSymlink = false;
+    VersionItems items;
+    time_t lastFullScan = 0; //versions added or removed by other means are only found by full scan
 };
-using VersionInfoMap = std::unordered_map<Zstring, std::vector<VersionInfo>>; //relPathOrig => <version infos>
 
-//subfolder\Sample.txt 2012-05-15 131513.txt  =>  subfolder\Sample.txt     version:2012-05-15 131513
-//2012-05-15 131513\subfolder\Sample.txt      =>          "                          "
+//-------------------------------------------------------------------------------------------
+const char VERSION_INDEX_DESCR[] = "FreeFileSync";
+const int VERSION_INDEX_VERSION = 2; //2026-10-18
+
+const int VERSION_INDEX_RESCAN_DAYS        = 30; //force full scan of the versioning folder every now and then
+const int VERSION_INDEX_CLAIM_TIMEOUT_DAYS = 7;  //claim marker remaining after cancelled/crashed sync: take over
+//-------------------------------------------------------------------------------------------
+
+//files beginning with dots are usually hidden; not a valid version name => ignored by full scan
+AbstractPath getVersionIndexPath     (const AbstractPath& versioningFolderPath) { return AFS::appendRelPath(versioningFolderPath, Zstr(".sync.ffs_versions")); }
+AbstractPath getVersionIndexDirtyPath(const AbstractPath& versioningFolderPath) { return AFS::appendRelPath(versioningFolderPath, Zstr(".sync.ffs_versions.dirty")); }
+
 
-void findFileVersions(VersionInfoMap& versions,
-                      const FolderContainer& folderCont,
-                      const AbstractPath& parentFolderPath,
-                      const Zstring& relPathOrigParent,
-                      const time_t* versionTimeParent)
+void saveBytes(const std::string& byteStream, const AbstractPath& filePath) //throw FileError
 {
-    auto addVersion = [&](const Zstring& fileName, const Zstring& fileNameOrig, time_t versionTime, bool isSymlink)
+    const std::unique_ptr<AFS::OutputStream> byteStreamOut = AFS::getOutputStream(filePath,
+                                                                                  byteStream.size(),
+                                                                                  std::nullopt /*modTime*/); //throw FileError
+    unbufferedSave(byteStream, [&](const void* buffer, size_t bytesToWrite)
     {
-        const Zstring& relPathOrig   = appendPath(relPathOrigParent, fileNameOrig);
-        const AbstractPath& filePath = AFS::appendRelPath(parentFolderPath, fileName);
+        return byteStreamOut->tryWrite(buffer, bytesToWrite, nullptr /*notifyUnbufferedIO*/); //throw FileError
+    },
+    byteStreamOut->getBlockSize()); //throw FileError
 
-        versions[relPathOrig].push_back(VersionInfo{versionTime, filePath, isSymlink});
-    };
+    byteStreamOut->finalize(nullptr /*notifyUnbufferedIO*/); //throw FileError
+}
+
+
+std::string loadBytes(const AbstractPath& filePath) //throw FileError
+{
+    const std::unique_ptr<AFS::InputStream> fileIn = AFS::getInputStream(filePath); //throw FileError, ErrorFileLocked
 
-    auto extractFileVersion = [&](const Zstring& fileName, bool isSymlink)
+    return unbufferedLoad<std::string>([&](void* buffer, size_t bytesToRead)
     {
-        if (versionTimeParent) //VersioningStyle::timestampFolder
-            addVersion(fileName, fileName, *versionTimeParent, isSymlink);
-        else
+        return fileIn->tryRead(buffer, bytesToRead, nullptr /*notifyUnbufferedIO*/); //throw FileError, ErrorFileLocked; may return short, only 0 means EOF!
+    },
+    fileIn->getBlockSize()); //throw FileError
+}
+
+
+void saveVersionIndex(const VersionItems& versionItems, time_t lastFullScan, const AbstractPath& versioningFolderPath) //throw FileError
+{
+    const AbstractPath indexPath = getVersionIndexPath(versioningFolderPath);
+
+    std::vector<const VersionItems::value_type*> itemsSorted; //deterministic output + better compression
+    itemsSorted.reserve(versionItems.size());
+    for (const auto& item : versionItems)
+        itemsSorted.push_back(&item);
+    std::sort(itemsSorted.begin(), itemsSorted.end(), [](const auto* lhs, const auto* rhs) { return lhs->first < rhs->first; });
+
+    MemoryStreamOut itemStreamOut;
+    writeNumber(itemStreamOut, static_cast<uint32_t>(itemsSorted.size()));
+    for (const auto* item : itemsSorted)
+    {
+        writeContainer(itemStreamOut, utfTo<std::string>(item->first));
+        writeNumber<int8_t>(itemStreamOut, item->second);
+    }
+
+    MemoryStreamOut memStreamOut;
+    writeArray(memStreamOut, VERSION_INDEX_DESCR, sizeof(VERSION_INDEX_DESCR));
+    writeNumber<int32_t>(memStreamOut, VERSION_INDEX_VERSION);
+    writeNumber<int64_t>(memStreamOut, lastFullScan);
+    try
+    {
+        writeContainer(memStreamOut, compress(itemStreamOut.ref(), 3 /*level*/)); //throw SysError
+    }
+    catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(AFS::getDisplayPath(indexPath))), e.toString()); }
+
+    writeNumber<uint32_t>(memStreamOut, getCrc32(memStreamOut.ref()));
+    //------------------------------------------------------------------------------------------------------------------------
+
+    //write temporary file first: never leave a truncated index behind
+    const Zstring shortGuid = printNumber<Zstring>(Zstr("%04x"), static_cast<unsigned int>(getCrc16(generateGUID())));
+    const AbstractPath tmpPath = AFS::appendRelPath(versioningFolderPath, AFS::getItemName(indexPath) + Zstr('.') + shortGuid + AFS::TEMP_FILE_ENDING);
+
+    saveBytes(memStreamOut.ref(), tmpPath); //throw FileError
+    ZEN_ON_SCOPE_FAIL(try { AFS::removeFilePlain(tmpPath); /*throw FileError*/ } catch (FileError&) {});
+
+    AFS::removeFileIfExists(indexPath);          //throw FileError
+    AFS::moveAndRenameItem(tmpPath, indexPath); //throw FileError, (ErrorMoveUnsupported)
+}
+
+
+VersionIndex loadVersionIndex(const AbstractPath& indexPath) //throw FileError
+{
+    const std::string byteStream = loadBytes(indexPath); //throw FileError
+    //------------------------------------------------------------------------------------------------------------------------
+    try
+    {
+        MemoryStreamIn memStreamIn(byteStream);
+
+        char formatDescr[sizeof(VERSION_INDEX_DESCR)] = {};
+        readArray(memStreamIn, formatDescr, sizeof(formatDescr)); //throw SysErrorUnexpectedEos
+
+        if (!std::equal(VERSION_INDEX_DESCR, VERSION_INDEX_DESCR + sizeof(VERSION_INDEX_DESCR), formatDescr))
+            throw SysError(_("File content is corrupted.") + L" (invalid header)");
+
+        const int version = readNumber<int32_t>(memStreamIn); //throw SysErrorUnexpectedEos
+        if (version != VERSION_INDEX_VERSION)
+            throw SysError(_("Unsupported data format.") + L' ' + replaceCpy(_("Version: %x"), L"%x", numberTo<std::wstring>(version)));
+
+        MemoryStreamOut crcStreamOut;
+        writeNumber<uint32_t>(crcStreamOut, getCrc32(byteStream.begin(), byteStream.end() - sizeof(uint32_t)));
+
+        if (!endsWith(byteStream, crcStreamOut.ref()))
+            throw SysError(_("File content is corrupted.") + L" (invalid checksum)");
+
+        VersionIndex versionIndex;
+        versionIndex.lastFullScan = readNumber<int64_t>(memStreamIn); //throw SysErrorUnexpectedEos
+
+        const std::string itemStream = decompress(readContainer<std::string>(memStreamIn)); //throw SysError, SysErrorUnexpectedEos
+        MemoryStreamIn itemStreamIn(itemStream);
+
+        size_t itemCount = readNumber<uint32_t>(itemStreamIn); //throw SysErrorUnexpectedEos
+        while (itemCount-- != 0)
         {
-            const std::pair<time_t, Zstring> vfn = fff::impl::parseVersionedFileName(fileName);
-            if (vfn.first != 0) //VersioningStyle::timestampFile
-                addVersion(fileName, vfn.second, vfn.first, isSymlink);
+            Zstring relPath = utfTo<Zstring>(readContainer<std::string>(itemStreamIn)); //throw SysErrorUnexpectedEos
+            const bool isSymlink = readNumber<int8_t>(itemStreamIn) != 0;               //
+
+            //items will be deleted => never leave the versioning folder!
+            if (relPath.empty() || !isValidRelPath(relPath) ||
+                std::ranges::any_of(splitCpy(relPath, FILE_NAME_SEPARATOR, SplitOnEmpty::allow), [](const Zstring& itemName) { return itemName == Zstr(".") || itemName == Zstr(".."); }))
+                throw SysError(_("File content is corrupted.") + L" (invalid path)");
+
+            versionIndex.items.emplace(std::move(relPath), isSymlink);
         }
-    };
+        return versionIndex;
+    }
+    catch (const SysError& e)
+    {
+        throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(AFS::getDisplayPath(indexPath))), e.toString());
+    }
+}
+
+
+//claim marker: folder containing a single file named after the claim id: <time of claim>; no CRC: anything unexpected is just a stale claim
+//=> published by renaming a temporary folder: fails if marker already exists => no race between concurrent syncs (unlike "check existence, then write")
+bool tryPublishClaimMarker(const AbstractPath& versioningFolderPath, const Zstring& claimId, time_t claimTime) //throw FileError
+{
+    const AbstractPath markerPath = getVersionIndexDirtyPath(versioningFolderPath);
+    const AbstractPath tmpPath = AFS::appendRelPath(versioningFolderPath, AFS::getItemName(markerPath) + Zstr('.') + claimId + AFS::TEMP_FILE_ENDING);
 
+    AFS::createFolderPlain(tmpPath); //throw FileError
+    ZEN_ON_SCOPE_FAIL(try { AFS::removeFolderIfExistsRecursion(tmpPath, nullptr, nullptr, nullptr); /*throw FileError*/ } catch (FileError&) {});
+
+    MemoryStreamOut memStreamOut;
+    writeArray(memStreamOut, VERSION_INDEX_DESCR, sizeof(VERSION_INDEX_DESCR));
+    writeNumber<int64_t>(memStreamOut, claimTime);
+
+    saveBytes(memStreamOut.ref(), AFS::appendRelPath(tmpPath, claimId)); //throw FileError
+    try
+    {
+        AFS::moveAndRenameItem(tmpPath, markerPath); //throw FileError, ErrorMoveUnsupported: not overwriting existing (non-empty) folder
+        return true;
+    }
+    catch (FileError&)
+    {
+        if (!AFS::itemExists(markerPath)) //throw FileError
+            throw;
+    }
+    //claimed by other sync meanwhile
+    AFS::removeFolderIfExistsRecursion(tmpPath, nullptr, nullptr, nullptr); //throw FileError
+    return false;
+}
+
+
+std::pair<Zstring /*claimId*/, time_t /*claimTime*/> loadClaimMarker(const AbstractPath& markerPath) //throw FileError; claim time 0 if corrupted
+{
+    std::vector<Zstring> claimIds;
+    AFS::traverseFolder(markerPath, [&](const AFS::FileInfo& fi) { claimIds.push_back(fi.itemName); }, nullptr, nullptr); //throw FileError
+
+    if (claimIds.size() != 1) //empty: crashed during takeover
+        return {claimIds.empty() ? Zstring() : claimIds[0], 0};
+
+    const std::string byteStream = loadBytes(AFS::appendRelPath(markerPath, claimIds[0])); //throw FileError
+    try
+    {
+        MemoryStreamIn memStreamIn(byteStream);
+
+        char formatDescr[sizeof(VERSION_INDEX_DESCR)] = {};
+        readArray(memStreamIn, formatDescr, sizeof(formatDescr)); //throw SysErrorUnexpectedEos
+
+        if (!std::equal(VERSION_INDEX_DESCR, VERSION_INDEX_DESCR + sizeof(VERSION_INDEX_DESCR), formatDescr))
+            return {claimIds[0], 0};
+
+        return {claimIds[0], readNumber<int64_t>(memStreamIn)}; //throw SysErrorUnexpectedEos
+    }
+    catch (SysErrorUnexpectedEos&) { return {claimIds[0], 0}; }
+}
+
+
+void releaseClaimMarker(const AbstractPath& markerPath, const Zstring& claimId) //throw FileError
+{
+    //claim file missing: stale claim was taken over by another sync (e.g. after timeout) => not ours to delete!
+    if (AFS::itemExists(AFS::appendRelPath(markerPath, claimId))) //throw FileError
+    {
+        AFS::removeFilePlain  (AFS::appendRelPath(markerPath, claimId)); //throw FileError
+        AFS::removeFolderPlain(markerPath);                              //
+    }
+}
+
+
+void getVersionItems(VersionItems& versionItems, const FolderContainer& folderCont, const Zstring& parentRelPath)
+{
     for (const auto& [fileName, attr] : folderCont.files)
-        extractFileVersion(fileName, false /*isSymlink*/);
+        versionItems.emplace(appendPath(parentRelPath, fileName), false /*isSymlink*/);
 
     for (const auto& [linkName, attr] : folderCont.symlinks)
-        extractFileVersion(linkName, true /*isSymlink*/);
+        versionItems.emplace(appendPath(parentRelPath, linkName), true /*isSymlink*/);
 
     for (const auto& [folderName, attrAndSub] : folderCont.folders)
-    {
-        if (relPathOrigParent.empty() && !versionTimeParent) //VersioningStyle::timestampFolder?
+        getVersionItems(versionItems, attrAndSub.second, appendPath(parentRelPath, folderName));
+}
+
+
+struct VersionInfo
+{
+    time_t  versionTime = 0;
+    Zstring relPath; //relative to versioning folder
+    bool    isSymlink = false;
+};
+using VersionInfoMap = std::unordered_map<Zstring, std::vector<VersionInfo>>; //relPathOrig => <version infos>
+
+//subfolder\Sample.txt 2012-05-15 131513.txt  =>  subfolder\Sample.txt     version:2012-05-15 131513
+//2012-05-15 131513\subfolder\Sample.txt      =>          "                          "
+bool addFileVersion(VersionInfoMap& versions, const Zstring& relPath, bool isSymlink) //returns false if not a file version
+{
+    //VersioningStyle::timestampFolder?
+    if (const Zstring folderName = beforeFirst(relPath, FILE_NAME_SEPARATOR, IfNotFoundReturn::none);
+        !folderName.empty())
+        if (const time_t versionTime = fff::impl::parseVersionedFolderName(folderName);
+            versionTime != 0)
         {
-            assert(!versionTimeParent);
-            const time_t versionTime = fff::impl::parseVersionedFolderName(folderName);
-            if (versionTime != 0)
-            {
-                findFileVersions(versions, attrAndSub.second,
-                                 AFS::appendRelPath(parentFolderPath, folderName),
-                                 Zstring(), //[!] skip time-stamped folder
-                                 &versionTime);
-                continue;
-            }
+            versions[afterFirst(relPath, FILE_NAME_SEPARATOR, IfNotFoundReturn::none)].push_back(VersionInfo{versionTime, relPath, isSymlink}); //[!] skip time-stamped folder
+            return true;
         }
 
-        findFileVersions(versions, attrAndSub.second,
-                         AFS::appendRelPath(parentFolderPath, folderName),
-                         appendPath(relPathOrigParent, folderName),
-                         versionTimeParent);
-    }
+    //VersioningStyle::timestampFile?
+    const auto [versionTime, fileNameOrig] = fff::impl::parseVersionedFileName(getItemName(relPath));
+    if (versionTime == 0)
+        return false;
+
+    versions[appendPath(beforeLast(relPath, FILE_NAME_SEPARATOR, IfNotFoundReturn::none), fileNameOrig)].push_back(VersionInfo{versionTime, relPath, isSymlink});
+    return true;
 }
 
 
@@ -427,26 +805,126 @@ std::weak_ordering fff::operator<=>(const VersioningLimitFolder& lhs, const Vers
 }
 
 
+std::map<AbstractPath, VersionIndexDelta> fff::claimVersionIndex(const std::set<AbstractPath>& versioningFolderPaths,
+                                                                 const std::map<AfsDevice, size_t>& deviceParallelOps,
+                                                                 PhaseCallback& callback /*throw X*/) //throw X
+{
+    std::map<AbstractPath, VersionIndexDelta> versionIndexDeltas;
+    std::vector<std::pair<AbstractPath, ParallelWorkItem>> parallelWorkload;
+
+    const time_t now = std::time(nullptr);
+
+    for (const AbstractPath& folderPath : versioningFolderPaths)
+        parallelWorkload.emplace_back(folderPath, [now, &indexDelta = versionIndexDeltas[folderPath]](ParallelContext& ctx) //throw ThreadStopRequest
+    {
+        try
+        {
+            const AbstractPath markerPath = getVersionIndexDirtyPath(ctx.itemPath);
+            const Zstring claimId = printNumber<Zstring>(Zstr("%08x"), static_cast<unsigned int>(getCrc32(generateGUID())));
+
+            if (!tryPublishClaimMarker(ctx.itemPath, claimId, now)) //throw FileError
+            {
+                //claimed by other sync (e.g. concurrent FreeFileSync instance) => leave index alone, full scan during applyVersioningLimit()
+                const auto& [otherClaimId, claimTime] = loadClaimMarker(markerPath); //throw FileError
+                if (claimTime <= now && now - claimTime < VERSION_INDEX_CLAIM_TIMEOUT_DAYS * 24 * 3600)
+                    return;
+
+                //stale claim: previous sync was cancelled or crashed => index is missing its versions
+                //take over: only one sync succeeds deleting the stale claim file; a fresh marker holds a different claim id => fails
+                if (!otherClaimId.empty())
+                    AFS::removeFilePlain(AFS::appendRelPath(markerPath, otherClaimId)); //throw FileError
+                AFS::removeFolderPlain(markerPath);                        //throw FileError
+                AFS::removeFileIfExists(getVersionIndexPath(ctx.itemPath)); //
+
+                if (!tryPublishClaimMarker(ctx.itemPath, claimId, now)) //throw FileError
+                    return;
+            }
+            indexDelta.claimId = claimId;
+        }
+        catch (FileError&) {} //e.g. versioning folder not (yet) existing => no need to report: applyVersioningLimit() will do a full scan when needed
+    });
+
+    massParallelExecute(parallelWorkload, deviceParallelOps,
+                        Zstr("Claim Version Index"), callback /*throw X*/); //throw X
+    return versionIndexDeltas;
+}
+
+
 void fff::applyVersioningLimit(const std::set<VersioningLimitFolder>& folderLimits,
+                               const std::map<AbstractPath, VersionIndexDelta>& versionIndexDeltas,
+                               const std::map<AfsDevice, size_t>& deviceParallelOps,
                                PhaseCallback& callback /*throw X*/) //throw X
 {
-    //--------- determine existing folder paths for traversal ---------
-    std::set<DirectoryKey> foldersToRead;
+    std::set<AbstractPath> limitFolderPaths;
     std::set<VersioningLimitFolder> folderLimitsTmp;
+
+    for (const VersioningLimitFolder& vlf : folderLimits)
+        if (vlf.versionMaxAgeDays > 0 || vlf.versionCountMax > 0) //only analyze versioning folders when needed!
+        {
+            limitFolderPaths.insert(vlf.versioningFolderPath);
+            folderLimitsTmp.insert(vlf);
+        }
+
+    std::map<AbstractPath, VersionItems> versionItems; //versioningFolderPath => <versions from index or full scan>
+    std::map<AbstractPath, time_t> lastFullScanTimes;  //
+    std::set<AbstractPath> claimedFolders;             //only the sync owning the claim may read, write or delete the index!
+    std::set<AbstractPath> indexedFolders;             //versions taken from index => no item counts from full scan
+    std::set<AbstractPath> indexesToSave;
+    const time_t now = std::time(nullptr);
+
+    for (const auto& [folderPath, indexDelta] : versionIndexDeltas)
+        if (!indexDelta.claimId.empty())
+            claimedFolders.insert(folderPath);
+
+    //--------- load version indexes ---------
     {
-        std::set<AbstractPath> pathsToCheck;
+        std::map<AbstractPath, std::optional<VersionIndex>> loadedIndexes; //one entry per task => no locking needed
+        std::vector<std::pair<AbstractPath, ParallelWorkItem>> parallelWorkload;
 
-        for (const VersioningLimitFolder& vlf : folderLimits)
-            if (vlf.versionMaxAgeDays > 0 || vlf.versionCountMax > 0) //only analyze versioning folders when needed!
+        for (const AbstractPath& folderPath : claimedFolders)
+            if (!versionIndexDeltas.find(folderPath)->second.incomplete) //else: index is missing new versions => rebuild from full scan
+                parallelWorkload.emplace_back(folderPath, [&loadedIndex = loadedIndexes[folderPath]](ParallelContext& ctx) //throw ThreadStopRequest
             {
-                pathsToCheck.insert(vlf.versioningFolderPath);
-                folderLimitsTmp.insert(vlf);
+                try
+                {
+                    loadedIndex = loadVersionIndex(getVersionIndexPath(ctx.itemPath)); //throw FileError
+                }
+                catch (FileError&) {} //not yet existing, or corrupted => full scan (and overwrite)
+            });
+
+        massParallelExecute(parallelWorkload, deviceParallelOps,
+                            Zstr("Load Version Index"), callback /*throw X*/); //throw X
+
+        for (auto& [folderPath, loadedIndex] : loadedIndexes)
+            if (loadedIndex &&
+                loadedIndex->lastFullScan <= now && now - loadedIndex->lastFullScan < VERSION_INDEX_RESCAN_DAYS * 24 * 3600) //else: full scan is due
+            {
+                VersionItems& items = versionItems[folderPath];
+                items = std::move(loadedIndex->items);
+
+                for (const auto& [relPath, isSymlink] : versionIndexDeltas.find(folderPath)->second.newItems)
+                    items.insert_or_assign(relPath, isSymlink);
+
+                lastFullScanTimes[folderPath] = loadedIndex->lastFullScan;
+                indexedFolders.insert(folderPath);
+                indexesToSave.insert(folderPath);
             }
+    }
+
+    //--------- determine existing folder paths for traversal ---------
+    std::set<DirectoryKey> foldersToRead;
+    {
+        std::set<AbstractPath> pathsToCheck;
+
+        for (const AbstractPath& folderPath : limitFolderPaths)
+            if (!indexedFolders.contains(folderPath)) //full scan only if needed!
+                pathsToCheck.insert(folderPath);
 
         //what if versioning folder paths differ only in case? => perf pessimization, but already checked, see fff::synchronize()
 
         //we don't want to show an error if version path does not yet exist!
-        tryReportingError([&]
+        if (!pathsToCheck.empty())
+            tryReportingError([&]
         {
             const FolderStatus status = getFolderStatusParallel(pathsToCheck,
                                                                 false /*authenticateAccess*/, nullptr /*requestPassword*/, callback); //throw X
@@ -470,7 +948,7 @@ void fff::applyVersioningLimit(const std::set<VersioningLimitFolder>& folderLimi
         }, callback); //throw X
     }
 
-    //--------- traverse all versioning folders ---------
+    //--------- traverse all versioning folders (without index) ---------
     const std::wstring textScanning = _("Searching for old file versions:") + L' ';
 
     auto onStatusUpdate = [&](const std::wstring& statusLine, int itemsTotal)
@@ -478,25 +956,26 @@ void fff::applyVersioningLimit(const std::set<VersioningLimitFolder>& folderLimi
         callback.updateStatus(textScanning + statusLine); //throw X
     };
 
-    const std::map<DirectoryKey, DirectoryValue> folderBuf = parallelFolderScan(foldersToRead,
-    [&](const PhaseCallback::ErrorInfo& errorInfo) { return callback.reportError(errorInfo); } /*throw X*/,
-    onStatusUpdate /*throw X*/, UI_UPDATE_INTERVAL / 2); //every ~25 ms
+    const std::map<DirectoryKey, DirectoryValue> folderBuf = parallelFolderScan(foldersToRead, callback /*throw X*/, onStatusUpdate /*throw X*/,
+                                                                                UI_UPDATE_INTERVAL / 2); //every ~25 ms
 
-    //--------- group versions per (original) relative path ---------
-    std::map<AbstractPath, VersionInfoMap> versionDetails; //versioningFolderPath => <version details>
     std::map<AbstractPath, size_t> folderItemCount; //<folder path> => <item count> for determination of empty folders
 
     for (const auto& [folderKey, folderVal] : folderBuf)
     {
         const AbstractPath versioningFolderPath = folderKey.folderPath;
 
-        assert(!versionDetails.contains(versioningFolderPath));
+        assert(!versionItems.contains(versioningFolderPath));
 
-        findFileVersions(versionDetails[versioningFolderPath],
-                         folderVal.folderCont,
-                         versioningFolderPath,
-                         Zstring() /*relPathOrigParent*/,
-                         nullptr /*versionTimeParent*/);
+        getVersionItems(versionItems[versioningFolderPath], folderVal.folderCont, Zstring() /*parentRelPath*/);
+
+        //don't create index from incomplete data:
+        if (claimedFolders.contains(versioningFolderPath) &&
+            folderVal.failedFolderReads.empty() && folderVal.failedItemReads.empty())
+        {
+            indexesToSave.insert(versioningFolderPath);
+            lastFullScanTimes[versioningFolderPath] = now;
+        }
 
         //determine item count per folder for later detection and removal of empty folders:
         getFolderItemCount(folderItemCount, folderVal.folderCont, versioningFolderPath);
@@ -509,8 +988,19 @@ void fff::applyVersioningLimit(const std::set<VersioningLimitFolder>& folderLimi
         for (const auto& [relPath, errorMsg] : folderVal.failedItemReads  ) ++folderItemCount[AFS::appendRelPath(versioningFolderPath, beforeLast(relPath, FILE_NAME_SEPARATOR, IfNotFoundReturn::none))];
     }
 
+    //--------- group versions per (original) relative path ---------
+    std::map<AbstractPath, VersionInfoMap> versionDetails; //versioningFolderPath => <version details>
+
+    for (auto& [versioningFolderPath, items] : versionItems)
+    {
+        VersionInfoMap& versions = versionDetails[versioningFolderPath];
+
+        std::erase_if(items, [&](const auto& item) { return !addFileVersion(versions, item.first, item.second); }); //not a file version => no need to keep in index
+    }
+
     //--------- calculate excess file versions ---------
     std::map<AbstractPath, bool /*isSymlink*/> itemsToDelete;
+    std::map<AbstractPath, std::vector<std::pair<Zstring /*relPath*/, AbstractPath /*itemPath*/>>> versionsToDelete; //versioningFolderPath => <versions>
 
     const time_t lastMidnightTime = []
     {
@@ -525,7 +1015,7 @@ void fff::applyVersioningLimit(const std::set<VersioningLimitFolder>& folderLimi
     {
         auto it = versionDetails.find(vlf.versioningFolderPath);
         if (it != versionDetails.end())
-            for (auto& [versioningFolderPath, versions] : it->second)
+            for (auto& [relPathOrig, versions] : it->second)
             {
                 size_t versionsToKeep = versions.size();
                 if (vlf.versionMaxAgeDays > 0)
@@ -547,17 +1037,81 @@ void fff::applyVersioningLimit(const std::set<VersioningLimitFolder>& folderLimi
                     //oldest versions sorted to the front
 
                     for (const VersionInfo& vi : std::span(versions.begin(), versions.end() - versionsToKeep))
-                        itemsToDelete.emplace(vi.filePath, vi.isSymlink);
+                    {
+                        const AbstractPath itemPath = AFS::appendRelPath(vlf.versioningFolderPath, vi.relPath);
+                        itemsToDelete.emplace(itemPath, vi.isSymlink);
+                        versionsToDelete[vlf.versioningFolderPath].emplace_back(vi.relPath, itemPath);
+                    }
                 }
             }
     }
 
+    //--------- versions from index: determine item count of affected folders only ---------
+    {
+        std::set<AbstractPath> foldersToCount;
+
+        for (const auto& [versioningFolderPath, versions] : versionsToDelete)
+            if (indexedFolders.contains(versioningFolderPath))
+                for (const auto& [relPath, itemPath] : versions)
+                    for (Zstring parentRelPath = relPath; !parentRelPath.empty();)
+                    {
+                        parentRelPath = beforeLast(parentRelPath, FILE_NAME_SEPARATOR, IfNotFoundReturn::none);
+                        if (!foldersToCount.insert(AFS::appendRelPath(versioningFolderPath, parentRelPath)).second)
+                            break; //parent folders already added, too
+                    }
+
+        Protected<std::map<AbstractPath, size_t>&> protFolderItemCount(folderItemCount);
+        std::vector<std::pair<AbstractPath, ParallelWorkItem>> parallelWorkload;
+
+        for (const AbstractPath& folderPath : foldersToCount)
+            parallelWorkload.emplace_back(folderPath, [&textScanning, &protFolderItemCount](ParallelContext& ctx) //throw ThreadStopRequest
+        {
+            size_t itemCount = 0;
+            const std::wstring errMsg = tryReportingError([&] //throw ThreadStopRequest
+            {
+                ctx.acb.updateStatus(textScanning + AFS::getDisplayPath(ctx.itemPath)); //throw ThreadStopRequest
+
+                AFS::traverseFolder(ctx.itemPath, //throw FileError
+                [&](const AFS::FileInfo&    fi) { ++itemCount; },
+                [&](const AFS::FolderInfo&  fi) { ++itemCount; },
+                [&](const AFS::SymlinkInfo& si) { ++itemCount; });
+            }, ctx.acb);
+
+            if (errMsg.empty()) //else: item count unknown => folder is not deleted
+                protFolderItemCount.access([&](auto& folderItemCount2) { folderItemCount2[ctx.itemPath] = itemCount; });
+        });
+
+        massParallelExecute(parallelWorkload, deviceParallelOps,
+                            Zstr("Versioning Limit"), callback /*throw X*/); //throw X
+
+        //make sure the versioning folder is never found empty and is not deleted:
+        for (const AbstractPath& versioningFolderPath : indexedFolders)
+            if (auto it = folderItemCount.find(versioningFolderPath);
+                it != folderItemCount.end())
+                ++it->second;
+    }
+
     //--------- remove excess file versions ---------
+    std::set<AbstractPath> deletedItems;
+    Protected<std::set<AbstractPath>&> protDeletedItems(deletedItems);
     Protected<std::map<AbstractPath, size_t>&> protFolderItemCount(folderItemCount);
     const std::wstring txtRemoving = _("Removing old file versions:") + L' ';
     const std::wstring txtDeletingFolder = _("Deleting folder %x");
 
-    auto deleteEmptyFolderTask = [&txtDeletingFolder, &protFolderItemCount](this const auto& self, const AbstractPath& folderPath, AsyncCallback& acb) -> void //throw ThreadStopRequest
+    //item count not found: folder content unknown => don't delete
+    auto decrementItemCount = [&protFolderItemCount](const AbstractPath& folderPath)
+    {
+        bool folderEmpty = false;
+        protFolderItemCount.access([&](auto& folderItemCount2)
+        {
+            if (auto it = folderItemCount2.find(folderPath);
+                it != folderItemCount2.end())
+                folderEmpty = --it->second == 0;
+        });
+        return folderEmpty;
+    };
+
+    auto deleteEmptyFolderTask = [&txtDeletingFolder, &decrementItemCount](this const auto& self, const AbstractPath& folderPath, AsyncCallback& acb) -> void //throw ThreadStopRequest
     {
         const std::wstring errMsg = tryReportingError([&] //throw ThreadStopRequest
         {
@@ -567,12 +1121,8 @@ void fff::applyVersioningLimit(const std::set<VersioningLimitFolder>& folderLimi
 
         if (errMsg.empty())
             if (const std::optional<AbstractPath> parentPath = AFS::getParentPath(folderPath))
-            {
-                bool deleteParent = false;
-                protFolderItemCount.access([&](auto& folderItemCount2) { deleteParent = --folderItemCount2[*parentPath] == 0; });
-                if (deleteParent) //we're done here anyway => no need to schedule parent deletion in a separate task!
+                if (decrementItemCount(*parentPath)) //we're done here anyway => no need to schedule parent deletion in a separate task!
                     self(*parentPath, acb); //throw ThreadStopRequest
-            }
     };
 
     std::vector<std::pair<AbstractPath, ParallelWorkItem>> parallelWorkload;
@@ -585,7 +1135,7 @@ void fff::applyVersioningLimit(const std::set<VersioningLimitFolder>& folderLimi
         });
 
     for (const auto& [itemPath, isSymlink] : itemsToDelete)
-        parallelWorkload.emplace_back(itemPath, [isSymlink, &txtRemoving, &protFolderItemCount, &deleteEmptyFolderTask](ParallelContext& ctx) //throw ThreadStopRequest
+        parallelWorkload.emplace_back(itemPath, [isSymlink, &txtRemoving, &protDeletedItems, &decrementItemCount, &deleteEmptyFolderTask](ParallelContext& ctx) //throw ThreadStopRequest
     {
         const std::wstring errMsg = tryReportingError([&] //throw ThreadStopRequest
         {
@@ -597,15 +1147,54 @@ void fff::applyVersioningLimit(const std::set<VersioningLimitFolder>& folderLimi
         }, ctx.acb);
 
         if (errMsg.empty())
+        {
+            protDeletedItems.access([&](auto& deletedItems2) { deletedItems2.insert(ctx.itemPath); });
+
             if (const std::optional<AbstractPath> parentPath = AFS::getParentPath(ctx.itemPath))
-            {
-                bool deleteParent = false;
-                protFolderItemCount.access([&](auto& folderItemCount2) { deleteParent = --folderItemCount2[*parentPath] == 0; });
-                if (deleteParent)
+                if (decrementItemCount(*parentPath))
                     deleteEmptyFolderTask(*parentPath, ctx.acb); //throw ThreadStopRequest
-            }
+        }
     });
 
-    massParallelExecute(parallelWorkload,
+    massParallelExecute(parallelWorkload, deviceParallelOps,
                         Zstr("Versioning Limit"), callback /*throw X*/); //throw X
+
+    //--------- update version indexes ---------
+    for (const auto& [versioningFolderPath, versions] : versionsToDelete)
+        if (indexesToSave.contains(versioningFolderPath))
+        {
+            VersionItems& items = versionItems[versioningFolderPath];
+            for (const auto& [relPath, itemPath] : versions)
+                if (deletedItems.contains(itemPath))
+                    items.erase(relPath);
+        }
+
+    std::vector<std::pair<AbstractPath, ParallelWorkItem>> parallelWorkloadSave;
+
+    for (const AbstractPath& versioningFolderPath : claimedFolders)
+        if (indexesToSave.contains(versioningFolderPath))
+            parallelWorkloadSave.emplace_back(versioningFolderPath, [&items = std::as_const(versionItems[versioningFolderPath]),
+                                                                     lastFullScan = lastFullScanTimes[versioningFolderPath],
+                                                                     &claimId = versionIndexDeltas.find(versioningFolderPath)->second.claimId](ParallelContext& ctx) //throw ThreadStopRequest
+        {
+            tryReportingError([&] //throw ThreadStopRequest
+            {
+                ctx.acb.updateStatus(replaceCpy(_("Saving file %x..."), L"%x", fmtPath(AFS::getDisplayPath(getVersionIndexPath(ctx.itemPath))))); //throw ThreadStopRequest
+
+                saveVersionIndex(items, lastFullScan, ctx.itemPath); //throw FileError
+                releaseClaimMarker(getVersionIndexDirtyPath(ctx.itemPath), claimId); //throw FileError
+            }, ctx.acb);
+        });
+        else //e.g. new versions unknown, full scan failed: index (if any) is outdated => remove, so that it is rebuilt by next full scan
+            parallelWorkloadSave.emplace_back(versioningFolderPath, [&claimId = versionIndexDeltas.find(versioningFolderPath)->second.claimId](ParallelContext& ctx) //throw ThreadStopRequest
+        {
+            tryReportingError([&] //throw ThreadStopRequest
+            {
+                AFS::removeFileIfExists(getVersionIndexPath(ctx.itemPath)); //throw FileError
+                releaseClaimMarker(getVersionIndexDirtyPath(ctx.itemPath), claimId); //throw FileError
+            }, ctx.acb);
+        });
+
+    massParallelExecute(parallelWorkloadSave, deviceParallelOps,
+                        Zstr("Save Version Index"), callback /*throw X*/); //throw X
 }
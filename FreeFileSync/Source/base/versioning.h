@@ -8,6 +8,7 @@
 #define VERSIONING_H_8760247652438056
 
 #include <functional>
+#include <zen/thread.h>
 #include <zen/time.h>
 #include <zen/file_error.h>
 #include "structures.h"
@@ -22,26 +23,41 @@ namespace fff
 
     - ignores missing source files/dirs
     - creates missing intermediate directories
-    - does not create empty directories
+    - does not create empty directories (except when moving a complete folder in one go)
     - handles symlinks
     - multi-threading: internally synchronized
+    - revisionFolder(): try to move folder with a single rename (unless VersioningStyle::timestampFile)
+                        else move items on up to "parallelOps" threads
     - replaces already existing target files/dirs (supports retry)
         => (unlikely) risk of data loss for naming convention "versioning":
         race-condition if multiple folder pairs process the same filepath!!                */
 
+//versions created by FileVersioner: used to update the version index, see applyVersioningLimit()
+struct VersionIndexDelta
+{
+    std::vector<std::pair<Zstring /*relPath*/, bool /*isSymlink*/>> newItems; //relative to versioning folder
+    Zstring claimId; //non-empty: this sync owns the version index: claim marker was written *before* creating new versions, see claimVersionIndex()
+    bool incomplete   = false; //not all new versions could be determined => version index must be rebuilt from a full scan
+};
+
+
 class FileVersioner
 {
 public:
     FileVersioner(const AbstractPath& versioningFolderPath, //throw FileError
                   VersioningStyle versioningStyle,
-                  time_t syncStartTime) :
+                  bool versioningLimits, //record new versions for the version index, see applyVersioningLimit()
+                  time_t syncStartTime,
+                  size_t parallelOps) :
         versioningFolderPath_(versioningFolderPath),
         versioningStyle_(versioningStyle),
-        syncStartTime_(syncStartTime)
+        versioningLimits_(versioningLimits),
+        syncStartTime_(syncStartTime),
+        parallelOps_(parallelOps)
     {
         using namespace zen;
 
-        if (AbstractFileSystem::isNullPath(versioningFolderPath_))
+        if (AbstractFileSystem::isNullPath(versioningFolderPath_) || parallelOps_ == 0)
             throw std::logic_error(std::string(__FILE__) + '[' + numberTo<std::string>(__LINE__) + "] Contract violation!");
 
         if (timeStamp_.size() != 17) //formatTime() returns empty string on error; unexpected length: e.g. problem in year 10,000!
@@ -62,10 +78,14 @@ public:
                         //called frequently if move has to revert to copy + delete => see zen::copyFile for limitations when throwing exceptions!
                         const zen::IoCallback& notifyUnbufferedIO /*throw X*/) const;
 
+    VersionIndexDelta getIndexDelta() const { return indexDelta_.access([](const VersionIndexDelta& delta) { return delta; }); }
+
 private:
     FileVersioner           (const FileVersioner&) = delete;
     FileVersioner& operator=(const FileVersioner&) = delete;
 
+    class ItemMover;
+
     void checkPathConflict(const AbstractPath& itemPath, const Zstring& relativePath) const; //throw FileError
 
     void revisionFileImpl(const FileDescriptor& fileDescr, const Zstring& relativePath, //throw FileError, X
@@ -78,14 +98,24 @@ private:
     void revisionFolderImpl(const AbstractPath& folderPath, const Zstring& relativePath,
                             const std::function<void(const std::wstring& displayPathFrom, const std::wstring& displayPathTo)>& onBeforeFileMove,
                             const std::function<void(const std::wstring& displayPathFrom, const std::wstring& displayPathTo)>& onBeforeFolderMove,
-                            const zen::IoCallback& notifyUnbufferedIO) const; //throw FileError, X
+                            ItemMover& itemMover) const; //throw FileError, X
 
-    AbstractPath generateVersionedPath(const Zstring& relativePath) const;
+    bool tryMoveFolderAsWhole(const AbstractPath& folderPath, const Zstring& relativePath) const; //noexcept: false if not possible => fall back to per-item moves
+
+    void addToVersionIndex(const Zstring& versionedRelPath, bool isSymlink) const;
+    void addFolderToVersionIndex(const Zstring& versionedRelPath) const; //noexcept
+
+    Zstring generateVersionedRelPath(const Zstring& relativePath) const;
+    AbstractPath generateVersionedPath(const Zstring& relativePath) const { return AFS::appendRelPath(versioningFolderPath_, generateVersionedRelPath(relativePath)); }
 
     const AbstractPath versioningFolderPath_;
     const VersioningStyle versioningStyle_;
+    const bool versioningLimits_;
     const time_t syncStartTime_;
+    const size_t parallelOps_;
     const Zstring timeStamp_{zen::formatTime(Zstr("%Y-%m-%d %H%M%S"), zen::getLocalTime(syncStartTime_))}; //e.g. "2012-05-15 131513"
+
+    mutable zen::Protected<VersionIndexDelta> indexDelta_; //updated by ItemMover threads
 };
 
 //--------------------------------------------------------------------------------
@@ -100,7 +130,22 @@ struct VersioningLimitFolder
 std::weak_ordering operator<=>(const VersioningLimitFolder& lhs, const VersioningLimitFolder& rhs);
 
 
+/*  version index: list of versions stored in the versioning folder => no need for a full scan of the versioning folder after each sync
+    - updated with the versions created during sync (VersionIndexDelta)
+    - only read, written or deleted by the sync owning the claim marker ".sync.ffs_versions.dirty": folder containing a single file named after the claim id
+        => other syncs (e.g. concurrent FreeFileSync instance using the same versioning folder) fall back to a full scan
+    - rebuilt by full scan if missing or inconsistent, e.g. sync was cancelled or crashed after claimVersionIndex()
+    - rebuilt by full scan after a few weeks: versions added or removed by other means are not missed forever   */
+
+//call *before* creating versions: write claim marker => if applyVersioningLimit() is never reached, the marker remains and the index is rebuilt
+//  after the marker has timed out; stale markers from crashed syncs are taken over
+std::map<AbstractPath, VersionIndexDelta> claimVersionIndex(const std::set<AbstractPath>& versioningFolderPaths,
+                                                            const std::map<AfsDevice, size_t>& deviceParallelOps,
+                                                            PhaseCallback& callback /*throw X*/); //throw X
+
 void applyVersioningLimit(const std::set<VersioningLimitFolder>& folderLimits,
+                          const std::map<AbstractPath, VersionIndexDelta>& versionIndexDeltas,
+                          const std::map<AfsDevice, size_t>& deviceParallelOps,
                           PhaseCallback& callback /*throw X*/);
 
 
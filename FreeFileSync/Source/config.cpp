@@ -1083,12 +1083,14 @@ void readConfig(const XmlIn& in, SyncConfig& syncCfg, std::map<AfsDevice, size_t
 
     XmlIn verFolder = in["VersioningFolder"];
 
-    size_t parallelOps = 1;
-    if (verFolder.hasAttribute("Threads")) //*no error* if not available
+    if (verFolder.hasAttribute("Threads")) //*no error* if not available: don't store 1 for devices not set explicitly
+    {
+        size_t parallelOps = 1;
         verFolder.attribute("Threads", parallelOps); //try to get attribute
 
-    const size_t parallelOpsPrev = getDeviceParallelOps(deviceParallelOps, syncCfg.versioningFolderPhrase);
-    /**/                           setDeviceParallelOps(deviceParallelOps, syncCfg.versioningFolderPhrase, std::max(parallelOps, parallelOpsPrev));
+        const size_t parallelOpsPrev = getDeviceParallelOps(deviceParallelOps, syncCfg.versioningFolderPhrase);
+        /**/                           setDeviceParallelOps(deviceParallelOps, syncCfg.versioningFolderPhrase, std::max(parallelOps, parallelOpsPrev));
+    }
 
     in["VersioningFolder"].attribute("Style", syncCfg.versioningStyle);
 
@@ -1132,18 +1134,19 @@ void readConfig(const XmlIn& in, LocalPairConfig& lpc, std::map<AfsDevice, size_
     in["Left" ](lpc.folderPathPhraseLeft);
     in["Right"](lpc.folderPathPhraseRight);
 
-    size_t parallelOpsL = 1;
-    size_t parallelOpsR = 1;
-    if (in["Left" ].hasAttribute("Threads")) in["Left" ].attribute("Threads", parallelOpsL); //try to get attributes:
-    if (in["Right"].hasAttribute("Threads")) in["Right"].attribute("Threads", parallelOpsR); // => *no error* if not available
-
-    auto setParallelOps = [&](const Zstring& folderPathPhrase, size_t parallelOps)
+    auto readParallelOps = [&](const XmlIn& inFolder, const Zstring& folderPathPhrase)
     {
-        const size_t parallelOpsPrev = getDeviceParallelOps(deviceParallelOps, folderPathPhrase);
-        /**/                           setDeviceParallelOps(deviceParallelOps, folderPathPhrase, std::max(parallelOps, parallelOpsPrev));
+        if (inFolder.hasAttribute("Threads")) //*no error* if not available: don't store 1 for devices not set explicitly
+        {
+            size_t parallelOps = 1;
+            inFolder.attribute("Threads", parallelOps); //try to get attribute
+
+            const size_t parallelOpsPrev = getDeviceParallelOps(deviceParallelOps, folderPathPhrase);
+            /**/                           setDeviceParallelOps(deviceParallelOps, folderPathPhrase, std::max(parallelOps, parallelOpsPrev));
+        }
     };
-    setParallelOps(lpc.folderPathPhraseLeft,  parallelOpsL);
-    setParallelOps(lpc.folderPathPhraseRight, parallelOpsR);
+    readParallelOps(in["Left" ], lpc.folderPathPhraseLeft);
+    readParallelOps(in["Right"], lpc.folderPathPhraseRight);
 
     //TODO: remove after migration! 2020-04-24
     if (formatVer < 16)
@@ -2014,8 +2017,8 @@ void writeConfig(const SyncConfig& syncCfg, const std::map<AfsDevice, size_t>& d
     out["DeletionPolicy"  ](syncCfg.deletionVariant);
     out["VersioningFolder"](syncCfg.versioningFolderPhrase);
 
-    const size_t parallelOps = getDeviceParallelOps(deviceParallelOps, syncCfg.versioningFolderPhrase);
-    if (parallelOps > 1) out["VersioningFolder"].attribute("Threads", parallelOps);
+    if (haveDeviceParallelOps(deviceParallelOps, syncCfg.versioningFolderPhrase)) //including 1: forces single thread
+        out["VersioningFolder"].attribute("Threads", getDeviceParallelOps(deviceParallelOps, syncCfg.versioningFolderPhrase));
 
     out["VersioningFolder"].attribute("Style", syncCfg.versioningStyle);
 
@@ -2052,14 +2055,12 @@ void writeConfig(const LocalPairConfig& lpc, const std::map<AfsDevice, size_t>&
     outPair["Left" ](lpc.folderPathPhraseLeft);
     outPair["Right"](lpc.folderPathPhraseRight);
 
-    const size_t parallelOpsL = getDeviceParallelOps(deviceParallelOps, lpc.folderPathPhraseLeft);
-    const size_t parallelOpsR = getDeviceParallelOps(deviceParallelOps, lpc.folderPathPhraseRight);
-
-    if (parallelOpsL > 1) outPair["Left" ].attribute("Threads", parallelOpsL);
-    if (parallelOpsR > 1) outPair["Right"].attribute("Threads", parallelOpsR);
+    //only devices set explicitly, including 1: forces single thread (instead of AFS::getDefaultParallelOps() for metadata tasks)
+    if (haveDeviceParallelOps(deviceParallelOps, lpc.folderPathPhraseLeft )) outPair["Left" ].attribute("Threads", getDeviceParallelOps(deviceParallelOps, lpc.folderPathPhraseLeft));
+    if (haveDeviceParallelOps(deviceParallelOps, lpc.folderPathPhraseRight)) outPair["Right"].attribute("Threads", getDeviceParallelOps(deviceParallelOps, lpc.folderPathPhraseRight));
 
-    //avoid "fake" changed configs by only storing "real" parallel-enabled devices in deviceParallelOps
-    assert(std::all_of(deviceParallelOps.begin(), deviceParallelOps.end(), [](const auto& item) { return item.second > 1; }));
+    //avoid "fake" changed configs by only storing explicitly set devices in deviceParallelOps
+    assert(std::all_of(deviceParallelOps.begin(), deviceParallelOps.end(), [](const auto& item) { return item.second >= 1; }));
 
     //###########################################################
     //alternate comp configuration (optional)
@@ -6,12 +6,22 @@
 
 #include "icon_buffer.h"
 #include <map>
+#include <set>
 #include <variant>
 #include <zen/thread.h> //includes <std/thread.hpp>
+#include <zen/file_io.h>
+#include <zen/file_access.h>
+#include <zen/file_traverser.h>
+#include <zen/extra_log.h>
+#include <zen/serialize.h>
+#include <zen/zlib_wrap.h>
 #include <wx+/dc.h>
 #include <wx+/image_resources.h>
 #include <wx+/std_button_layout.h>
 #include "base/icon_loader.h"
+#include "afs/native.h"
+#include "ffs_paths.h"
+    #include <sys/stat.h>
 
 
 using namespace zen;
@@ -23,7 +33,207 @@ namespace
 {
 const size_t BUFFER_SIZE_MAX = 1000; //maximum number of icons to hold in buffer: must be big enough to hold visible icons + preload buffer!
 
+const size_t ICON_LOADER_THREAD_COUNT = 4; //icon/thumbnail retrieval is latency-bound, e.g. images on a NAS
 
+const uint64_t THUMBNAIL_CACHE_SIZE_MAX = 100'000'000; //[bytes] on disk; trimmed least recently used first
+const size_t THUMBNAIL_CACHE_TRIM_INTERVAL = 500; //[inserts] ~ 10-50 MB of thumbnails: trim on first insert, then every N inserts
+const time_t THUMBNAIL_RECENCY_UPDATE_MIN = 24 * 3600; //[s] mark cache entries as recently used at most once a day: don't write on every load
+
+const char THUMBNAIL_FILE_DESCR[] = "FreeFileSync: Thumbnail";
+const int THUMBNAIL_FILE_VERSION = 1;
+
+
+Zstring getThumbnailCacheFolderPath() { return appendPath(getConfigDirPath(), Zstr("Thumbnails")); }
+
+
+/* persistent thumbnail cache: content-addressed by file path, size, modification time and thumbnail size
+   => no invalidation needed: changed files simply map to a new cache entry; stale entries are aged out by trimThumbnailCache()  */
+struct ThumbnailCacheEntry
+{
+    Zstring filePath; //= cache file path
+    std::string key;  //stored inside the file: don't trust a 64-bit hash alone
+};
+
+
+std::optional<ThumbnailCacheEntry> getThumbnailCacheEntry(const Zstring& nativePath, int pixelSize) //noexcept
+{
+    struct stat fileInfo = {};
+    if (::stat(nativePath.c_str(), &fileInfo) != 0 || !S_ISREG(fileInfo.st_mode))
+        return std::nullopt; //let getThumbnailImage() report the error
+
+    MemoryStreamOut keyStream;
+    writeContainer(keyStream, utfTo<std::string>(nativePath));
+    writeNumber<uint64_t>(keyStream, fileInfo.st_size);
+    writeNumber<int64_t>(keyStream, fileInfo.st_mtim.tv_sec);
+    writeNumber<int64_t>(keyStream, fileInfo.st_mtim.tv_nsec);
+    writeNumber<int32_t>(keyStream, pixelSize);
+
+    const uint64_t keyHash = hashString<uint64_t>(keyStream.ref());
+
+    return ThumbnailCacheEntry
+    {
+        .filePath = appendPath(getThumbnailCacheFolderPath(), utfTo<Zstring>(formatAsHexString({reinterpret_cast<const char*>(&keyHash), sizeof(keyHash)})) + Zstr(".thumb")),
+        .key = std::move(keyStream.ref()),
+    };
+}
+
+
+ImageHolder loadThumbnailCacheEntry(const ThumbnailCacheEntry& entry) //throw FileError, SysError; optional return value
+{
+    std::string byteStream;
+    try
+    {
+        byteStream = getFileContent(entry.filePath, nullptr /*notifyUnbufferedIO*/); //throw FileError
+    }
+    catch (FileError&)
+    {
+        if (itemExists(entry.filePath)) //throw FileError
+            throw;
+        return {};
+    }
+
+    MemoryStreamIn streamIn(byteStream);
+    //-------- file format header --------
+    char tmp[sizeof(THUMBNAIL_FILE_DESCR)] = {};
+    readArray(streamIn, &tmp, sizeof(tmp)); //throw SysErrorUnexpectedEos
+    if (!std::equal(std::begin(tmp), std::end(tmp), std::begin(THUMBNAIL_FILE_DESCR)))
+        throw SysError(_("File content is corrupted.") + L" (invalid header)");
+
+    const int version = readNumber<int32_t>(streamIn); //throw SysErrorUnexpectedEos
+    if (version != THUMBNAIL_FILE_VERSION) //outdated format: just regenerate
+        return {};
+
+    if (readContainer<std::string>(streamIn) != entry.key) //throw SysErrorUnexpectedEos
+        return {}; //hash collision
+
+    const int  width     = readNumber<int32_t>(streamIn); //
+    const int  height    = readNumber<int32_t>(streamIn); //throw SysErrorUnexpectedEos
+    const bool withAlpha = readNumber<int8_t >(streamIn) != 0; //
+    if (width <= 0 || height <= 0)
+        throw SysError(_("File content is corrupted.") + L" (invalid image size)");
+
+    const std::string& pixels = decompress(std::string_view(byteStream).substr(streamIn.pos())); //throw SysError
+    if (pixels.size() != static_cast<size_t>(width) * height * (withAlpha ? 4 : 3))
+        throw SysError(_("File content is corrupted.") + L" (invalid image size)");
+
+    ImageHolder ih(width, height, withAlpha);
+    std::memcpy(ih.getRgb(), pixels.data(), width * height * 3);
+    if (withAlpha)
+        std::memcpy(ih.getAlpha(), pixels.data() + width * height * 3, width * height);
+
+    //mark as recently used for trimThumbnailCache(): day resolution is plenty for LRU
+    if (struct stat cacheInfo = {};
+        ::stat(entry.filePath.c_str(), &cacheInfo) == 0 && std::time(nullptr) - cacheInfo.st_mtime >= THUMBNAIL_RECENCY_UPDATE_MIN)
+        try
+        {
+            setFileTime(entry.filePath, std::time(nullptr), ProcSymlink::follow); //throw FileError
+        }
+        catch (FileError&) {}
+
+    return ih;
+}
+
+
+void saveThumbnailCacheEntry(const ThumbnailCacheEntry& entry, ImageHolder& ih) //throw FileError, SysError
+{
+    const int width  = ih.getWidth();
+    const int height = ih.getHeight();
+
+    std::string pixels(reinterpret_cast<const char*>(ih.getRgb()), width * height * 3);
+    if (ih.getAlpha())
+        pixels.append(reinterpret_cast<const char*>(ih.getAlpha()), width * height);
+
+    MemoryStreamOut streamOut;
+    writeArray(streamOut, THUMBNAIL_FILE_DESCR, sizeof(THUMBNAIL_FILE_DESCR));
+    writeNumber<int32_t>(streamOut, THUMBNAIL_FILE_VERSION);
+    writeContainer(streamOut, entry.key);
+    writeNumber<int32_t>(streamOut, width);
+    writeNumber<int32_t>(streamOut, height);
+    writeNumber<int8_t >(streamOut, ih.getAlpha() ? 1 : 0);
+
+    streamOut.ref() += compress(pixels, 3 /*see db_file.cpp*/); //throw SysError
+
+    createDirectoryIfMissingRecursion(getThumbnailCacheFolderPath()); //throw FileError
+    setFileContent(entry.filePath, streamOut.ref(), nullptr /*notifyUnbufferedIO*/); //throw FileError
+}
+
+
+void trimThumbnailCache() //throw FileError
+{
+    std::vector<FileInfo> cacheFiles;
+    uint64_t totalBytes = 0;
+
+    const Zstring cacheFolderPath = getThumbnailCacheFolderPath();
+    if (!itemExists(cacheFolderPath)) //throw FileError
+        return;
+
+    traverseFolder(cacheFolderPath, [&](const FileInfo& fi)
+    {
+        if (endsWith(fi.itemName, Zstr(".thumb")))
+        {
+            cacheFiles.push_back(fi);
+            totalBytes += fi.fileSize;
+        }
+    }, nullptr, nullptr); //throw FileError
+
+    if (totalBytes <= THUMBNAIL_CACHE_SIZE_MAX)
+        return;
+
+    std::sort(cacheFiles.begin(), cacheFiles.end(), [](const FileInfo& lhs, const FileInfo& rhs) { return lhs.modTime < rhs.modTime; });
+
+    //make some room: don't trim again right away
+    for (const FileInfo& fi : cacheFiles)
+    {
+        if (totalBytes <= THUMBNAIL_CACHE_SIZE_MAX * 3 / 4)
+            break;
+        removeFilePlain(fi.fullPath); //throw FileError
+        totalBytes -= fi.fileSize;
+    }
+}
+
+
+constinit std::atomic<size_t> thumbnailCacheInsertCount{0};
+constinit std::mutex lockTrimThumbnailCache;
+
+void onThumbnailCacheInsert() //throw FileError
+{
+    if (thumbnailCacheInsertCount++ % THUMBNAIL_CACHE_TRIM_INTERVAL == 0)
+        if (std::unique_lock trimLock(lockTrimThumbnailCache, std::try_to_lock); trimLock.owns_lock()) //other icon thread trimming already? => skip
+            trimThumbnailCache(); //throw FileError
+}
+
+
+ImageHolder getThumbnailImageCached(const AbstractPath& itemPath, int pixelSize) //throw FileError; optional return value
+{
+    const Zstring nativePath = getNativeItemPath(itemPath);
+    if (nativePath.empty()) //(currently) no thumbnails for non-native paths anyway
+        return AFS::getThumbnailImage(itemPath, pixelSize); //throw FileError
+
+    const std::optional<ThumbnailCacheEntry> cacheEntry = getThumbnailCacheEntry(nativePath, pixelSize);
+    if (cacheEntry)
+        try
+        {
+            if (ImageHolder ih = loadThumbnailCacheEntry(*cacheEntry)) //throw FileError, SysError
+                return ih;
+        }
+        catch (const FileError& e) { logExtraError(e.toString()); }
+        catch (const SysError& e) { logExtraError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(cacheEntry->filePath)) + L"\n\n" + e.toString()); }
+
+    ImageHolder ih = AFS::getThumbnailImage(itemPath, pixelSize); //throw FileError
+
+    if (ih && cacheEntry)
+        try
+        {
+            saveThumbnailCacheEntry(*cacheEntry, ih); //throw FileError, SysError
+
+            try { onThumbnailCacheInsert(); } //throw FileError
+            catch (const FileError& e) { logExtraError(e.toString()); }
+        }
+        catch (const FileError& e) { logExtraError(e.toString()); }
+        catch (const SysError& e) { logExtraError(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(cacheEntry->filePath)) + L"\n\n" + e.toString()); }
+
+    return ih;
+}
 }
 
 //################################################################################################################################################
@@ -39,7 +249,7 @@ std::variant<ImageHolder, FileIconHolder> getDisplayIcon(const AbstractPath& ite
         case IconBuffer::IconSize::large:
             try
             {
-                if (ImageHolder ih = AFS::getThumbnailImage(itemPath, IconBuffer::getPixSize(sz))) //throw FileError; optional return value
+                if (ImageHolder ih = getThumbnailImageCached(itemPath, IconBuffer::getPixSize(sz))) //throw FileError; optional return value
                     return ih;
             }
             catch (FileError&) {}
@@ -94,18 +304,31 @@ public:
         assert(!runningOnMainThread());
         std::unique_lock dummy(lockFiles_);
 
-        interruptibleWait(conditionNewWork_, dummy, [this] { return !workLoad_.empty(); }); //throw ThreadStopRequest
+        for (;;)
+        {
+            interruptibleWait(conditionNewWork_, dummy, [this] { return !workLoad_.empty(); }); //throw ThreadStopRequest
+
+            AbstractPath filePath = workLoad_.    back(); //yes, no strong exception guarantee (std::bad_alloc)
+            /**/                    workLoad_.pop_back(); //
 
-        AbstractPath filePath = workLoad_.    back(); //yes, no strong exception guarantee (std::bad_alloc)
-        /**/                    workLoad_.pop_back(); //
-        return filePath;
+            if (inProgress_.insert(filePath).second) //don't load the same icon on two threads: main thread re-adds missing icons on each repaint
+                return filePath;
+        }
+    }
+
+    void markDone(const AbstractPath& filePath) //context of worker thread
+    {
+        std::lock_guard dummy(lockFiles_);
+        [[maybe_unused]] const size_t erased = inProgress_.erase(filePath);
+        assert(erased == 1);
     }
 
 private:
     //AbstractPath is thread-safe like an int!
     std::mutex                lockFiles_;
     std::condition_variable   conditionNewWork_; //signal event: data for processing available
-    std::vector<AbstractPath> workLoad_; //processes last elements of vector first!
+    std::vector<AbstractPath> workLoad_; //processes last elements of vector first! => most important (= visible) rows are inserted last by IconUpdater
+    std::set<AbstractPath>    inProgress_;
 };
 
 
@@ -281,7 +504,7 @@ struct IconBuffer::Impl
     WorkLoad workload; //manage life time: enclose InterruptibleThread's (until joined)!!!
     Buffer   buffer;   //
 
-    InterruptibleThread worker;
+    std::vector<InterruptibleThread> worker;
     //-------------------------
     //-------------------------
     std::unordered_map<Zstring, wxImage, StringHashAsciiNoCase, StringEqualAsciiNoCase> extensionIcons; //no item count limit!? Test case C:\ ~ 3800 unique file extensions
@@ -290,14 +513,16 @@ struct IconBuffer::Impl
 
 IconBuffer::IconBuffer(IconSize sz) : pimpl_(std::make_unique<Impl>()), iconSizeType_(sz)
 {
-    pimpl_->worker = InterruptibleThread([&workload = pimpl_->workload, &buffer = pimpl_->buffer, sz]
+    for (size_t threadIdx = 0; threadIdx < ICON_LOADER_THREAD_COUNT; ++threadIdx)
+        pimpl_->worker.emplace_back([threadIdx, &workload = pimpl_->workload, &buffer = pimpl_->buffer, sz]
     {
-        setCurrentThreadName(Zstr("Icon Buffer"));
+        setCurrentThreadName(Zstr("Icon Buffer[") + numberTo<Zstring>(threadIdx + 1) + Zstr('/') + numberTo<Zstring>(ICON_LOADER_THREAD_COUNT) + Zstr(']'));
 
         for (;;)
         {
             //start work: blocks until next icon to load is retrieved:
             const AbstractPath itemPath = workload.extractNext(); //throw ThreadStopRequest
+            ZEN_ON_SCOPE_EXIT(workload.markDone(itemPath));
 
             if (!buffer.hasIcon(itemPath)) //perf: workload may contain duplicate entries?
                 buffer.insert(itemPath, getDisplayIcon(itemPath, sz));
@@ -309,8 +534,8 @@ IconBuffer::IconBuffer(IconSize sz) : pimpl_(std::make_unique<Impl>()), iconSize
 IconBuffer::~IconBuffer()
 {
     setWorkload({}); //make sure interruption point is always reached! needed???
-    pimpl_->worker.requestStop(); //end thread life time *before*
-    pimpl_->worker.join();        //IconBuffer::Impl member clean up!
+    for (InterruptibleThread& wt : pimpl_->worker) wt.requestStop(); //end thread life time *before*
+    for (InterruptibleThread& wt : pimpl_->worker) wt.join();        //IconBuffer::Impl member clean up!
 }
 
 
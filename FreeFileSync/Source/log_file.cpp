@@ -7,6 +7,8 @@
 #include "log_file.h"
 #include <zen/http.h>
 #include <zen/sys_info.h>
+#include <zen/file_access.h>
+#include <zen/json.h>
 
 using namespace zen;
 using namespace fff;
@@ -25,6 +27,9 @@ const int EMAIL_SHORT_ITEMS_MAX   = 0; //
 
 const int SEPARATION_LINE_LEN = 40;
 
+const size_t LOG_SPOOL_INFO_TAIL_MAX = 10'000; //info messages kept in memory, e.g. for log panel
+const size_t LOG_SPOOL_FAIL_TAIL_MAX = 10'000; //warnings/errors kept in memory (separate budget: don't let info messages push them out)
+
 
 std::wstring getUserDescription() //throw FileError
 {
@@ -54,7 +59,7 @@ std::wstring /*may be empty*/ getMachineDescription() //throw FileError
 }
 
 
-std::string generateLogHeaderTxt(const ProcessSummary& s, const ErrorLog& log, int logPreviewMax)
+std::string generateLogHeaderTxt(const ProcessSummary& s, const ErrorLog& log, const ErrorLogStats& logCount /*including entries dropped from "log"*/, int logPreviewMax)
 {
     const auto tabSpace = utfTo<std::string>(TAB_SPACE);
 
@@ -74,8 +79,6 @@ std::string generateLogHeaderTxt(const ProcessSummary& s, const ErrorLog& log, i
     summary.push_back(tabSpace + utfTo<std::string>(getSyncResultLabel(s.result)));
     summary.emplace_back();
 
-    const ErrorLogStats logCount = getStats(log);
-
     if (logCount.errors   > 0) summary.push_back(tabSpace + utfTo<std::string>(_("Errors:")   + L' ' + formatNumber(logCount.errors)));
     if (logCount.warnings > 0) summary.push_back(tabSpace + utfTo<std::string>(_("Warnings:") + L' ' + formatNumber(logCount.warnings)));
 
@@ -225,7 +228,7 @@ std::wstring generateLogTitle(const ProcessSummary& s)
 }
 
 
-std::string generateLogHeaderHtml(const ProcessSummary& s, const ErrorLog& log, int logPreviewMax)
+std::string generateLogHeaderHtml(const ProcessSummary& s, const ErrorLog& log, const ErrorLogStats& logCount /*including entries dropped from "log"*/, int logPreviewMax)
 {
     //caveat: non-inline CSS is often ignored by email clients!
     std::string output = R"(<!DOCTYPE html>
@@ -272,8 +275,6 @@ std::string generateLogHeaderHtml(const ProcessSummary& s, const ErrorLog& log,
         </div>
         <table role="presentation" class="summary-table" style="border-spacing:0; margin-left:10px; padding:5px 10px;">)";
 
-    const ErrorLogStats logCount = getStats(log);
-
     if (logCount.errors > 0)
         output += R"(
             <tr>
@@ -396,32 +397,44 @@ std::string generateLogFooterHtml(const std::wstring& logFilePath /*optional*/,
 
 //write log items in blocks instead of creating one big string: memory allocation might fail; think 1 million entries!
 template <class Function>
-void streamToLogFile(const ProcessSummary& summary, const ErrorLog& log,
+void streamToLogFile(const ProcessSummary& summary, const ErrorLog& log, const LogSpool* logSpool /*optional*/,
                      int logPreviewMax, int logItemsMax,
                      const std::wstring& logFilePath /*optional*/,
-                     LogFileFormat logFormat, Function stringOut /*(const std::string& s); throw X*/) //throw SysError, X
+                     LogFileFormat logFormat, Function stringOut /*(const std::string& s); throw X*/) //throw SysError, FileError, X
 {
+    const ErrorLogStats logCount = logSpool ? logSpool->getStats(log) : getStats(log);
+
     stringOut(logFormat == LogFileFormat::html ?
-              generateLogHeaderHtml(summary, log, logPreviewMax) :
-              generateLogHeaderTxt (summary, log, logPreviewMax)); //throw X
+              generateLogHeaderHtml(summary, log, logCount, logPreviewMax) :
+              generateLogHeaderTxt (summary, log, logCount, logPreviewMax)); //throw X
 
     int itemCount = 0;
-    for (const LogEntry& entry : log)
+    auto writeEntry = [&](const LogEntry& entry)
     {
-        if (itemCount++ >= logItemsMax)
-            break;
-        stringOut(logFormat == LogFileFormat::html ?
-                  formatMessageHtml(entry) :
-                  formatMessage    (entry)); //throw X
-    }
+        if (itemCount++ < logItemsMax)
+            stringOut(logFormat == LogFileFormat::html ?
+                      formatMessageHtml(entry) :
+                      formatMessage    (entry)); //throw X
+    };
+    if (logSpool)
+        logSpool->forEachEntry(log, writeEntry); //throw FileError, X
+    else
+        for (const LogEntry& entry : log)
+        {
+            if (itemCount >= logItemsMax)
+                break;
+            writeEntry(entry); //throw X
+        }
+
+    const int logItemsTotal = static_cast<int>(log.size()) + (logSpool ? logSpool->getDroppedCount() : 0);
 
     const std::string footer = [&]
     {
         try
         {
             return logFormat == LogFileFormat::html ?
-            generateLogFooterHtml(logFilePath, static_cast<int>(log.size()), logItemsMax): //throw FileError
-            generateLogFooterTxt (logFilePath, static_cast<int>(log.size()), logItemsMax); //
+            generateLogFooterHtml(logFilePath, logItemsTotal, logItemsMax): //throw FileError
+            generateLogFooterTxt (logFilePath, logItemsTotal, logItemsMax); //
         }
         catch (const FileError& e) { throw SysError(replaceCpy(e.toString(), L"\n\n", L'\n')); } //errors should be further enriched by context info => SysError
     }(); //caveat: don't catch exceptions thrown by stringOut()!
@@ -434,6 +447,7 @@ void saveNewLogFile(const AbstractPath& logFilePath, //throw FileError, X
                     LogFileFormat logFormat,
                     const ProcessSummary& summary,
                     const ErrorLog& log,
+                    const LogSpool* logSpool /*optional*/,
                     const std::function<void(std::wstring&& msg)>& notifyStatus /*throw X*/)
 {
     //create logfile folder if required
@@ -470,7 +484,7 @@ void saveNewLogFile(const AbstractPath& logFilePath, //throw FileError, X
 
     try
     {
-        streamToLogFile(summary, log, LOG_PREVIEW_MAX, std::numeric_limits<int>::max() /*logItemsMax*/,
+        streamToLogFile(summary, log, logSpool, LOG_PREVIEW_MAX, std::numeric_limits<int>::max() /*logItemsMax*/,
                         std::wstring() /*logFilePath -> superfluous*/, logFormat,
         [&](const std::string& str) { streamOut.write(str.data(), str.size()); } /*throw FileError, X*/); //throw SysError, FileError, X
     }
@@ -508,7 +522,8 @@ std::vector<LogFileInfo> getLogFiles(const AbstractPath& logFolderPath) //throw
         static_assert(TIME_STAMP_LENGTH == 21);
 
         if (endsWith(fi.itemName, Zstr(".log")) || //case-sensitive: e.g. ".LOG" is not from FFS, right?
-            endsWith(fi.itemName, Zstr(".html")))
+            endsWith(fi.itemName, Zstr(".html")) ||
+            endsWith(fi.itemName, Zstr(".jsonl"))) //LogSpool left over after process was killed
         {
             ZstringView itemPhrase = beforeLast<ZstringView>(fi.itemName, Zstr('.'), IfNotFoundReturn::none);
 
@@ -651,9 +666,189 @@ Zstring fff::generateLogFileName(LogFileFormat logFormat, const ProcessSummary&
 }
 
 
+namespace
+{
+std::string getLogSpoolTypeName(MessageType type)
+{
+    switch (type)
+    {
+        case MSG_TYPE_INFO:
+            return "info";
+        case MSG_TYPE_WARNING:
+            return "warning";
+        case MSG_TYPE_ERROR:
+            break;
+    }
+    return "error";
+}
+
+
+LogEntry parseLogSpoolEntry(const std::string& line) //throw SysError
+{
+    try
+    {
+        const JsonValue jentry = parseJson(line); //throw JsonParsingError
+
+        const std::optional<std::string> time = getPrimitiveFromJsonObject(jentry, "time");
+        const std::optional<std::string> type = getPrimitiveFromJsonObject(jentry, "type");
+        const std::optional<std::string> msg  = getPrimitiveFromJsonObject(jentry, "msg");
+        if (!time || !type || !msg)
+            throw SysError(L"Log entry incomplete: " + utfTo<std::wstring>(line));
+
+        return
+        {
+            stringTo<time_t>(*time),
+            *type == "info"    ? MSG_TYPE_INFO :
+            *type == "warning" ? MSG_TYPE_WARNING : MSG_TYPE_ERROR,
+            utfTo<Zstringc>(*msg)
+        };
+    }
+    catch (JsonParsingError&) { throw SysError(_("File content is corrupted.") + L" (JSON)"); }
+}
+
+
+Zstring getLogSpoolFilePath(const Zstring& logFolderPath, const ProcessSummary& summary) //throw FileError
+{
+    //same name as final log file => cleaned up by limitLogfileCount() if left over
+    const Zstring logFileName = generateLogFileName(LogFileFormat::text, {.startTime = summary.startTime, .result = TaskResult::success, .jobNames = summary.jobNames}); //throw FileError
+    return appendPath(logFolderPath, beforeLast(logFileName, Zstr('.'), IfNotFoundReturn::all) + Zstr(".jsonl"));
+}
+}
+
+
+LogSpool::LogSpool(const Zstring& logFolderPath, const ProcessSummary& summary) : //throw FileError
+    fileOut_([&]
+{
+    createDirectoryIfMissingRecursion(logFolderPath); //throw FileError
+    return getLogSpoolFilePath(logFolderPath, summary); //throw FileError
+}()) {} //throw FileError, (ErrorTargetExisting)
+
+
+void LogSpool::flush(ErrorLog& log) //throw FileError
+{
+    assert(flushedRows_ <= log.size());
+    if (writeFailed_) //don't append after partial write
+        return;
+
+    if (flushedRows_ < log.size())
+    {
+        std::string buf;
+        for (auto it = log.begin() + flushedRows_; it != log.end(); ++it)
+        {
+            JsonValue jentry(JsonValue::Type::object);
+            jentry.objectVal.set("time", static_cast<int64_t>(it->time));
+            jentry.objectVal.set("type", getLogSpoolTypeName(it->type));
+            jentry.objectVal.set("msg",  utfTo<std::string>(it->message));
+
+            buf += serializeJson(jentry, "" /*lineBreak*/, "" /*indent*/);
+            buf += '\n';
+
+            if (it->type == MSG_TYPE_INFO)
+                ++infoRows_;
+            else
+                ++failRows_;
+        }
+
+        ZEN_ON_SCOPE_FAIL(writeFailed_ = true);
+        for (size_t bytesDone = 0; bytesDone < buf.size(); )
+            bytesDone += fileOut_.tryWrite(buf.data() + bytesDone, buf.size() - bytesDone); //throw FileError
+
+        bytesWritten_ += buf.size();
+        flushedRows_ = log.size();
+    }
+
+    //drop old entries: not before twice the tail size => amortized constant time
+    if (infoRows_ >= 2 * LOG_SPOOL_INFO_TAIL_MAX ||
+        failRows_ >= 2 * LOG_SPOOL_FAIL_TAIL_MAX)
+    {
+        size_t infoToDrop = infoRows_ > LOG_SPOOL_INFO_TAIL_MAX ? infoRows_ - LOG_SPOOL_INFO_TAIL_MAX : 0;
+        size_t failToDrop = failRows_ > LOG_SPOOL_FAIL_TAIL_MAX ? failRows_ - LOG_SPOOL_FAIL_TAIL_MAX : 0;
+
+        auto itOut = log.begin();
+        for (auto it = log.begin(); it != log.end(); ++it)
+            if (size_t& toDrop = it->type == MSG_TYPE_INFO ? infoToDrop : failToDrop;
+                toDrop > 0)
+            {
+                --toDrop;
+                switch (it->type)
+                {
+                    case MSG_TYPE_INFO:
+                        ++droppedStats_.infos;
+                        --infoRows_;
+                        break;
+                    case MSG_TYPE_WARNING:
+                        ++droppedStats_.warnings;
+                        --failRows_;
+                        break;
+                    case MSG_TYPE_ERROR:
+                        ++droppedStats_.errors;
+                        --failRows_;
+                        break;
+                }
+            }
+            else
+            {
+                if (itOut != it) //Zbase self-move assignment is not supported!
+                    *itOut = std::move(*it);
+                ++itOut;
+            }
+
+        log.erase(itOut, log.end());
+        flushedRows_ = log.size();
+    }
+}
+
+
+ErrorLogStats LogSpool::getStats(const ErrorLog& log) const
+{
+    ErrorLogStats count = zen::getStats(log);
+    count.infos    += droppedStats_.infos;
+    count.warnings += droppedStats_.warnings;
+    count.errors   += droppedStats_.errors;
+    return count;
+}
+
+
+void LogSpool::forEachEntry(const ErrorLog& log, const std::function<void(const LogEntry& entry)>& onEntry) const //throw FileError, X
+{
+    if (bytesWritten_ > 0)
+        try
+        {
+            FileInputPlain fileIn(fileOut_.getFilePath()); //throw FileError, ErrorFileLocked
+
+            std::string buf;
+            std::vector<char> block(256 * 1024);
+
+            for (uint64_t bytesLeft = bytesWritten_; bytesLeft > 0; )
+            {
+                const size_t bytesRead = fileIn.tryRead(block.data(), static_cast<size_t>(std::min<uint64_t>(block.size(), bytesLeft))); //throw FileError, ErrorFileLocked
+                if (bytesRead == 0) //may return short, only 0 means EOF!
+                    throw SysError(_("File content is corrupted.") + L" (unexpected end of stream)");
+                bytesLeft -= bytesRead;
+
+                buf.append(block.data(), bytesRead);
+
+                size_t lineStart = 0;
+                for (size_t pos = buf.find('\n'); pos != std::string::npos; pos = buf.find('\n', lineStart))
+                {
+                    onEntry(parseLogSpoolEntry(buf.substr(lineStart, pos - lineStart))); //throw SysError, X
+                    lineStart = pos + 1;
+                }
+                buf.erase(0, lineStart);
+            }
+            assert(buf.empty());
+        }
+        catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(fileOut_.getFilePath())), e.toString()); }
+
+    for (auto it = log.begin() + flushedRows_; it != log.end(); ++it)
+        onEntry(*it); //throw X
+}
+
+
 void fff::saveLogFile(const AbstractPath& logFilePath, //throw FileError, X
                       const ProcessSummary& summary,
                       const ErrorLog& log,
+                      const LogSpool* logSpool,
                       int logfilesMaxAgeDays,
                       LogFileFormat logFormat,
                       const std::set<AbstractPath>& logsToKeepPaths,
@@ -662,7 +857,7 @@ void fff::saveLogFile(const AbstractPath& logFilePath, //throw FileError, X
     std::exception_ptr firstError;
     try
     {
-        saveNewLogFile(logFilePath, logFormat, summary, log, notifyStatus); //throw FileError, X
+        saveNewLogFile(logFilePath, logFormat, summary, log, logSpool, notifyStatus); //throw FileError, X
     }
     catch (const FileError&) { if (!firstError) firstError = std::current_exception(); };
 
@@ -684,6 +879,7 @@ void fff::saveLogFile(const AbstractPath& logFilePath, //throw FileError, X
 void fff::sendLogAsEmail(const std::string& email, //throw FileError, X
                          const ProcessSummary& summary,
                          const ErrorLog& log,
+                         const LogSpool* logSpool,
                          const AbstractPath& logFilePath,
                          const std::function<void(std::wstring&& msg)>& notifyStatus /*throw X*/)
 {
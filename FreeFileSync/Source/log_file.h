@@ -8,6 +8,7 @@
 #define GENERATE_LOGFILE_H_931726432167489732164
 
 #include <zen/error_log.h>
+#include <zen/file_io.h>
 #include "status_handler.h"
 #include "afs/abstract.h"
 
@@ -22,9 +23,46 @@ enum class LogFileFormat
 
 Zstring generateLogFileName(LogFileFormat logFormat, const ProcessSummary& summary);
 
+
+//stream log entries to a JSON Lines file while running:
+//- log is on disk even if the process is killed (leftover files are cleaned up like regular log files)
+//- flat memory: only the most recent info messages and the most recent warnings/errors are kept in memory
+//- used by batch runs only: GUI-initiated syncs still keep the full log in memory (MainDialog merges logs of consecutive runs)
+class LogSpool
+{
+public:
+    LogSpool(const Zstring& logFolderPath, const ProcessSummary& summary /*jobNames, startTime*/); //throw FileError
+
+    //write new entries to file, then drop old entries from "log"
+    void flush(zen::ErrorLog& log); //throw FileError; after failure: no-op, "log" is kept in memory
+
+    size_t getFlushedRows() const { return flushedRows_; } //"log" entries [0, getFlushedRows()) are already on disk: don't reorder!
+    int getDroppedCount() const { return droppedStats_.infos + droppedStats_.warnings + droppedStats_.errors; }
+
+    //full log stats: "log" + dropped entries
+    zen::ErrorLogStats getStats(const zen::ErrorLog& log) const;
+
+    //full log: entries on disk (read back) + unflushed entries of "log"
+    void forEachEntry(const zen::ErrorLog& log, const std::function<void(const zen::LogEntry& entry)>& onEntry) const; //throw FileError
+
+private:
+    LogSpool           (const LogSpool&) = delete;
+    LogSpool& operator=(const LogSpool&) = delete;
+
+    zen::FileOutputPlain fileOut_; //not close()d => deleted by destructor
+    uint64_t bytesWritten_ = 0; //excluding partial writes of failed flush()
+    size_t flushedRows_ = 0;
+    size_t infoRows_ = 0; //info messages in "log"
+    size_t failRows_ = 0; //warnings and errors in "log"
+    zen::ErrorLogStats droppedStats_;
+    bool writeFailed_ = false;
+};
+
+
 void saveLogFile(const AbstractPath& logFilePath, //throw FileError, X
                  const ProcessSummary& summary,
                  const zen::ErrorLog& log,
+                 const LogSpool* logSpool, //optional: entries dropped from "log"
                  int logfilesMaxAgeDays,
                  LogFileFormat logFormat,
                  const std::set<AbstractPath>& logsToKeepPaths,
@@ -33,6 +71,7 @@ void saveLogFile(const AbstractPath& logFilePath, //throw FileError, X
 void sendLogAsEmail(const std::string& email, //throw FileError, X
                     const ProcessSummary& summary,
                     const zen::ErrorLog& log,
+                    const LogSpool* logSpool, //optional
                     const AbstractPath& logFilePath,
                     const std::function<void(std::wstring&& msg)>& notifyStatus /*throw X*/);
 }
@@ -25,7 +25,8 @@ BatchStatusHandler::BatchStatusHandler(bool showProgress,
                                        const WindowLayout::Rect& dlgRect,
                                        bool autoCloseDialog,
                                        PostBatchAction postBatchAction,
-                                       BatchErrorHandling batchErrorHandling) :
+                                       BatchErrorHandling batchErrorHandling,
+                                       const Zstring& logSpoolFolderPath) :
     jobName_(jobName),
     startTime_(startTime),
     autoRetryCount_(autoRetryCount),
@@ -52,6 +53,13 @@ BatchStatusHandler::BatchStatusHandler(bool showProgress,
     }());
     //ATTENTION: "progressDlg_" is an unmanaged resource!!! However, at this point we already consider construction complete! =>
     //ZEN_ON_SCOPE_FAIL( cleanup(); ); //destructor call would lead to member double clean-up!!!
+
+    if (!logSpoolFolderPath.empty())
+        try
+        {
+            logSpool_ = std::make_shared<LogSpool>(logSpoolFolderPath, ProcessSummary{.startTime = startTime, .jobNames = {jobName}}); //throw FileError
+        }
+        catch (const FileError& e) { logMsg(errorLog_.ref(), e.toString(), MSG_TYPE_WARNING); } //log is still kept in memory
 }
 
 
@@ -72,7 +80,8 @@ BatchStatusHandler::Result BatchStatusHandler::prepareResult()
         !extraLog.empty())
     {
         append(errorLog_.ref(), extraLog);
-        std::stable_sort(errorLog_.ref().begin(), errorLog_.ref().end(), [](const LogEntry& lhs, const LogEntry& rhs) { return lhs.time < rhs.time; });
+        std::stable_sort(errorLog_.ref().begin() + (logSpool_ ? logSpool_->getFlushedRows() : 0), //don't reorder what's already on disk
+                         errorLog_.ref().end(), [](const LogEntry& lhs, const LogEntry& rhs) { return lhs.time < rhs.time; });
     }
 
     //determine post-sync status irrespective of further errors during tear-down
@@ -84,10 +93,10 @@ BatchStatusHandler::Result BatchStatusHandler::prepareResult()
             logMsg(errorLog_.ref(), _("Stopped"), MSG_TYPE_ERROR); //= user cancel or "stop on first error"
             return TaskResult::cancelled;
         }
-        const ErrorLogStats logCount = getStats(errorLog_.ref());
-        if (logCount.errors > 0)
+        const ErrorStats errorStats = getErrorStats(); //not getStats(errorLog_): LogSpool may have dropped warnings/errors
+        if (errorStats.errorCount > 0)
             return TaskResult::error;
-        else if (logCount.warnings > 0)
+        else if (errorStats.warningCount > 0)
             return TaskResult::warning;
 
         if (getTotalStats() == ProgressStats())
@@ -105,7 +114,9 @@ BatchStatusHandler::Result BatchStatusHandler::prepareResult()
         totalTime
     };
 
-    return {summary, errorLog_};
+    flushLogSpool();
+    //hand over: no more flushing (and dropping log entries) while the caller is writing the log file!
+    return {summary, errorLog_, std::exchange(logSpool_, nullptr)};
 }
 
 
@@ -366,6 +377,14 @@ ProcessCallback::Response BatchStatusHandler::reportError(const ErrorInfo& error
 }
 
 
+std::optional<ProcessCallback::ErrorPolicy> BatchStatusHandler::getErrorPolicy() const
+{
+    if (progressDlg_->getOptionIgnoreErrors())
+        return ErrorPolicy{autoRetryCount_, autoRetryDelay_}; //same as reportError(), minus the popup
+    return {};
+}
+
+
 void BatchStatusHandler::reportFatalError(const std::wstring& msg)
 {
     PauseTimers dummy(*progressDlg_);
@@ -428,5 +447,19 @@ Statistics::ErrorStats BatchStatusHandler::getErrorStats() const
 
 void BatchStatusHandler::forceUiUpdateNoThrow()
 {
+    flushLogSpool();
     progressDlg_->updateGui();
 }
+
+
+void BatchStatusHandler::flushLogSpool() //noexcept
+{
+    if (logSpool_)
+        try
+        {
+            getErrorStats(); //count warnings/errors *before* rows are moved around
+            logSpool_->flush(errorLog_.ref()); //throw FileError
+            errorStatsRowsChecked_ = errorLog_.ref().size();
+        }
+        catch (const FileError& e) { logMsg(errorLog_.ref(), e.toString(), MSG_TYPE_WARNING); } //log is still kept in memory
+}
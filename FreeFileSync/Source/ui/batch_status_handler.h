@@ -11,6 +11,7 @@
 #include "progress_indicator.h"
 #include "../config.h"
 #include "../status_handler.h"
+#include "../log_file.h"
 
 
 namespace fff
@@ -30,13 +31,15 @@ public:
                        const zen::WindowLayout::Rect& dlgRect,
                        bool autoCloseDialog,
                        PostBatchAction postBatchAction,
-                       BatchErrorHandling batchErrorHandling); //noexcept!!
+                       BatchErrorHandling batchErrorHandling,
+                       const Zstring& logSpoolFolderPath /*optional*/); //noexcept!!
     ~BatchStatusHandler();
 
     void     initNewPhase    (int itemsTotal, int64_t bytesTotal, ProcessPhase phaseID) override; //
     void     logMessage      (const std::wstring& msg, MsgType type)                    override; //
     void     reportWarning   (const std::wstring& msg, bool& warningActive)             override; //throw CancelProcess
     Response reportError     (const ErrorInfo& errorInfo)                               override; //
+    std::optional<ErrorPolicy> getErrorPolicy() const                                   override; //noexcept
     void     reportFatalError(const std::wstring& msg)                                  override; //
     ErrorStats getErrorStats() const override;
 
@@ -47,6 +50,7 @@ public:
     {
         ProcessSummary summary;
         zen::SharedRef<zen::ErrorLog> errorLog;
+        std::shared_ptr<const LogSpool> logSpool; //optional: entries dropped from errorLog
     };
     Result prepareResult();
 
@@ -66,6 +70,8 @@ public:
     wxWindow* getWindowIfVisible();
 
 private:
+    void flushLogSpool(); //noexcept
+
     const std::wstring jobName_;
     const std::chrono::system_clock::time_point startTime_;
     const size_t autoRetryCount_;
@@ -77,6 +83,7 @@ private:
     zen::SharedRef<zen::ErrorLog> errorLog_ = zen::makeSharedRef<zen::ErrorLog>();
     mutable Statistics::ErrorStats errorStatsBuf_{};
     mutable size_t errorStatsRowsChecked_ = 0;
+    std::shared_ptr<LogSpool> logSpool_; //optional
     const BatchErrorHandling batchErrorHandling_;
     bool switchToGuiRequested_ = false;
     std::optional<TaskResult> syncResult_;
@@ -260,7 +260,7 @@ void FolderSelector::onSelectFolder(wxCommandEvent& event)
 void FolderSelector::onSelectAltFolder(wxCommandEvent& event)
 {
     Zstring folderPathPhrase = getPath();
-    size_t parallelOps = getDeviceParallelOps_ ? getDeviceParallelOps_(folderPathPhrase) : 1;
+    size_t parallelOps = getDeviceParallelOps_ ? getDeviceParallelOps_(folderPathPhrase) : 0;
 
     const AbstractPath oldPath = createAbstractPath(folderPathPhrase);
 
@@ -269,7 +269,7 @@ void FolderSelector::onSelectAltFolder(wxCommandEvent& event)
 
     setPath(folderPathPhrase);
 
-    if (setDeviceParallelOps_)
+    if (setDeviceParallelOps_ && parallelOps != getDeviceParallelOps_(folderPathPhrase)) //avoid "fake" changed configs: store only values changed by the user
         setDeviceParallelOps_(folderPathPhrase, parallelOps);
 
     //notify action invoked by user
@@ -287,6 +287,14 @@ ProcessCallback::Response StatusHandlerTemporaryPanel::reportError(const ErrorIn
 }
 
 
+std::optional<ProcessCallback::ErrorPolicy> StatusHandlerTemporaryPanel::getErrorPolicy() const
+{
+    if (mainDlg_.compareStatus_->getOptionIgnoreErrors())
+        return ErrorPolicy{autoRetryCount_, autoRetryDelay_}; //same as reportError(), minus the popup
+    return {};
+}
+
+
 void StatusHandlerTemporaryPanel::reportFatalError(const std::wstring& msg)
 {
     PauseTimers dummy(*mainDlg_.compareStatus_);
@@ -646,6 +654,14 @@ ProcessCallback::Response StatusHandlerFloatingDialog::reportError(const ErrorIn
 }
 
 
+std::optional<ProcessCallback::ErrorPolicy> StatusHandlerFloatingDialog::getErrorPolicy() const
+{
+    if (progressDlg_->getOptionIgnoreErrors())
+        return ErrorPolicy{autoRetryCount_, autoRetryDelay_}; //same as reportError(), minus the popup
+    return {};
+}
+
+
 void StatusHandlerFloatingDialog::reportFatalError(const std::wstring& msg)
 {
     PauseTimers dummy(*progressDlg_);
@@ -34,6 +34,7 @@ public:
     void     logMessage      (const std::wstring& msg, MsgType type)                    override; //
     void     reportWarning   (const std::wstring& msg, bool& warningActive)             override; //throw CancelProcess
     Response reportError     (const ErrorInfo& errorInfo)                               override; //
+    std::optional<ErrorPolicy> getErrorPolicy() const                                   override; //noexcept
     void     reportFatalError(const std::wstring& msg)                                  override; //
     ErrorStats getErrorStats() const override;
 
@@ -84,6 +85,7 @@ public:
     void     logMessage      (const std::wstring& msg, MsgType type)                    override; //
     void     reportWarning   (const std::wstring& msg, bool& warningActive)             override; //throw CancelProcess
     Response reportError     (const ErrorInfo& errorInfo)                               override; //
+    std::optional<ErrorPolicy> getErrorPolicy() const                                   override; //noexcept
     void     reportFatalError(const std::wstring& msg)                                  override; //
     ErrorStats getErrorStats() const override;
 
@@ -234,9 +234,10 @@ private:
         return true; //do set dropped paths
     };
 
-    const std::function<size_t(const Zstring& folderPathPhrase)> getDeviceParallelOps_ = [&](const Zstring& folderPathPhrase)
+    const std::function<size_t(const Zstring& folderPathPhrase)> getDeviceParallelOps_ = [&](const Zstring& folderPathPhrase) -> size_t
     {
-        return getDeviceParallelOps(mainDlg_.currentCfg_.mainCfg.deviceParallelOps, folderPathPhrase);
+        const auto& deviceParallelOps = mainDlg_.currentCfg_.mainCfg.deviceParallelOps;
+        return haveDeviceParallelOps(deviceParallelOps, folderPathPhrase) ? getDeviceParallelOps(deviceParallelOps, folderPathPhrase) : 0; //0: default
     };
 
     const std::function<void(const Zstring& folderPathPhrase, size_t parallelOps)> setDeviceParallelOps_ = [&](const Zstring& folderPathPhrase, size_t parallelOps)
@@ -4611,6 +4612,8 @@ void MainDialog::onCompare(wxCommandEvent& event)
                              globalCfg_.createLockFile,
                              dirLocks,
                              fpCfgList,
+                             guiCfg.mainCfg.deviceParallelOps,
+                             std::nullopt /*changeList*/,
                              statusHandler); //throw CancelProcess
 
         //play (optional) sound notification
@@ -4891,6 +4894,7 @@ void MainDialog::onStartSync(wxCommandEvent& event)
                     globalCfg_.runWithBackgroundPriority,
                     extractSyncCfg(guiCfg.mainCfg),
                     folderCmp_,
+                    guiCfg.mainCfg.deviceParallelOps,
                     globalCfg_.warnDlgs,
                     statusHandler); //throw CancelProcess
     }
@@ -4979,7 +4983,7 @@ void MainDialog::onStartSync(wxCommandEvent& event)
                 try
                 {
                     logMsg2(replaceCpy(_("Sending email notification to %x"), L"%x", utfTo<std::wstring>(notifyEmail)), MSG_TYPE_INFO);
-                    sendLogAsEmail(notifyEmail, fullSummary, fullLog, logFilePath, notifyStatusNoThrow); //throw FileError
+                    sendLogAsEmail(notifyEmail, fullSummary, fullLog, nullptr /*logSpool*/, logFilePath, notifyStatusNoThrow); //throw FileError
                 }
                 catch (const FileError& e) { logMsg2(e.toString(), MSG_TYPE_ERROR); }
     }
@@ -4996,7 +5000,7 @@ void MainDialog::onStartSync(wxCommandEvent& event)
     try //create not before destruction: 1. avoid issues with FFS trying to sync open log file 2. include status in log file name without extra rename
     {
         //do NOT use tryReportingError()! saving log files should not be cancellable!
-        saveLogFile(logFilePath, fullSummary, fullLog, globalCfg_.logfilesMaxAgeDays, globalCfg_.logFormat, logsToKeepPaths, notifyStatusNoThrow); //throw FileError
+        saveLogFile(logFilePath, fullSummary, fullLog, nullptr /*logSpool*/, globalCfg_.logfilesMaxAgeDays, globalCfg_.logFormat, logsToKeepPaths, notifyStatusNoThrow); //throw FileError
     }
     catch (const FileError& e)
     {
@@ -5009,7 +5013,7 @@ void MainDialog::onStartSync(wxCommandEvent& event)
             logMsg2(e.toString(), MSG_TYPE_ERROR);
 
             logFilePath = logFileDefaultPath;
-            saveLogFile(logFileDefaultPath, fullSummary, fullLog, globalCfg_.logfilesMaxAgeDays, globalCfg_.logFormat, logsToKeepPaths, notifyStatusNoThrow); //throw FileError
+            saveLogFile(logFileDefaultPath, fullSummary, fullLog, nullptr /*logSpool*/, globalCfg_.logfilesMaxAgeDays, globalCfg_.logFormat, logsToKeepPaths, notifyStatusNoThrow); //throw FileError
         }
         catch (const FileError& e2) { logMsg2(e2.toString(), MSG_TYPE_ERROR); logExtraError(e2.toString()); } //should never happen!!!
     }
@@ -5219,6 +5223,7 @@ void MainDialog::startSyncForSelecction(const std::vector<FileSystemObject*>& se
                         globalCfg_.runWithBackgroundPriority,
                         fpCfgSelect,
                         folderCmpSelect,
+                        guiCfg.mainCfg.deviceParallelOps,
                         globalCfg_.warnDlgs,
                         statusHandler); //throw CancelProcess
         }
@@ -5733,7 +5738,7 @@ void MainDialog::applySyncDirections()
         try
         {
             statusHandler.initNewPhase(-1, -1, ProcessPhase::none);
-            redetermineSyncDirection(directCfgs,
+            redetermineSyncDirection(directCfgs, guiCfg.mainCfg.deviceParallelOps,
                                      statusHandler); //throw CancelProcess
         }
         catch (CancelProcess&) {}
@@ -300,6 +300,7 @@ CloudSetupDlg::CloudSetupDlg(wxWindow* parent, Zstring& folderPathPhrase, Zstrin
     m_textCtrlServer->SetMinSize({dipToWxsize(260), -1});
 
     m_textCtrlPort->SetMinSize({dipToWxsize(60), -1});
+    m_spinCtrlConnectionCount->SetRange(0, m_spinCtrlConnectionCount->GetMax()); //0: not set explicitly => default
     fixSpinCtrl(*m_spinCtrlConnectionCount);
     fixSpinCtrl(*m_spinCtrlChannelCountSftp);
     fixSpinCtrl(*m_spinCtrlTimeout);
@@ -955,7 +956,7 @@ CopyToDialog::CopyToDialog(wxWindow* parent,
 
     targetFolder.emplace(this, *this, *m_buttonSelectTargetFolder, *m_bpButtonSelectAltTargetFolder, *m_targetFolderPath,
                          targetFolderLastSelected, sftpKeyFileLastSelected, nullptr /*staticText*/, nullptr /*wxWindow*/, nullptr /*droppedPathsFilter*/,
-    [](const Zstring& folderPathPhrase) { return 1; } /*getDeviceParallelOps*/, nullptr /*setDeviceParallelOps*/);
+    [](const Zstring& folderPathPhrase) { return 0; } /*getDeviceParallelOps*/, nullptr /*setDeviceParallelOps*/);
 
     m_targetFolderPath->setHistory(std::make_shared<HistoryList>(folderHistory, folderHistoryMax));
 
@@ -1436,7 +1437,7 @@ OptionsDlg::OptionsDlg(wxWindow* parent, GlobalConfig& globalCfg) :
 
     logFolderSelector_(this, *m_panelLogfile, *m_buttonSelectLogFolder, *m_bpButtonSelectAltLogFolder, *m_logFolderPath, globalCfg.logFolderLastSelected, globalCfg.sftpKeyFileLastSelected,
                        nullptr /*staticText*/, nullptr /*dropWindow2*/, nullptr /*droppedPathsFilter*/,
-                       [](const Zstring& folderPathPhrase) { return 1; } /*getDeviceParallelOps_*/, nullptr /*setDeviceParallelOps_*/),
+                       [](const Zstring& folderPathPhrase) { return 0; } /*getDeviceParallelOps_*/, nullptr /*setDeviceParallelOps_*/),
                    globalCfgOut_(globalCfg)
 {
     setStandardButtonLayout(*bSizerStdButtons, StdButtons().setAffirmative(m_buttonOK).setCancel(m_buttonCancel));
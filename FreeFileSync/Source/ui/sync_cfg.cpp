@@ -391,6 +391,7 @@ private:
 
     MiscSyncConfig getMiscSyncOptions() const;
     void setMiscSyncOptions(const MiscSyncConfig& miscCfg);
+    void updatePerfDeviceLabels();
 
     void updateMiscGui();
 
@@ -475,12 +476,12 @@ ConfigDialog::ConfigDialog(wxWindow* parent,
                            std::vector<Zstring>& commandHistory, size_t commandHistoryMax) :
     ConfigDlgGenerated(parent),
 
-    getDeviceParallelOps_([this](const Zstring& folderPathPhrase)
+    getDeviceParallelOps_([this](const Zstring& folderPathPhrase) -> size_t
 {
     assert(selectedPairIndexToShow_ == -1 ||  makeUnsigned(selectedPairIndexToShow_) < localPairCfg_.size());
     const auto& deviceParallelOps = selectedPairIndexToShow_ < 0 ? getMiscSyncOptions().deviceParallelOps : globalPairCfg_.miscCfg.deviceParallelOps; //ternary-WTF!
 
-    return getDeviceParallelOps(deviceParallelOps, folderPathPhrase);
+    return haveDeviceParallelOps(deviceParallelOps, folderPathPhrase) ? getDeviceParallelOps(deviceParallelOps, folderPathPhrase) : 0; //0: default
 }),
 
 setDeviceParallelOps_([this](const Zstring& folderPathPhrase, size_t parallelOps) //setDeviceParallelOps()
@@ -1436,14 +1437,16 @@ MiscSyncConfig ConfigDialog::getMiscSyncOptions() const
 
     // Avoid "fake" changed configs! =>
     // - don't touch items corresponding to paths not currently used
-    // - don't store parallel ops == 1
+    // - store only values changed by the user (including 1: forces single thread for metadata tasks, too)
+    // - 0: back to default => remove item
     miscCfg.deviceParallelOps = deviceParallelOps_;
     assert(fgSizerPerf->GetItemCount() == 2 * devicesForEdit_.size());
     int i = 0;
     for (const AfsDevice& afsDevice : devicesForEdit_)
     {
         wxSpinCtrl* spinCtrlParallelOps = dynamic_cast<wxSpinCtrl*>(fgSizerPerf->GetItem(i * 2)->GetWindow());
-        setDeviceParallelOps(miscCfg.deviceParallelOps, afsDevice, spinCtrlParallelOps->GetValue());
+        if (makeUnsigned(spinCtrlParallelOps->GetValue()) != getDeviceParallelOpsCfg(deviceParallelOps_, afsDevice))
+            setDeviceParallelOps(miscCfg.deviceParallelOps, afsDevice, spinCtrlParallelOps->GetValue());
         ++i;
     }
     //----------------------------------------------------------------------------
@@ -1483,9 +1486,10 @@ void ConfigDialog::setMiscSyncOptions(const MiscSyncConfig& miscCfg)
     if (rowsToCreate >= 0)
         for (int i = 0; i < rowsToCreate; ++i)
         {
-            wxSpinCtrl* spinCtrlParallelOps = new wxSpinCtrl(m_scrolledWindowPerf, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 1, 2000'000'000, 1);
+            wxSpinCtrl* spinCtrlParallelOps = new wxSpinCtrl(m_scrolledWindowPerf, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize, wxSP_ARROW_KEYS, 0 /*default*/, 2000'000'000, 0);
             fixSpinCtrl(*spinCtrlParallelOps);
             spinCtrlParallelOps->Enable(enableExtraFeatures_);
+            spinCtrlParallelOps->Bind(wxEVT_SPINCTRL, [this](wxSpinEvent& event) { updatePerfDeviceLabels(); });
             fgSizerPerf->Add(spinCtrlParallelOps, 0, wxALIGN_CENTER_VERTICAL);
 
             wxStaticText* staticTextDevice = new wxStaticText(m_scrolledWindowPerf, wxID_ANY, wxEmptyString);
@@ -1500,16 +1504,13 @@ void ConfigDialog::setMiscSyncOptions(const MiscSyncConfig& miscCfg)
     int i = 0;
     for (const AfsDevice& afsDevice : devicesForEdit_)
     {
-        wxSpinCtrl*   spinCtrlParallelOps = dynamic_cast<wxSpinCtrl*>  (fgSizerPerf->GetItem(i * 2    )->GetWindow());
-        wxStaticText* staticTextDevice    = dynamic_cast<wxStaticText*>(fgSizerPerf->GetItem(i * 2 + 1)->GetWindow());
-
-        spinCtrlParallelOps->SetValue(static_cast<int>(getDeviceParallelOps(deviceParallelOps_, afsDevice)));
-        staticTextDevice->SetLabelText(AFS::getDisplayPath(AbstractPath(afsDevice, AfsPath())));
+        wxSpinCtrl* spinCtrlParallelOps = dynamic_cast<wxSpinCtrl*>(fgSizerPerf->GetItem(i * 2)->GetWindow());
+        spinCtrlParallelOps->SetValue(static_cast<int>(getDeviceParallelOpsCfg(deviceParallelOps_, afsDevice)));
         ++i;
     }
     m_staticTextPerfParallelOps->Enable(enableExtraFeatures_ && !devicesForEdit_.empty());
 
-    m_panelComparisonSettings->Layout(); //*after* setting text labels
+    updatePerfDeviceLabels();
 
     //----------------------------------------------------------------------------
     m_checkBoxIgnoreErrors  ->SetValue(miscCfg.ignoreErrors);
@@ -1538,6 +1539,26 @@ void ConfigDialog::setMiscSyncOptions(const MiscSyncConfig& miscCfg)
 }
 
 
+void ConfigDialog::updatePerfDeviceLabels()
+{
+    assert(fgSizerPerf->GetItemCount() == 2 * devicesForEdit_.size());
+    int i = 0;
+    for (const AfsDevice& afsDevice : devicesForEdit_)
+    {
+        wxSpinCtrl*   spinCtrlParallelOps = dynamic_cast<wxSpinCtrl*>  (fgSizerPerf->GetItem(i * 2    )->GetWindow());
+        wxStaticText* staticTextDevice    = dynamic_cast<wxStaticText*>(fgSizerPerf->GetItem(i * 2 + 1)->GetWindow());
+
+        std::wstring label = AFS::getDisplayPath(AbstractPath(afsDevice, AfsPath()));
+        if (spinCtrlParallelOps->GetValue() == 0) //not set explicitly
+            label += L" (" + _("Default") + L": " + formatNumber(getDeviceParallelOps({}, afsDevice)) + L')';
+
+        staticTextDevice->SetLabelText(label);
+        ++i;
+    }
+    m_panelComparisonSettings->Layout(); //*after* setting text labels
+}
+
+
 void ConfigDialog::updateMiscGui()
 {
     if (selectedPairIndexToShow_ == -1)
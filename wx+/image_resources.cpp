@@ -71,22 +71,6 @@ ImageHolder xbrzScale(int width, int height, const unsigned char* imageRgb, cons
 }
 
 
-auto createScalerTask(const std::string& imageName, const wxImage& img, int hqScale, Protected<std::vector<std::pair<std::string, ImageHolder>>>& protResult)
-{
-    assert(runningOnMainThread());
-    return [imageName,
-            width  = img.GetWidth(),  //
-            height = img.GetHeight(), //don't call these wxWidgets functions from worker thread
-            rgb    = img.GetData(),   //
-            alpha  = img.GetAlpha(),  //
-            hqScale, &protResult]
-    {
-        ImageHolder ih = xbrzScale(width, height, rgb, alpha, hqScale);
-        protResult.access([&](std::vector<std::pair<std::string, ImageHolder>>& result) { result.emplace_back(imageName, std::move(ih)); });
-    };
-}
-
-
 class HqParallelScaler
 {
 public:
@@ -98,36 +82,49 @@ public:
     {
         assert(runningOnMainThread());
         imgKeeper_.push_back(img); //retain (ref-counted) wxImage so that the rgb/alpha pointers remain valid after passed to threads
-        threadGroup_->run(createScalerTask(imageName, img, hqScale_, protResult_));
+        threadGroup_->run([imageName,
+                           width  = img.GetWidth(),  //
+                           height = img.GetHeight(), //don't call these wxWidgets functions from worker thread
+                           rgb    = img.GetData(),   //
+                           alpha  = img.GetAlpha(),  //
+                           hqScale = hqScale_, this]
+        {
+            ImageHolder ih = xbrzScale(width, height, rgb, alpha, hqScale);
+            {
+                std::lock_guard dummy(lockResult_);
+                result_.emplace(imageName, std::move(ih));
+            }
+            conditionResultReady_.notify_all();
+        });
     }
 
-    std::unordered_map<std::string, wxImage> waitAndGetResult()
+    //wait for this image only: scaling of the others continues in the background
+    wxImage waitAndGetResult(const std::string& imageName)
     {
         assert(runningOnMainThread());
-        threadGroup_->wait();
-
-        std::unordered_map<std::string, wxImage> output;
-
-        protResult_.access([&](std::vector<std::pair<std::string, ImageHolder>>& result)
+        ImageHolder ih;
         {
-            for (auto& [imageName, ih] : result)
-            {
-                wxImage img(ih.getWidth(), ih.getHeight(), ih.releaseRgb(), false /*static_data*/); //pass ownership
-                img.SetAlpha(ih.releaseAlpha(), false /*static_data*/);
+            std::unique_lock dummy(lockResult_);
+            conditionResultReady_.wait(dummy, [&] { return result_.contains(imageName); });
 
-                output.emplace(imageName, std::move(img));
-            }
-        });
-        return output;
+            auto it = result_.find(imageName);
+            ih = std::move(it->second);
+            result_.erase(it);
+        }
+        wxImage img(ih.getWidth(), ih.getHeight(), ih.releaseRgb(), false /*static_data*/); //pass ownership
+        img.SetAlpha(ih.releaseAlpha(), false /*static_data*/);
+        return img;
     }
 
 private:
     const int hqScale_;
     std::vector<wxImage> imgKeeper_;
-    Protected<std::vector<std::pair<std::string, ImageHolder>>> protResult_;
 
-    using TaskType = FunctionReturnTypeT<decltype(&createScalerTask)>;
-    std::optional<ThreadGroup<TaskType>> threadGroup_{ThreadGroup<TaskType>(std::max<int>(std::thread::hardware_concurrency(), 1), Zstr("xBRZ Scaler"))};
+    std::mutex lockResult_;
+    std::unordered_map<std::string, ImageHolder> result_;
+    std::condition_variable conditionResultReady_;
+
+    std::optional<ThreadGroup<std::function<void()>>> threadGroup_{ThreadGroup<std::function<void()>>(std::max<int>(std::thread::hardware_concurrency(), 1), Zstr("xBRZ Scaler"))};
     //hardware_concurrency() == 0 if "not computable or well defined"
 };
 
@@ -148,6 +145,7 @@ private:
     const wxImage& getRawImage   (const std::string& name);
     const wxImage& getHqScaledImage(const std::string& name);
 
+    std::unordered_map<std::string, std::string> imageStreams_; //PNG byte streams: decode lazily on first use
     std::unordered_map<std::string, wxImage> imagesRaw_;
     std::unordered_map<std::string, wxImage> imagesScaled_;
 
@@ -235,29 +233,11 @@ ImageBuffer::ImageBuffer(const Zstring& zipPath) //throw FileError
     if (hqScale > 1)
         hqScaler_.emplace(hqScale);
 
-    for (const auto& [fileName, stream] : streams)
+    //only a fraction of all PNGs is needed for the first dialog => defer wxImage creation until first getImage()
+    //wxImage is not thread-safe => decode on main thread, then xBRZ-scale in the background right away
+    for (auto& [fileName, stream] : streams)
         if (endsWith(fileName, Zstr(".png")))
-        {
-            wxMemoryInputStream wxstream(stream.c_str(), stream.size()); //stream does not take ownership of data
-
-            wxImage img(wxstream, wxBITMAP_TYPE_PNG);
-            assert(img.IsOk());
-
-            //end this alpha/no-alpha/mask/wxDC::DrawBitmap/RTL/high-contrast-scheme interoperability nightmare here and now!!!!
-            //=> there's only one type of wxImage: with alpha channel, no mask!!!
-            convertToVanillaImage(img);
-
-            const std::string imageName = utfTo<std::string>(beforeLast(fileName, Zstr("."), IfNotFoundReturn::none));
-
-            imagesRaw_.emplace(imageName, img);
-            if (hqScaler_)
-                hqScaler_->add(imageName, img); //scale in parallel!
-            else
-                imagesScaled_.emplace(imageName, img);
-
-            //wxBitmap::NewFromPNGData(stream.c_str(), stream.size())?
-            //  => Windows: just a (slow!) wrapper for wxBitmap(wxImage())!
-        }
+            imageStreams_.emplace(utfTo<std::string>(beforeLast(fileName, Zstr("."), IfNotFoundReturn::none)), std::move(stream));
         else
             assert(false);
 }
@@ -265,32 +245,48 @@ ImageBuffer::ImageBuffer(const Zstring& zipPath) //throw FileError
 
 const wxImage& ImageBuffer::getRawImage(const std::string& name)
 {
-    if (auto it = imagesRaw_.find(name);
-        it != imagesRaw_.end())
-        return it->second;
+    auto it = imagesRaw_.find(name);
+    if (it == imagesRaw_.end())
+    {
+        auto itStream = imageStreams_.find(name);
+        if (itStream == imageStreams_.end())
+        {
+            assert(false);
+            return wxNullImage;
+        }
 
-    assert(false);
-    return wxNullImage;
+        wxMemoryInputStream wxstream(itStream->second.c_str(), itStream->second.size()); //stream does not take ownership of data
+
+        wxImage img(wxstream, wxBITMAP_TYPE_PNG);
+        assert(img.IsOk());
+
+        //end this alpha/no-alpha/mask/wxDC::DrawBitmap/RTL/high-contrast-scheme interoperability nightmare here and now!!!!
+        //=> there's only one type of wxImage: with alpha channel, no mask!!!
+        convertToVanillaImage(img);
+
+        //wxBitmap::NewFromPNGData(stream.c_str(), stream.size())?
+        //  => Windows: just a (slow!) wrapper for wxBitmap(wxImage())!
+
+        it = imagesRaw_.emplace(name, img).first;
+        imageStreams_.erase(itStream); //no longer needed
+
+        if (hqScaler_ && img.IsOk())
+            hqScaler_->add(name, img); //scale in parallel!
+    }
+    return it->second;
 }
 
 
 const wxImage& ImageBuffer::getHqScaledImage(const std::string& name)
 {
-    //test: this function is first called about 220ms after ImageBuffer::ImageBuffer() has ended
-    //      => should be enough time to finish xBRZ scaling in parallel (which takes 50ms)
-    //debug perf: extra 800-1000ms during startup
-    if (hqScaler_)
-    {
-        imagesScaled_ = hqScaler_->waitAndGetResult();
-        hqScaler_.reset();
-    }
-
-    if (auto it = imagesScaled_.find(name);
-        it != imagesScaled_.end())
-        return it->second;
+    const wxImage& rawImg = getRawImage(name); //=> queued for scaling
+    if (!hqScaler_ || !rawImg.IsOk())
+        return rawImg;
 
-    assert(false);
-    return wxNullImage;
+    auto it = imagesScaled_.find(name);
+    if (it == imagesScaled_.end())
+        it = imagesScaled_.emplace(name, hqScaler_->waitAndGetResult(name)).first;
+    return it->second;
 }
 
 
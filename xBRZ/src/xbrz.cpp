@@ -19,9 +19,14 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath> //std::sqrt
+#include <limits>
 #include <vector>
 #include "xbrz_tools.h"
 
+#if defined __GNUC__ && defined __x86_64__
+    #include <immintrin.h>
+#endif
+
 using namespace xbrz;
 
 
@@ -279,9 +284,9 @@ struct Kernel_4x4 : Kernel_3x3
     | J | K | L | M |
     -----------------                                                         */
 
-template <class ColorDistance>
+template <class DiagonalDistances>
 FORCE_INLINE //detect blend direction
-BlendResult preProcessCorners(const Kernel_4x4& ker, const xbrz::ScalerCfg& cfg) //result: E, F, H, I corners of "GradientType"
+BlendResult preProcessCorners(const Kernel_4x4& ker, const DiagonalDistances& dd, int x, const xbrz::ScalerCfg& cfg) //result: E, F, H, I corners of "GradientType"
 {
     if ((ker.e == ker.f &&
          ker.h == ker.i) ||
@@ -289,10 +294,10 @@ BlendResult preProcessCorners(const Kernel_4x4& ker, const xbrz::ScalerCfg& cfg)
          ker.f == ker.i))
         return {};
 
-    auto dist = [&](uint32_t pix1, uint32_t pix2) { return ColorDistance::dist(pix1, pix2, cfg.testAttribute); };
-
-    const double hf = dist(ker.g, ker.e) + dist(ker.e, ker.c) + dist(ker.k, ker.i) + dist(ker.i, ker.o) + cfg.centerDirectionBias * dist(ker.h, ker.f);
-    const double ei = dist(ker.d, ker.h) + dist(ker.h, ker.l) + dist(ker.b, ker.f) + dist(ker.f, ker.n) + cfg.centerDirectionBias * dist(ker.e, ker.i);
+    //same summation order as dist(g, e) + dist(e, c) + dist(k, i) + dist(i, o) + cfg.centerDirectionBias * dist(h, f) => bit-identical result
+    const double hf = dd.antiDiag(0, x - 1) + dd.antiDiag(-1, x) + dd.antiDiag(1, x) + dd.antiDiag(0, x + 1) + cfg.centerDirectionBias * dd.antiDiag(0, x);
+    const double ei = dd.mainDiag(0, x - 1) + dd.mainDiag( 1, x) + dd.mainDiag(-1, x) + dd.mainDiag(0, x + 1) + cfg.centerDirectionBias * dd.mainDiag(0, x);
+    //= dist(d, h) + dist(h, l) + dist(b, f) + dist(f, n) + cfg.centerDirectionBias * dist(e, i)
 
     BlendResult result = {};
     if (hf < ei) //test sample: 70% of values max(hf, ei) / min(hf, ei) are between 1.1 and 3.7 with median being 1.8
@@ -526,6 +531,207 @@ private:
 };
 
 
+//color distance of all horizontally adjacent pixels of two rows
+template <class ColorDistance> inline
+void calcRowDistances(const uint32_t* rowTop, const uint32_t* rowBottom, double* antiDiag, double* mainDiag, int count, double testAttribute)
+{
+    for (int x = 0; x < count; ++x)
+    {
+        antiDiag[x] = ColorDistance::dist(rowBottom[x], rowTop[x + 1], testAttribute);
+        mainDiag[x] = ColorDistance::dist(rowTop[x], rowBottom[x + 1], testAttribute);
+    }
+}
+
+
+struct ColorDistanceUnbufferedARGB;
+
+#if defined __GNUC__ && defined __x86_64__
+/*  SIMD version of ColorDistanceUnbufferedARGB::dist() with 2 (SSE2) or 4 (AVX2) distances per iteration
+    - bit-identical results: same operations in same order as the scalar code; no FMA!
+    - alpha is divided by 255.0 (not multiplied with reciprocal) and sqrt() is correctly rounded for both scalar and SIMD  */
+namespace simd
+{
+const double k_b = 0.0593; //ITU-R BT.2020 conversion (see distYCbCr())
+const double k_r = 0.2627; //
+const double k_g = 1 - k_b - k_r;
+
+const double scale_b = 0.5 / (1 - k_b);
+const double scale_r = 0.5 / (1 - k_r);
+
+
+inline
+__m128i channelDiff(__m128i pix1, __m128i pix2, int shift)
+{
+    const __m128i mask = _mm_set1_epi32(0xff);
+    return _mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(pix1, shift), mask),
+                         _mm_and_si128(_mm_srli_epi32(pix2, shift), mask));
+}
+
+
+inline
+__m128d distArgb2(__m128i pix1, __m128i pix2) //lower 2 pixels
+{
+    const __m128d r_diff = _mm_cvtepi32_pd(channelDiff(pix1, pix2, 16));
+    const __m128d g_diff = _mm_cvtepi32_pd(channelDiff(pix1, pix2,  8));
+    const __m128d b_diff = _mm_cvtepi32_pd(channelDiff(pix1, pix2,  0));
+
+    const __m128d y = _mm_add_pd(_mm_add_pd(_mm_mul_pd(_mm_set1_pd(k_r), r_diff),
+                                            _mm_mul_pd(_mm_set1_pd(k_g), g_diff)),
+                                 _mm_mul_pd(_mm_set1_pd(k_b), b_diff));
+    const __m128d c_b = _mm_mul_pd(_mm_set1_pd(scale_b), _mm_sub_pd(b_diff, y));
+    const __m128d c_r = _mm_mul_pd(_mm_set1_pd(scale_r), _mm_sub_pd(r_diff, y));
+
+    const __m128d d = _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(y, y), _mm_mul_pd(c_b, c_b)), _mm_mul_pd(c_r, c_r)));
+
+    const __m128d a1 = _mm_div_pd(_mm_cvtepi32_pd(_mm_srli_epi32(pix1, 24)), _mm_set1_pd(255.0));
+    const __m128d a2 = _mm_div_pd(_mm_cvtepi32_pd(_mm_srli_epi32(pix2, 24)), _mm_set1_pd(255.0));
+    const __m128d aMin = _mm_min_pd(a1, a2);
+    const __m128d aMax = _mm_max_pd(a1, a2);
+
+    return _mm_add_pd(_mm_mul_pd(aMin, d), _mm_mul_pd(_mm_set1_pd(255), _mm_sub_pd(aMax, aMin)));
+}
+
+
+inline
+void calcRowDistancesSse2(const uint32_t* rowTop, const uint32_t* rowBottom, double* antiDiag, double* mainDiag, int count)
+{
+    int x = 0;
+    for (; x + 2 <= count; x += 2)
+    {
+        const __m128i top        = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(rowTop    + x));
+        const __m128i topNext    = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(rowTop    + x + 1));
+        const __m128i bottom     = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(rowBottom + x));
+        const __m128i bottomNext = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(rowBottom + x + 1));
+
+        _mm_storeu_pd(antiDiag + x, distArgb2(bottom, topNext));
+        _mm_storeu_pd(mainDiag + x, distArgb2(top, bottomNext));
+    }
+    for (; x < count; ++x)
+    {
+        antiDiag[x] = _mm_cvtsd_f64(distArgb2(_mm_cvtsi32_si128(static_cast<int>(rowBottom[x])), _mm_cvtsi32_si128(static_cast<int>(rowTop   [x + 1]))));
+        mainDiag[x] = _mm_cvtsd_f64(distArgb2(_mm_cvtsi32_si128(static_cast<int>(rowTop   [x])), _mm_cvtsi32_si128(static_cast<int>(rowBottom[x + 1]))));
+    }
+}
+
+
+__attribute__((target("avx2"))) inline
+__m256d distArgb4(__m128i pix1, __m128i pix2)
+{
+    const __m256d r_diff = _mm256_cvtepi32_pd(channelDiff(pix1, pix2, 16));
+    const __m256d g_diff = _mm256_cvtepi32_pd(channelDiff(pix1, pix2,  8));
+    const __m256d b_diff = _mm256_cvtepi32_pd(channelDiff(pix1, pix2,  0));
+
+    const __m256d y = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(k_r), r_diff),
+                                                  _mm256_mul_pd(_mm256_set1_pd(k_g), g_diff)),
+                                    _mm256_mul_pd(_mm256_set1_pd(k_b), b_diff));
+    const __m256d c_b = _mm256_mul_pd(_mm256_set1_pd(scale_b), _mm256_sub_pd(b_diff, y));
+    const __m256d c_r = _mm256_mul_pd(_mm256_set1_pd(scale_r), _mm256_sub_pd(r_diff, y));
+
+    const __m256d d = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(y, y), _mm256_mul_pd(c_b, c_b)), _mm256_mul_pd(c_r, c_r)));
+
+    const __m256d a1 = _mm256_div_pd(_mm256_cvtepi32_pd(_mm_srli_epi32(pix1, 24)), _mm256_set1_pd(255.0));
+    const __m256d a2 = _mm256_div_pd(_mm256_cvtepi32_pd(_mm_srli_epi32(pix2, 24)), _mm256_set1_pd(255.0));
+    const __m256d aMin = _mm256_min_pd(a1, a2);
+    const __m256d aMax = _mm256_max_pd(a1, a2);
+
+    return _mm256_add_pd(_mm256_mul_pd(aMin, d), _mm256_mul_pd(_mm256_set1_pd(255), _mm256_sub_pd(aMax, aMin)));
+}
+
+
+__attribute__((target("avx2")))
+void calcRowDistancesAvx2(const uint32_t* rowTop, const uint32_t* rowBottom, double* antiDiag, double* mainDiag, int count)
+{
+    int x = 0;
+    for (; x + 4 <= count; x += 4)
+    {
+        const __m128i top        = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowTop    + x));
+        const __m128i topNext    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowTop    + x + 1));
+        const __m128i bottom     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowBottom + x));
+        const __m128i bottomNext = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowBottom + x + 1));
+
+        _mm256_storeu_pd(antiDiag + x, distArgb4(bottom, topNext));
+        _mm256_storeu_pd(mainDiag + x, distArgb4(top, bottomNext));
+    }
+    calcRowDistancesSse2(rowTop + x, rowBottom + x, antiDiag + x, mainDiag + x, count - x);
+}
+}
+
+
+template <> inline
+void calcRowDistances<ColorDistanceUnbufferedARGB>(const uint32_t* rowTop, const uint32_t* rowBottom, double* antiDiag, double* mainDiag, int count, double /*testAttribute*/)
+{
+    static const bool haveAvx2 = __builtin_cpu_supports("avx2");
+    if (haveAvx2)
+        simd::calcRowDistancesAvx2(rowTop, rowBottom, antiDiag, mainDiag, count);
+    else
+        simd::calcRowDistancesSse2(rowTop, rowBottom, antiDiag, mainDiag, count); //SSE2: x86-64 baseline
+}
+#endif
+
+
+/*  preProcessCorners() needs 10 color distances per pixel, but each one is shared by 5 kernels
+    => calculate distances between diagonal neighbors once per pair of rows and keep a rolling window of 3 row pairs: (y-1, y), (y, y+1), (y+1, y+2)
+
+    antiDiag(dy, x): dist(pixel(x,     y + dy + 1), pixel(x + 1, y + dy))
+    mainDiag(dy, x): dist(pixel(x,     y + dy),     pixel(x + 1, y + dy + 1))        with x in [-2, srcWidth], dy in [-1, 1]  */
+template <class ColorDistance, class OobReader>
+class DiagonalDistances
+{
+public:
+    DiagonalDistances(const uint32_t* src, int srcWidth, int srcHeight, const xbrz::ScalerCfg& cfg) :
+        src_(src), srcWidth_(srcWidth), srcHeight_(srcHeight), testAttribute_(cfg.testAttribute),
+        rowBuf_(2 * (srcWidth + 4)),
+        distBuf_(2 * 3 * (srcWidth + 3)) {}
+
+    void setRow(int y) //for kernels with E on row y
+    {
+        if (y == y_ + 1) //rolling window
+        {
+            std::rotate(rowPairs_, rowPairs_ + 1, rowPairs_ + 3);
+            calcRowPair(rowPairs_[2], y + 1);
+        }
+        else if (y != y_)
+            for (int dy = -1; dy <= 1; ++dy)
+                calcRowPair(rowPairs_[dy + 1], y + dy);
+        y_ = y;
+    }
+
+    double antiDiag(int dy, int x) const { return distBuf_[ rowPairs_[dy + 1]                         * (srcWidth_ + 3) + x + 2]; }
+    double mainDiag(int dy, int x) const { return distBuf_[(rowPairs_[dy + 1] + 3) * (srcWidth_ + 3) + x + 2]; }
+
+private:
+    void calcRowPair(int idx, int y) //rows (y, y + 1)
+    {
+        uint32_t* const rowTop    = rowBuf_.data();
+        uint32_t* const rowBottom = rowBuf_.data() + srcWidth_ + 4;
+
+        //read columns [-2, srcWidth + 1] with the same out-of-bounds semantics as the kernel
+        const OobReader oobReader(src_, srcWidth_, srcHeight_, y + 1); //readPonm(): rows y, y + 1 at positions P, O
+        Kernel_4x4 ker = {};
+        for (int x = -2; x <= srcWidth_ + 1; ++x)
+        {
+            oobReader.readPonm(ker, x - 2);
+            rowTop   [x + 2] = ker.p;
+            rowBottom[x + 2] = ker.o;
+        }
+
+        calcRowDistances<ColorDistance>(rowTop, rowBottom,
+                                        &distBuf_[ idx      * (srcWidth_ + 3)],
+                                        &distBuf_[(idx + 3) * (srcWidth_ + 3)], srcWidth_ + 3, testAttribute_);
+    }
+
+    const uint32_t* const src_;
+    const int srcWidth_;
+    const int srcHeight_;
+    const double testAttribute_;
+
+    std::vector<uint32_t> rowBuf_;
+    std::vector<double> distBuf_; //3 rows of anti diagonal distances, followed by 3 rows of main diagonal distances
+    int rowPairs_[3] = {0, 1, 2}; //buffer index for row pairs (y-1, y), (y, y+1), (y+1, y+2)
+    int y_ = std::numeric_limits<int>::min();
+};
+
+
 inline
 void fillBlock(uint32_t* trg, int trgWidth, uint32_t col, int blockSize)
 {
@@ -550,10 +756,13 @@ void scaleImage(const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight,
     //buffer for "on the fly preprocessing" without risk of accidental overwriting before accessing
     unsigned char* const preProcBuf = reinterpret_cast<unsigned char*>(trg + yLast * Scaler::scale * trgWidth) - srcWidth;
 
+    DiagonalDistances<ColorDistance, OobReader> diagDist(src, srcWidth, srcHeight, cfg);
+
     //initialize preprocessing buffer for first row of current stripe: detect upper left and right corner blending
     //this cannot be optimized for adjacent processing stripes; we must not allow for a memory race condition!
     {
         const OobReader oobReader(src, srcWidth, srcHeight, yFirst - 1);
+        diagDist.setRow(yFirst - 1);
 
         //initialize at position x = -1
         Kernel_4x4 ker4 = {};
@@ -578,7 +787,7 @@ void scaleImage(const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight,
         oobReader.readPonm(ker4, -1);
 
         {
-            const BlendResult res = preProcessCorners<ColorDistance>(ker4, cfg);
+            const BlendResult res = preProcessCorners(ker4, diagDist, -1, cfg);
             clearAddTopL(preProcBuf[0], res.blend_i); //set 1st known corner for (0, yFirst)
         }
 
@@ -607,7 +816,7 @@ void scaleImage(const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight,
                 |---+---|   current input pixel is at position E
                 | H | I |
                 ---------                                        */
-            const BlendResult res = preProcessCorners<ColorDistance>(ker4, cfg);
+            const BlendResult res = preProcessCorners(ker4, diagDist, x, cfg);
             addTopR(preProcBuf[x], res.blend_h); //set 2nd known corner for (x, yFirst)
 
             if (x + 1 < srcWidth)
@@ -621,6 +830,7 @@ void scaleImage(const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight,
         uint32_t* out = trg + Scaler::scale * y * trgWidth; //consider MT "striped" access
 
         const OobReader oobReader(src, srcWidth, srcHeight, y);
+        diagDist.setRow(y);
 
         //initialize at position x = -1
         Kernel_4x4 ker4 = {};
@@ -646,7 +856,7 @@ void scaleImage(const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight,
 
         unsigned char blend_xy1 = 0; //corner blending for current (x, y + 1) position
         {
-            const BlendResult res = preProcessCorners<ColorDistance>(ker4, cfg);
+            const BlendResult res = preProcessCorners(ker4, diagDist, -1, cfg);
             clearAddTopL(blend_xy1, res.blend_i); //set 1st known corner for (0, y + 1) and buffer for use on next column
 
             addBottomL(preProcBuf[0], res.blend_f); //set 3rd known corner for (0, y)
@@ -680,7 +890,7 @@ void scaleImage(const uint32_t* src, uint32_t* trg, int srcWidth, int srcHeight,
                     |---+---|   current input pixel is at position E
                     | H | I |
                     ---------                                        */
-                const BlendResult res = preProcessCorners<ColorDistance>(ker4, cfg);
+                const BlendResult res = preProcessCorners(ker4, diagDist, x, cfg);
                 addBottomR(blend_xy, res.blend_e); //all four corners of (x, y) have been determined at this point due to processing sequence!
 
                 addTopR(blend_xy1, res.blend_h); //set 2nd known corner for (x, y + 1)
@@ -0,0 +1,299 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#include "crc.h"
+#include <bit>
+#include <cstring> //memcpy
+#include <algorithm>
+
+#if defined __GNUC__ && defined __x86_64__
+    #include <immintrin.h>
+#elif defined __GNUC__ && defined __aarch64__
+    #include <arm_acle.h>
+    #ifdef __linux__
+        #include <sys/auxv.h>
+        #include <asm/hwcap.h>
+    #endif
+#endif
+
+using namespace zen;
+
+
+namespace
+{
+struct Crc32Tables
+{
+    uint32_t t[16][256] = {};
+};
+
+constexpr Crc32Tables crc32Tables = []
+{
+    Crc32Tables tables;
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit)
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0); //reversed polynomial of CRC-32 (IEEE 802.3)
+        tables.t[0][i] = crc;
+    }
+    for (int k = 1; k < 16; ++k) //slice-by-16: table k = CRC contribution of a byte followed by k zero bytes
+        for (int i = 0; i < 256; ++i)
+            tables.t[k][i] = (tables.t[k - 1][i] >> 8) ^ tables.t[0][tables.t[k - 1][i] & 0xFF];
+    return tables;
+}();
+static_assert(arrayHash(crc32Tables.t[0]) == 2988069445); //= byte-at-a-time table used previously
+
+
+inline
+uint32_t crc32Bytewise(uint32_t crc, const unsigned char* buffer, size_t bytes)
+{
+    for (; bytes > 0; ++buffer, --bytes)
+        crc = (crc >> 8) ^ crc32Tables.t[0][(crc ^ *buffer) & 0xFF];
+    return crc;
+}
+
+
+//https://create.stephan-brumme.com/crc32/#slicing-by-16-overview
+uint32_t crc32Slice16(uint32_t crc, const unsigned char* buffer, size_t bytes)
+{
+    if constexpr (std::endian::native == std::endian::little)
+    {
+        const auto& t = crc32Tables.t;
+        for (; bytes >= 16; buffer += 16, bytes -= 16)
+        {
+            uint32_t w[4] = {};
+            std::memcpy(w, buffer, sizeof(w));
+            w[0] ^= crc;
+
+            crc = t[15][ w[0]        & 0xFF] ^ t[14][(w[0] >>  8) & 0xFF] ^ t[13][(w[0] >> 16) & 0xFF] ^ t[12][w[0] >> 24] ^
+                  t[11][ w[1]        & 0xFF] ^ t[10][(w[1] >>  8) & 0xFF] ^ t[ 9][(w[1] >> 16) & 0xFF] ^ t[ 8][w[1] >> 24] ^
+                  t[ 7][ w[2]        & 0xFF] ^ t[ 6][(w[2] >>  8) & 0xFF] ^ t[ 5][(w[2] >> 16) & 0xFF] ^ t[ 4][w[2] >> 24] ^
+                  t[ 3][ w[3]        & 0xFF] ^ t[ 2][(w[3] >>  8) & 0xFF] ^ t[ 1][(w[3] >> 16) & 0xFF] ^ t[ 0][w[3] >> 24];
+        }
+    }
+    return crc32Bytewise(crc, buffer, bytes);
+}
+
+
+#if defined __GNUC__ && defined __x86_64__
+/*  carry-less multiplication: fold 4 x 128 bits in parallel, then reduce to 32 bits (Barrett)
+    "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" (Intel, 2009)
+    constants for reflected CRC-32: same as Linux kernel arch/x86/crypto/crc32-pclmul_asm.S   */
+__attribute__((target("pclmul"))) inline
+__m128i fold(__m128i x, __m128i k, __m128i next) //lambda would not inherit target attribute
+{
+    return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00),
+                                       _mm_clmulepi64_si128(x, k, 0x11)), next);
+}
+
+
+__attribute__((target("pclmul")))
+uint32_t crc32Pclmul(uint32_t crc, const unsigned char* buffer, size_t bytes)
+{
+    if (bytes < 64)
+        return crc32Slice16(crc, buffer, bytes);
+
+    const __m128i k1k2   = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4); //x^(4*128+32) mod P, x^(4*128-32) mod P
+    const __m128i k3k4   = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0); //x^(128+32) mod P,   x^(128-32) mod P
+    const __m128i k5     = _mm_set_epi64x(0,            0x0163cd6124); //x^64 mod P
+    const __m128i poly   = _mm_set_epi64x(0x01f7011641, 0x01db710641); //u = floor(x^64 / P), P
+    const __m128i mask32 = _mm_set_epi32(0, 0, 0, -1);
+
+    auto load = [](const unsigned char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+
+    __m128i x1 = _mm_xor_si128(load(buffer), _mm_cvtsi32_si128(static_cast<int>(crc)));
+    __m128i x2 = load(buffer + 16);
+    __m128i x3 = load(buffer + 32);
+    __m128i x4 = load(buffer + 48);
+    buffer += 64;
+    bytes  -= 64;
+
+    for (; bytes >= 64; buffer += 64, bytes -= 64)
+    {
+        x1 = fold(x1, k1k2, load(buffer));
+        x2 = fold(x2, k1k2, load(buffer + 16));
+        x3 = fold(x3, k1k2, load(buffer + 32));
+        x4 = fold(x4, k1k2, load(buffer + 48));
+    }
+
+    x1 = fold(x1, k3k4, x2);
+    x1 = fold(x1, k3k4, x3);
+    x1 = fold(x1, k3k4, x4);
+
+    for (; bytes >= 16; buffer += 16, bytes -= 16)
+        x1 = fold(x1, k3k4, load(buffer));
+
+    //128 -> 64 bits
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k3k4, 0x10), _mm_srli_si128(x1, 8));
+
+    //64 -> 32 bits
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k5, 0x00), _mm_srli_si128(x1, 4));
+
+    //Barrett reduction
+    __m128i t = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), poly, 0x10);
+    t = _mm_clmulepi64_si128(_mm_and_si128(t, mask32), poly, 0x00);
+    x1 = _mm_xor_si128(x1, t);
+
+    crc = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(x1, 4)));
+
+    return crc32Slice16(crc, buffer, bytes);
+}
+
+#elif defined __GNUC__ && defined __aarch64__
+__attribute__((target("arch=armv8-a+crc")))
+uint32_t crc32Armv8(uint32_t crc, const unsigned char* buffer, size_t bytes)
+{
+    for (; bytes >= 8; buffer += 8, bytes -= 8)
+    {
+        uint64_t v = 0;
+        std::memcpy(&v, buffer, sizeof(v));
+        crc = __crc32d(crc, v);
+    }
+    for (; bytes > 0; ++buffer, --bytes)
+        crc = __crc32b(crc, *buffer);
+    return crc;
+}
+#endif
+
+
+using Crc32Function = uint32_t (*)(uint32_t crc, const unsigned char* buffer, size_t bytes);
+
+Crc32Function selectCrc32Function()
+{
+#if defined __GNUC__ && defined __x86_64__
+    if (__builtin_cpu_supports("pclmul"))
+        return crc32Pclmul;
+
+#elif defined __GNUC__ && defined __aarch64__
+#ifdef __ARM_FEATURE_CRC32 //e.g. macOS on Apple silicon
+    return crc32Armv8;
+#elif defined __linux__
+    if (::getauxval(AT_HWCAP) & HWCAP_CRC32)
+        return crc32Armv8;
+#endif
+#endif
+    return crc32Slice16;
+}
+}
+
+
+uint32_t zen::impl::updateCrc32(uint32_t crc, const unsigned char* buffer, size_t bytes)
+{
+    static const Crc32Function crc32Function = selectCrc32Function();
+    return crc32Function(crc, buffer, bytes);
+}
+
+//-------------------------------------------------------------------------------------------------
+
+namespace
+{
+constexpr uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87;
+constexpr uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4F;
+constexpr uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9;
+constexpr uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63;
+constexpr uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5;
+
+
+template <class T> inline
+T readLittleEndian(const unsigned char* buffer)
+{
+    T v = 0;
+    std::memcpy(&v, buffer, sizeof(v));
+    if constexpr (std::endian::native == std::endian::big)
+        v = std::byteswap(v);
+    return v;
+}
+
+
+inline uint64_t xxhRound(uint64_t acc, uint64_t input) { return std::rotl(acc + input * XXH_PRIME64_2, 31) * XXH_PRIME64_1; }
+
+inline uint64_t xxhMergeAccumulator(uint64_t hash, uint64_t acc) { return (hash ^ xxhRound(0, acc)) * XXH_PRIME64_1 + XXH_PRIME64_4; }
+}
+
+
+Xxh64Stream::Xxh64Stream(uint64_t seed) :
+    acc_{seed + XXH_PRIME64_1 + XXH_PRIME64_2, seed + XXH_PRIME64_2, seed, seed - XXH_PRIME64_1},
+    seed_(seed) {}
+
+
+void Xxh64Stream::update(const void* buffer, size_t bytes)
+{
+    auto it = static_cast<const unsigned char*>(buffer);
+    bytesTotal_ += bytes;
+
+    auto consumeStripe = [this](const unsigned char* stripe)
+    {
+        for (size_t i = 0; i < 4; ++i)
+            acc_[i] = xxhRound(acc_[i], readLittleEndian<uint64_t>(stripe + 8 * i));
+    };
+
+    if (stripeBytes_ > 0) //complete partial stripe first
+    {
+        const size_t bytesNew = std::min(bytes, sizeof(stripe_) - stripeBytes_);
+        std::memcpy(stripe_ + stripeBytes_, it, bytesNew);
+        stripeBytes_ += bytesNew;
+        it           += bytesNew;
+        bytes        -= bytesNew;
+
+        if (stripeBytes_ < sizeof(stripe_))
+            return;
+        consumeStripe(stripe_);
+        stripeBytes_ = 0;
+    }
+
+    for (; bytes >= sizeof(stripe_); it += sizeof(stripe_), bytes -= sizeof(stripe_))
+        consumeStripe(it);
+
+    std::memcpy(stripe_, it, bytes);
+    stripeBytes_ = bytes;
+}
+
+
+uint64_t Xxh64Stream::finalize() const
+{
+    uint64_t hash = 0;
+    if (bytesTotal_ >= sizeof(stripe_))
+    {
+        hash = std::rotl(acc_[0], 1) + std::rotl(acc_[1], 7) + std::rotl(acc_[2], 12) + std::rotl(acc_[3], 18);
+        for (const uint64_t acc : acc_)
+            hash = xxhMergeAccumulator(hash, acc);
+    }
+    else
+        hash = seed_ + XXH_PRIME64_5;
+
+    hash += bytesTotal_;
+
+    const unsigned char* it = stripe_;
+    size_t bytes = stripeBytes_;
+    for (; bytes >= 8; it += 8, bytes -= 8)
+        hash = std::rotl(hash ^ xxhRound(0, readLittleEndian<uint64_t>(it)), 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+
+    if (bytes >= 4)
+    {
+        hash = std::rotl(hash ^ (readLittleEndian<uint32_t>(it) * XXH_PRIME64_1), 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        it    += 4;
+        bytes -= 4;
+    }
+
+    for (; bytes > 0; ++it, --bytes)
+        hash = std::rotl(hash ^ (*it * XXH_PRIME64_5), 11) * XXH_PRIME64_1;
+
+    //avalanche
+    hash ^= hash >> 33;
+    hash *= XXH_PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= XXH_PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+
+uint64_t zen::getXxh64(const std::string_view& str, uint64_t seed)
+{
+    Xxh64Stream xxhStream(seed);
+    xxhStream.update(str.data(), str.size());
+    return xxhStream.finalize();
+}
@@ -8,9 +8,13 @@
 #include "thread.h"
 #include "scope_guard.h"
 #include "file_access.h"
+#include "file_io.h"
+#include "symlink_target.h"
 
     #include <map>
     #include <sys/inotify.h>
+    #include <sys/fanotify.h>
+    #include <sys/epoll.h>
     #include <fcntl.h> //fcntl
     #include <unistd.h> //close
     #include <limits.h> //NAME_MAX
@@ -20,10 +24,308 @@
 using namespace zen;
 
 
+namespace
+{
+//add directory and all its subdirectories
+std::vector<Zstring> getFolderTree(const Zstring& dirPath) //throw FileError
+{
+    std::vector<Zstring> folderList{dirPath};
+
+    auto traverse = [&folderList](this const auto& self, const Zstring& path) -> void //throw FileError
+    {
+        traverseFolder(path, nullptr,
+                       [&](const FolderInfo& fi)
+        {
+            folderList.push_back(fi.fullPath);
+            self(fi.fullPath); //throw FileError
+        },
+        nullptr /*don't traverse into symlinks (analog to Windows)*/); //throw FileError
+    };
+    traverse(dirPath); //throw FileError
+
+    return folderList;
+}
+
+
+//fanotify file system marks don't see into nested mounts => is any mount point located *below* the base directory?
+bool haveNestedMounts(const Zstring& dirPathReal) //throw FileError
+{
+    const std::string mountInfo = getFileContent("/proc/self/mountinfo", nullptr /*notifyUnbufferedIO*/); //throw FileError
+
+    //"36 35 98:0 /mnt1 /mnt/parent rw,noatime master:1 - ext3 /dev/root rw": 5th field is mount point; space, tab, newline, backslash are octal-escaped
+    const Zstring dirPathRealPf = appendSeparator(dirPathReal);
+
+    for (const std::string& line : splitCpy(mountInfo, '\n', SplitOnEmpty::skip))
+    {
+        const std::vector<std::string> fields = splitCpy(line, ' ', SplitOnEmpty::skip);
+        if (fields.size() < 5)
+            continue;
+
+        Zstring mountPath;
+        for (size_t i = 0; i < fields[4].size(); ++i)
+            if (fields[4][i] == '\\' && i + 3 < fields[4].size())
+            {
+                mountPath += static_cast<char>((fields[4][i + 1] - '0') * 64 + (fields[4][i + 2] - '0') * 8 + (fields[4][i + 3] - '0'));
+                i += 3;
+            }
+            else
+                mountPath += fields[4][i];
+
+        if (startsWith(mountPath, dirPathRealPf))
+            return true;
+    }
+    return false;
+}
+}
+
+
+constexpr uint32_t INOTIFY_MASK_SELF = IN_ONLYDIR     | //"Only watch pathname if it is a directory."
+                                      IN_DONT_FOLLOW | //don't follow symbolic links
+                                      IN_DELETE_SELF |
+                                      IN_MOVE_SELF;
+
+constexpr uint32_t INOTIFY_MASK_TREE = INOTIFY_MASK_SELF |
+                                      IN_CREATE      |
+                                      IN_MODIFY      |
+                                      IN_CLOSE_WRITE |
+                                      IN_DELETE      |
+                                      IN_MOVED_FROM  |
+                                      IN_MOVED_TO;
+
+
 struct DirWatcher::Impl
 {
+    //returns -1 if folder is gone (ENOENT, ENOTDIR), e.g. deleted right after creation
+    int addWatch(const Zstring& dirPath, uint32_t mask = INOTIFY_MASK_TREE) //throw FileError
+    {
+        const int wd = ::inotify_add_watch(notifDescr, dirPath.c_str(), mask);
+        if (wd == -1)
+        {
+            const ErrorCode ec = getLastError(); //copy before directly/indirectly making other system calls!
+            if (ec == ENOENT || ec == ENOTDIR)
+                return -1;
+
+            if (ec == ENOSPC) //fix misleading system message "No space left on device"
+                throw FileError(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(dirPath)),
+                                formatSystemError("inotify_add_watch", L"ENOSPC",
+                                                  L"The user limit on the total number of inotify watches was reached or the kernel failed to allocate a needed resource."));
+
+            throw FileError(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(dirPath)), formatSystemError("inotify_add_watch", ec));
+        }
+
+        watchedPaths[wd] = dirPath; //wd is the same if inode is already watched (e.g. directory reported twice)
+        return wd;
+    }
+
+    //new directory created or moved into watched hierarchy: watch including subdirectories that may exist already
+    void addWatchTree(const Zstring& dirPath) //throw FileError
+    {
+        std::vector<Zstring> folderList;
+        try
+        {
+            folderList = getFolderTree(dirPath); //throw FileError
+        }
+        catch (FileError&) //folder already gone? => nothing to watch
+        {
+            try { getItemType(dirPath); /*throw FileError*/ }
+            catch (FileError&) { return; }
+            throw;
+        }
+
+        for (const Zstring& subDirPath : folderList)
+            addWatch(subDirPath); //throw FileError
+    }
+
+    //directory moved out of its location: inotify would keep watching the inode under its new (possibly unwatched) location
+    void removeWatchTree(const Zstring& dirPath)
+    {
+        const Zstring dirPathPf = appendSeparator(dirPath);
+
+        std::erase_if(watchedPaths, [&](const auto& item)
+        {
+            const auto& [wd, watchedPath] = item;
+            if (watchedPath == dirPath || startsWith(watchedPath, dirPathPf))
+            {
+                [[maybe_unused]] const int rv = ::inotify_rm_watch(notifDescr, wd); //=> still sends IN_IGNORED for wd
+                return true;
+            }
+            return false;
+        });
+    }
+
+    //events were lost: subdirectories created meanwhile are unwatched, paths of moved ones outdated => start over
+    void rebuildWatchTree(const Zstring& baseDirPath) //throw FileError
+    {
+        std::erase_if(watchedPaths, [&](const auto& item)
+        {
+            const auto& [wd, watchedPath] = item;
+            if (wd == baseDirWd)
+                return false;
+
+            [[maybe_unused]] const int rv = ::inotify_rm_watch(notifDescr, wd); //=> still sends IN_IGNORED for wd; re-added inodes get a new wd
+            return true;
+        });
+        addWatchTree(baseDirPath); //throw FileError
+    }
+
+    /*  fanotify: a single mark for the whole file system: no per-directory setup, no "max_user_watches" limit
+        - requires CAP_SYS_ADMIN (+ CAP_DAC_READ_SEARCH for open_by_handle_at()) and Linux 5.9 (FAN_REPORT_DFID_NAME)
+        - events are reported for the whole file system: the kernel has no subtree filter for file system marks
+            => drop events outside the base directory by parent directory handle, before any path resolution, see fanotifyDirPaths
+        - doesn't report unmount => inotify is still used to watch the base directory itself
+        - doesn't see into other file systems mounted inside the base directory => use inotify for such trees
+            (file systems mounted later are missed: same as for inotify watches set up before the mount)          */
+    bool initFanotify(const Zstring& baseDirPath) //throw FileError
+    {
+        const Zstring dirPathReal = getSymlinkResolvedPath(baseDirPath); //throw FileError; fanotify reports canonical paths
+        if (haveNestedMounts(dirPathReal)) //throw FileError
+            return false;
+
+        const int fd = ::fanotify_init(FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_NONBLOCK | FAN_REPORT_DFID_NAME, O_RDONLY | O_CLOEXEC);
+        if (fd == -1) //EPERM: missing CAP_SYS_ADMIN, EINVAL: kernel too old
+            return false;
+        bool success = false;
+        ZEN_ON_SCOPE_EXIT(if (!success) ::close(fd));
+
+        if (::fanotify_mark(fd, FAN_MARK_ADD | FAN_MARK_FILESYSTEM,
+                            FAN_CREATE      |
+                            FAN_MODIFY      |
+                            FAN_CLOSE_WRITE |
+                            FAN_DELETE      |
+                            FAN_MOVED_FROM  |
+                            FAN_MOVED_TO    |
+                            FAN_ONDIR, //report directories, too
+                            AT_FDCWD, baseDirPath.c_str()) != 0)
+            return false; //e.g. ENODEV, EXDEV, EOPNOTSUPP: file system doesn't support file handles
+
+        const int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epfd == -1)
+            return false;
+        ZEN_ON_SCOPE_EXIT(if (!success) ::close(epfd));
+
+        for (const int waitFd : {notifDescr, fd})
+        {
+            epoll_event evt{.events = EPOLLIN, .data{.fd = waitFd}};
+            if (::epoll_ctl(epfd, EPOLL_CTL_ADD, waitFd, &evt) != 0)
+                return false;
+        }
+
+        baseDirPathReal = dirPathReal;
+        fanotifyDescr = fd;
+        epollDescr    = epfd;
+        success = true;
+        return true;
+    }
+
+    void fetchFanotifyChanges(const Zstring& baseDirPath, std::vector<Change>& output) //throw FileError
+    {
+        //need *some* file descriptor on the file system for open_by_handle_at(): don't hold it permanently, or the volume can't be unmounted!
+        const int mountFd = ::open(baseDirPath.c_str(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+        if (mountFd == -1)
+            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(baseDirPath)), "open");
+        ZEN_ON_SCOPE_EXIT(::close(mountFd));
+
+        const Zstring baseDirPathRealPf = appendSeparator(baseDirPathReal);
+
+        std::vector<std::byte> buf(64 * 1024);
+        for (;;)
+        {
+            ssize_t bytesRead = 0;
+            do
+                bytesRead = ::read(fanotifyDescr, buf.data(), buf.size());
+            while (bytesRead < 0 && errno == EINTR);
+
+            if (bytesRead < 0)
+            {
+                if (errno == EAGAIN)
+                    return;
+                THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(baseDirPath)), "read(fanotify)");
+            }
+
+            for (auto meta = reinterpret_cast<const fanotify_event_metadata*>(buf.data());
+                 FAN_EVENT_OK(meta, bytesRead);
+                 meta = FAN_EVENT_NEXT(meta, bytesRead))
+            {
+                if (meta->vers != FANOTIFY_METADATA_VERSION)
+                    throw FileError(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(baseDirPath)),
+                                    formatSystemError("read(fanotify)", L"", L"Unexpected metadata version: " + numberTo<std::wstring>(meta->vers)));
+
+                if (meta->mask & FAN_Q_OVERFLOW) //events were lost => report *something*, so that caller doesn't miss a change
+                {
+                    fanotifyDirPaths.clear(); //lost events may include directory renames
+                    output.push_back({ChangeType::update, baseDirPath});
+                    continue;
+                }
+
+                const auto fid = reinterpret_cast<const fanotify_event_info_fid*>(meta + 1);
+                if (meta->event_len < meta->metadata_len + sizeof(fanotify_event_info_fid) ||
+                    fid->hdr.info_type != FAN_EVENT_INFO_TYPE_DFID_NAME)
+                    continue;
+
+                //FAN_REPORT_DFID_NAME: file handle of parent directory followed by item name
+                auto dirHandle = reinterpret_cast<file_handle*>(const_cast<unsigned char*>(fid->handle));
+                const char* itemName = reinterpret_cast<const char*>(dirHandle->f_handle + dirHandle->handle_bytes);
+
+                //directory renamed or deleted: cached paths of it and its sub directories are outdated
+                ZEN_ON_SCOPE_EXIT(if ((meta->mask & FAN_ONDIR) && (meta->mask & (FAN_DELETE | FAN_MOVED_FROM | FAN_MOVED_TO))) fanotifyDirPaths.clear());
+
+                const std::string dirHandleKey(reinterpret_cast<const char*>(dirHandle), sizeof(file_handle) + dirHandle->handle_bytes);
+
+                auto itDir = fanotifyDirPaths.find(dirHandleKey);
+                if (itDir == fanotifyDirPaths.end())
+                {
+                    const int dirFd = ::open_by_handle_at(mountFd, dirHandle, O_PATH | O_CLOEXEC);
+                    if (dirFd == -1)
+                    {
+                        if (errno == ESTALE) //parent directory is already gone: deletion is reported for its parent, too
+                            continue;
+                        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(baseDirPath)), "open_by_handle_at");
+                    }
+                    ZEN_ON_SCOPE_EXIT(::close(dirFd));
+
+                    Zstring parentPathReal;
+                    try
+                    {
+                        parentPathReal = getSymlinkRawContent_impl(Zstr("/proc/self/fd/") + numberTo<Zstring>(dirFd)).targetPath; //throw SysError
+                    }
+                    catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(baseDirPath)), e.toString()); }
+
+                    //filter to base directory and map back to the user-specified path
+                    std::optional<Zstring> parentPath; //empty if outside base directory
+                    if (parentPathReal == baseDirPathReal)
+                        parentPath = baseDirPath;
+                    else if (startsWith(parentPathReal, baseDirPathRealPf))
+                        parentPath = appendPath(baseDirPath, parentPathReal.c_str() + baseDirPathRealPf.size());
+
+                    if (fanotifyDirPaths.size() >= FANOTIFY_DIR_CACHE_MAX)
+                        fanotifyDirPaths.clear();
+                    itDir = fanotifyDirPaths.emplace(dirHandleKey, std::move(parentPath)).first;
+                }
+
+                if (!itDir->second) //outside base directory (including its parent: removal and renaming of base directory is reported by inotify)
+                    continue;
+
+                const Zstring itemPath = strcmp(itemName, ".") == 0 ? *itDir->second : appendPath(*itDir->second, itemName);
+
+                if (meta->mask & (FAN_CREATE | FAN_MOVED_TO))
+                    output.push_back({ChangeType::create, itemPath});
+                else if (meta->mask & (FAN_MODIFY | FAN_CLOSE_WRITE))
+                    output.push_back({ChangeType::update, itemPath});
+                else if (meta->mask & (FAN_DELETE | FAN_MOVED_FROM))
+                    output.push_back({ChangeType::remove, itemPath});
+            }
+        }
+    }
+
     int notifDescr = 0;
+    int baseDirWd = -1;
     std::unordered_map<int, Zstring> watchedPaths; //watch descriptor and (sub-)directory paths -> owned by "notifDescr"
+
+    int fanotifyDescr = -1; //fanotify available: inotify watches base directory only
+    int epollDescr    = -1; //wait handle for both inotify and fanotify
+    Zstring baseDirPathReal;
+    std::unordered_map<std::string /*file_handle*/, std::optional<Zstring> /*empty if outside base directory*/> fanotifyDirPaths;
+    static constexpr size_t FANOTIFY_DIR_CACHE_MAX = 10'000;
 };
 
 
@@ -31,23 +333,6 @@ DirWatcher::DirWatcher(const Zstring& dirPath) : //throw FileError
     baseDirPath_(dirPath),
     pimpl_(std::make_unique<Impl>())
 {
-    //get all subdirectories
-    std::vector<Zstring> fullFolderList {baseDirPath_};
-    {
-        auto traverse = [&fullFolderList](this const auto& self, const Zstring& path) -> void //throw FileError
-        {
-            traverseFolder(path, nullptr,
-                           [&](const FolderInfo& fi )
-            {
-                fullFolderList.push_back(fi.fullPath);
-                self(fi.fullPath); //throw FileError
-            },
-            nullptr /*don't traverse into symlinks (analog to Windows)*/); //throw FileError
-        };
-
-        traverse(baseDirPath_); //throw FileError
-    }
-
     //init
     pimpl_->notifDescr  = ::inotify_init();
     if (pimpl_->notifDescr == -1)
@@ -63,32 +348,33 @@ DirWatcher::DirWatcher(const Zstring& dirPath) : //throw FileError
     if (::fcntl(pimpl_->notifDescr, F_SETFL, flags | O_NONBLOCK) != 0)
         THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(baseDirPath_)), "fcntl(F_SETFL, O_NONBLOCK)");
 
+    if (pimpl_->initFanotify(baseDirPath_)) //throw FileError
+    {
+        ZEN_ON_SCOPE_FAIL( ::close(pimpl_->fanotifyDescr); ::close(pimpl_->epollDescr); );
+
+        //still needed to detect removal, renaming and unmounting of base directory
+        pimpl_->baseDirWd = pimpl_->addWatch(baseDirPath_, INOTIFY_MASK_SELF); //throw FileError
+        if (pimpl_->baseDirWd == -1)
+            throw FileError(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(baseDirPath_)), formatSystemError("inotify_add_watch", ENOENT));
+        return;
+    }
+
+    //get all subdirectories
+    const std::vector<Zstring> fullFolderList = getFolderTree(baseDirPath_); //throw FileError
+
     //add watches
     for (const Zstring& subDirPath : fullFolderList)
     {
-        int wd = ::inotify_add_watch(pimpl_->notifDescr, subDirPath.c_str(),
-                                     IN_ONLYDIR     | //"Only watch pathname if it is a directory."
-                                     IN_DONT_FOLLOW | //don't follow symbolic links
-                                     IN_CREATE      |
-                                     IN_MODIFY      |
-                                     IN_CLOSE_WRITE |
-                                     IN_DELETE      |
-                                     IN_DELETE_SELF |
-                                     IN_MOVED_FROM  |
-                                     IN_MOVED_TO    |
-                                     IN_MOVE_SELF);
-        if (wd == -1)
+        const int wd = pimpl_->addWatch(subDirPath); //throw FileError
+        if (wd == -1) //folder removed during traversal
         {
-            const ErrorCode ec = getLastError(); //copy before directly/indirectly making other system calls!
-            if (ec == ENOSPC) //fix misleading system message "No space left on device"
-                throw FileError(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(subDirPath)),
-                                formatSystemError("inotify_add_watch", L"ENOSPC",
-                                                  L"The user limit on the total number of inotify watches was reached or the kernel failed to allocate a needed resource."));
-
-            throw FileError(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(subDirPath)), formatSystemError("inotify_add_watch", ec));
+            if (subDirPath == baseDirPath_)
+                throw FileError(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(baseDirPath_)), formatSystemError("inotify_add_watch", ENOENT));
+            continue;
         }
 
-        pimpl_->watchedPaths.emplace(wd, subDirPath);
+        if (subDirPath == baseDirPath_)
+            pimpl_->baseDirWd = wd;
     }
 }
 
@@ -96,61 +382,93 @@ DirWatcher::DirWatcher(const Zstring& dirPath) : //throw FileError
 DirWatcher::~DirWatcher()
 {
     ::close(pimpl_->notifDescr); //associated watches are removed automatically!
+
+    if (pimpl_->fanotifyDescr != -1)
+    {
+        ::close(pimpl_->fanotifyDescr);
+        ::close(pimpl_->epollDescr);
+    }
 }
 
 
+int DirWatcher::getWaitHandle() const { return pimpl_->fanotifyDescr != -1 ? pimpl_->epollDescr : pimpl_->notifDescr; }
+
+
 std::vector<DirWatcher::Change> DirWatcher::fetchChanges(const std::function<void()>& requestUiUpdate, std::chrono::milliseconds cbInterval) //throw FileError
 {
     std::vector<std::byte> buf(512 * (sizeof(inotify_event) + NAME_MAX + 1));
+    std::vector<Change> output;
 
-    ssize_t bytesRead = 0;
-    do
-    {
-        //non-blocking call, see O_NONBLOCK
-        bytesRead = ::read(pimpl_->notifDescr, buf.data(), buf.size());
-    }
-    while (bytesRead < 0 && errno == EINTR); //"Interrupted function call; When this happens, you should try the call again."
+    if (pimpl_->fanotifyDescr != -1)
+        pimpl_->fetchFanotifyChanges(baseDirPath_, output); //throw FileError
 
-    if (bytesRead < 0)
+    for (;;) //drain all pending events: there might be more than fit into buf
     {
-        if (errno == EAGAIN)  //this error is ignored in all inotify wrappers I found
-            return std::vector<Change>();
-
-        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(baseDirPath_)), "read");
-    }
+        ssize_t bytesRead = 0;
+        do
+        {
+            //non-blocking call, see O_NONBLOCK
+            bytesRead = ::read(pimpl_->notifDescr, buf.data(), buf.size());
+        }
+        while (bytesRead < 0 && errno == EINTR); //"Interrupted function call; When this happens, you should try the call again."
 
-    std::vector<Change> output;
+        if (bytesRead < 0)
+        {
+            if (errno == EAGAIN)  //this error is ignored in all inotify wrappers I found
+                return output;
 
-    ssize_t bytePos = 0;
-    while (bytePos < bytesRead)
-    {
-        inotify_event& evt = reinterpret_cast<inotify_event&>(buf[bytePos]);
+            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(baseDirPath_)), "read");
+        }
 
-        if (evt.len != 0) //exclude case: deletion of "self", already reported by parent directory watch
+        ssize_t bytePos = 0;
+        while (bytePos < bytesRead)
         {
-            auto it = pimpl_->watchedPaths.find(evt.wd);
-            if (it != pimpl_->watchedPaths.end())
+            inotify_event& evt = reinterpret_cast<inotify_event&>(buf[bytePos]);
+
+            if (evt.mask & IN_Q_OVERFLOW) //evt.wd == -1: events were lost => report *something*, so that caller doesn't miss a change
             {
-                //Note: evt.len is NOT the size of the evt.name c-string, but the array size including all padding 0 characters!
-                //It may be even 0 in which case evt.name must not be used!
-                const Zstring itemPath = appendPath(it->second, evt.name);
+                if (pimpl_->fanotifyDescr == -1) //fanotify: inotify watches base directory only
+                    pimpl_->rebuildWatchTree(baseDirPath_); //throw FileError
+                output.push_back({ChangeType::update, baseDirPath_});
+            }
+            else if (evt.wd == pimpl_->baseDirWd &&
+                     (evt.mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT | IN_IGNORED))) //IN_UNMOUNT, IN_IGNORED: set even if not requested
+                output.push_back({ChangeType::baseFolderUnavailable, baseDirPath_});
+            else if (evt.mask & IN_IGNORED) //watch removed: directory deleted, file system unmounted, or inotify_rm_watch()
+                pimpl_->watchedPaths.erase(evt.wd);
+            else if (evt.len != 0) //exclude case: deletion of "self", already reported by parent directory watch
+            {
+                auto it = pimpl_->watchedPaths.find(evt.wd);
+                if (it != pimpl_->watchedPaths.end())
+                {
+                    //Note: evt.len is NOT the size of the evt.name c-string, but the array size including all padding 0 characters!
+                    //It may be even 0 in which case evt.name must not be used!
+                    const Zstring itemPath = appendPath(it->second, evt.name);
 
-                if ((evt.mask & IN_CREATE) ||
-                    (evt.mask & IN_MOVED_TO))
-                    output.push_back({ChangeType::create, itemPath});
-                else if ((evt.mask & IN_MODIFY) ||
-                         (evt.mask & IN_CLOSE_WRITE))
-                    output.push_back({ChangeType::update, itemPath});
-                else if ((evt.mask & IN_DELETE     ) ||
-                         (evt.mask & IN_DELETE_SELF) ||
-                         (evt.mask & IN_MOVE_SELF  ) ||
-                         (evt.mask & IN_MOVED_FROM))
-                    output.push_back({ChangeType::remove, itemPath});
+                    if ((evt.mask & IN_CREATE) ||
+                        (evt.mask & IN_MOVED_TO))
+                    {
+                        if (evt.mask & IN_ISDIR) //watch new subdirectories right away instead of resetting DirWatcher
+                            pimpl_->addWatchTree(itemPath); //throw FileError
+
+                        output.push_back({ChangeType::create, itemPath});
+                    }
+                    else if ((evt.mask & IN_MODIFY) ||
+                             (evt.mask & IN_CLOSE_WRITE))
+                        output.push_back({ChangeType::update, itemPath});
+                    else if ((evt.mask & IN_DELETE     ) ||
+                             (evt.mask & IN_DELETE_SELF) ||
+                             (evt.mask & IN_MOVE_SELF  ) ||
+                             (evt.mask & IN_MOVED_FROM))
+                    {
+                        if ((evt.mask & IN_MOVED_FROM) && (evt.mask & IN_ISDIR))
+                            pimpl_->removeWatchTree(itemPath); //if moved within hierarchy, it will be re-added by IN_MOVED_TO
+
+                        output.push_back({ChangeType::remove, itemPath});
+                    }
+                }
             }
+            bytePos += sizeof(inotify_event) + evt.len;
         }
-        bytePos += sizeof(inotify_event) + evt.len;
     }
-
-    return output;
 }
-
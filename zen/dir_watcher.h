@@ -17,6 +17,7 @@ namespace zen
 {
 //Windows: ReadDirectoryChangesW https://docs.microsoft.com/en-us/windows/win32/api/winbase/nf-winbase-readdirectorychangesw
 //Linux:   inotify               https://linux.die.net/man/7/inotify
+//         fanotify              https://man7.org/linux/man-pages/man7/fanotify.7.html (if permitted: whole file system with a single mark)
 //macOS:   kqueue                https://developer.apple.com/library/mac/documentation/Darwin/Reference/ManPages/man2/kqueue.2.html
 
 //watch directory including subdirectories
@@ -28,12 +29,13 @@ namespace zen
              Renaming of top watched directory handled incorrectly: Not notified(!) + additional changes in subfolders
              now do report FILE_ACTION_MODIFIED for directory (check that should prevent this fails!)
 
-    Linux: newly added subdirectories are reported but not automatically added for watching! -> reset Dirwatcher!
-           removal of base directory is NOT notified!
+    Linux: newly added subdirectories are reported and added for watching by fetchChanges(); watches of deleted/moved-away subdirectories are dropped
+           removal, renaming and unmounting of base directory is reported as ChangeType::baseFolderUnavailable (IN_DELETE_SELF, IN_MOVE_SELF, IN_UNMOUNT)
+           but NOT for network shares going offline!
 
     macOS: everything works as expected; renaming of base directory is also detected
 
-    Overcome all issues portably: check existence of top watched directory externally + reinstall watch after changes in directory structure (added directories) are detected
+    Overcome all issues portably: check existence of top watched directory externally if the platform doesn't report it
 */
 class DirWatcher
 {
@@ -58,6 +60,9 @@ public:
     //extract accumulated changes since last call
     std::vector<Change> fetchChanges(const std::function<void()>& requestUiUpdate, std::chrono::milliseconds cbInterval); //throw FileError
 
+    //Linux: inotify file descriptor: becomes readable when fetchChanges() has something to report => wait via poll()/epoll() instead of sleep-polling
+    int getWaitHandle() const;
+
 private:
     DirWatcher           (const DirWatcher&) = delete;
     DirWatcher& operator=(const DirWatcher&) = delete;
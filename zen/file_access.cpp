@@ -670,7 +670,8 @@ void zen::copySymlink(const Zstring& sourcePath, const Zstring& targetPath) //th
 
 
 FileCopyResult zen::copyNewFile(const Zstring& sourceFile, const Zstring& targetFile, //throw FileError, ErrorTargetExisting, (ErrorFileLocked), X
-                                const IoCallback& notifyUnbufferedIO /*throw X*/)
+                                const IoCallback& notifyUnbufferedIO /*throw X*/,
+                                const IoDataCallback& notifySourceData /*throw X*/)
 {
     int64_t totalBytesNotified = 0;
     IOCallbackDivider notifyIoDiv(notifyUnbufferedIO, totalBytesNotified);
@@ -713,6 +714,7 @@ FileCopyResult zen::copyNewFile(const Zstring& sourceFile, const Zstring& target
     unbufferedStreamCopy([&](void* buffer, size_t bytesToRead)
     {
         const size_t bytesRead = fileIn.tryRead(buffer, bytesToRead); //throw FileError, (ErrorFileLocked)
+        if (notifySourceData) notifySourceData(buffer, bytesRead); //throw X
         notifyIoDiv(bytesRead); //throw X
         return bytesRead;
     },
@@ -9,7 +9,7 @@
 
 #include "file_path.h" //we'll need this later anyway!
 #include "file_error.h"
-#include "serialize.h" //IoCallback
+#include "serialize.h" //IoCallback, IoDataCallback
     #include <sys/stat.h>
 
 namespace zen
@@ -93,7 +93,8 @@ struct FileCopyResult
 
 FileCopyResult copyNewFile(const Zstring& sourceFile, const Zstring& targetFile, //throw FileError, ErrorTargetExisting, ErrorFileLocked, X
                            //accummulated delta != file size! consider ADS, sparse, compressed files
-                           const IoCallback& notifyUnbufferedIO /*throw X*/);
+                           const IoCallback& notifyUnbufferedIO /*throw X*/,
+                           const IoDataCallback& notifySourceData /*throw X*/); //optional: source file content as it is copied
 }
 
 #endif //FILE_ACCESS_H_8017341345614857
@@ -175,6 +175,29 @@ size_t FileInputPlain::tryRead(void* buffer, size_t bytesToRead) //throw FileErr
     catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(getFilePath())), e.toString()); }
 }
 
+
+size_t FileInputPlain::tryReadAt(void* buffer, size_t bytesToRead, uint64_t offset) //throw FileError
+{
+    if (bytesToRead == 0) //"pread() with a count of 0 returns zero" => indistinguishable from end of file! => check!
+        throw std::logic_error(std::string(__FILE__) + '[' + numberTo<std::string>(__LINE__) + "] Contract violation!");
+    try
+    {
+        ssize_t bytesRead = 0;
+        do
+        {
+            bytesRead = ::pread(getHandle(), buffer, bytesToRead, static_cast<off_t>(offset));
+        }
+        while (bytesRead < 0 && errno == EINTR);
+
+        if (bytesRead < 0)
+            THROW_LAST_SYS_ERROR("pread");
+
+        ASSERT_SYSERROR(makeUnsigned(bytesRead) <= bytesToRead); //better safe than sorry
+        return bytesRead; //"zero indicates end of file"
+    }
+    catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(getFilePath())), e.toString()); }
+}
+
 //----------------------------------------------------------------------------------------------------
 
 namespace
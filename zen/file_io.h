@@ -67,6 +67,10 @@ public:
     //may return short, only 0 means EOF! CONTRACT: bytesToRead > 0!
     size_t tryRead(void* buffer, size_t bytesToRead); //throw FileError, ErrorFileLocked
 
+    //random access: does not change file position used by tryRead()
+    //may return short, only 0 means EOF! CONTRACT: bytesToRead > 0!
+    size_t tryReadAt(void* buffer, size_t bytesToRead, uint64_t offset); //throw FileError
+
 private:
     FileInputPlain(const std::pair<FileBase::FileHandle, struct stat>& fileDetails, const Zstring& filePath);
 };
@@ -8,6 +8,8 @@
 #define JSON_H_0187348321748321758934215734
 
 #include <list>
+#include <span>
+#include <functional>
 #include <zen/string_tools.h>
 
 
@@ -96,6 +98,9 @@ struct JsonParsingError
 };
 JsonValue parseJson(const std::string& stream); //throw JsonParsingError
 
+//incremental parsing of streams as they arrive (e.g. HTTP response body) => see JsonStreamParser below
+class JsonStreamParser;
+
 
 
 //---------------------- implementation ----------------------
@@ -365,6 +370,9 @@ std::string serializeJson(const JsonValue& jval,
 
 namespace json_impl
 {
+inline bool isJsonWhiteSpace(const char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+inline bool isJsonNumDigit  (const char c) { return ('0' <= c && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e'|| c == 'E'; }
+
 enum class TokenType
 {
     eof,
@@ -480,9 +488,6 @@ private:
     Scanner           (const Scanner&) = delete;
     Scanner& operator=(const Scanner&) = delete;
 
-    static bool isJsonWhiteSpace(const char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
-    static bool isJsonNumDigit  (const char c) { return ('0' <= c && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e'|| c == 'E'; }
-
     bool startsWith(const std::string& prefix) const
     {
         return zen::startsWith(std::string_view(pos_, stream_.end()), prefix);
@@ -614,6 +619,279 @@ JsonValue parseJson(const std::string& stream) //throw JsonParsingError
 {
     return json_impl::JsonParser(stream).parse(); //throw JsonParsingError
 }
+
+
+/* Pull the elements of a huge array out of the stream one by one: e.g. {"nextPageToken": "...", "files": [{...}, {...}, ...]}
+    - elements of "streamArrayName" (member of the top-level object) are passed to onArrayItem() as soon as they're complete, then discarded
+    - everything else is collected as usual and returned by finish(); the streamed array is left empty
+   => peak memory: size of a single element, not of the whole document                                                 */
+class JsonStreamParser
+{
+public:
+    JsonStreamParser(const std::string& streamArrayName, const std::function<void(JsonValue&& item)>& onArrayItem /*throw X*/) :
+        streamArrayName_(streamArrayName), onArrayItem_(onArrayItem) {}
+
+    void feed(std::span<const char> buf) //throw JsonParsingError, X
+    {
+        buf_.append(buf.data(), buf.size());
+        processBuffer(false /*endOfStream*/); //throw JsonParsingError, X
+    }
+
+    JsonValue finish() //throw JsonParsingError, X
+    {
+        processBuffer(true /*endOfStream*/); //throw JsonParsingError, X
+
+        if (expect_ != Expect::eof)
+            throw JsonParsingError(row_, col_);
+        return std::move(root_);
+    }
+
+private:
+    JsonStreamParser           (const JsonStreamParser&) = delete;
+    JsonStreamParser& operator=(const JsonStreamParser&) = delete;
+
+    using TokenType = json_impl::TokenType;
+
+    enum class Expect
+    {
+        value,
+        valueOrClose, //after '['
+        key,
+        keyOrClose,   //after '{'
+        colon,
+        commaOrClose,
+        eof,
+    };
+
+    struct Container
+    {
+        JsonValue jval;
+        std::string key; //object member currently parsed
+        bool isStreamArray = false;
+    };
+
+    //consume all *complete* tokens; keep trailing partial token (e.g. string split between two chunks) for next call
+    void processBuffer(bool endOfStream) //throw JsonParsingError, X
+    {
+        auto it = buf_.cbegin();
+
+        if (!bomChecked_)
+        {
+            if (!endOfStream && buf_.size() < BYTE_ORDER_MARK_UTF8.size() && zen::startsWith(BYTE_ORDER_MARK_UTF8, buf_))
+                return; //need more data
+            bomChecked_ = true;
+            if (zen::startsWith(buf_, BYTE_ORDER_MARK_UTF8))
+                it += BYTE_ORDER_MARK_UTF8.size();
+        }
+
+        auto consume = [&](std::string::const_iterator itEnd)
+        {
+            for (; it != itEnd; ++it)
+                if (*it == '\n')
+                    ++row_, col_ = 0;
+                else
+                    ++col_;
+        };
+
+        for (;;)
+        {
+            consume(std::find_if_not(it, buf_.cend(), json_impl::isJsonWhiteSpace));
+            if (it == buf_.cend())
+                break;
+
+            const std::string_view rest(it, buf_.cend());
+
+            if (rest[0] == '{') { processToken(TokenType::curlyOpen,   {}); consume(it + 1); continue; }
+            if (rest[0] == '}') { processToken(TokenType::curlyClose,  {}); consume(it + 1); continue; }
+            if (rest[0] == '[') { processToken(TokenType::squareOpen,  {}); consume(it + 1); continue; }
+            if (rest[0] == ']') { processToken(TokenType::squareClose, {}); consume(it + 1); continue; }
+            if (rest[0] == ':') { processToken(TokenType::colon,       {}); consume(it + 1); continue; }
+            if (rest[0] == ',') { processToken(TokenType::comma,       {}); consume(it + 1); continue; }
+
+            if (rest[0] == '"')
+            {
+                auto itEnd = rest.begin() + 1;
+                for (; itEnd != rest.end(); ++itEnd)
+                    if (*itEnd == '"')
+                        break;
+                    else if (*itEnd == '\\') //skip next char
+                        if (++itEnd == rest.end())
+                            break;
+
+                if (itEnd == rest.end()) //incomplete string
+                {
+                    if (endOfStream)
+                        throw JsonParsingError(row_, col_);
+                    break;
+                }
+                processToken(TokenType::string, json_impl::jsonUnescape(std::string(rest.begin() + 1, itEnd))); //throw JsonParsingError, X
+                consume(it + (itEnd - rest.begin()) + 1);
+                continue;
+            }
+
+            bool needMoreData = false;
+            auto tryLiteral = [&](const std::string_view literal, TokenType type)
+            {
+                if (zen::startsWith(rest, literal))
+                {
+                    processToken(type, std::string(literal)); //throw JsonParsingError, X
+                    consume(it + literal.size());
+                    return true;
+                }
+                if (!endOfStream && rest.size() < literal.size() && zen::startsWith(literal, rest))
+                    needMoreData = true;
+                return false;
+            };
+            if (tryLiteral("null",  TokenType::null   ) ||
+                tryLiteral("true",  TokenType::boolean) ||
+                tryLiteral("false", TokenType::boolean))
+                continue;
+            if (needMoreData)
+                break;
+
+            //expect a number:
+            const auto itNumEnd = std::find_if_not(rest.begin(), rest.end(), json_impl::isJsonNumDigit);
+            if (itNumEnd == rest.begin())
+                throw JsonParsingError(row_, col_);
+            if (itNumEnd == rest.end() && !endOfStream) //number might continue in next chunk
+                break;
+
+            processToken(TokenType::number, std::string(rest.begin(), itNumEnd)); //throw JsonParsingError, X
+            consume(it + (itNumEnd - rest.begin()));
+        }
+
+        if (endOfStream && it != buf_.cend())
+            throw JsonParsingError(row_, col_);
+
+        buf_.erase(buf_.cbegin(), it);
+    }
+
+    void processToken(TokenType type, std::string&& primVal) //throw JsonParsingError, X
+    {
+        switch (expect_)
+        {
+            case Expect::valueOrClose:
+                if (type == TokenType::squareClose)
+                    return closeContainer(); //throw X
+                [[fallthrough]];
+            case Expect::value:
+                switch (type)
+                {
+                    case TokenType::curlyOpen:
+                        stack_.push_back({JsonValue(JsonValue::Type::object), {}, false});
+                        expect_ = Expect::keyOrClose;
+                        return;
+
+                    case TokenType::squareOpen:
+                    {
+                        const bool isStreamArray = stack_.size() == 1 &&
+                                                   stack_[0].jval.type == JsonValue::Type::object &&
+                                                   stack_[0].key == streamArrayName_;
+                        stack_.push_back({JsonValue(JsonValue::Type::array), {}, isStreamArray});
+                        expect_ = Expect::valueOrClose;
+                        return;
+                    }
+                    case TokenType::string:
+                        return onValue(JsonValue(std::move(primVal))); //throw X
+
+                    case TokenType::number:
+                    case TokenType::boolean:
+                    {
+                        JsonValue jval(type == TokenType::number ? JsonValue::Type::number : JsonValue::Type::boolean);
+                        jval.primVal = std::move(primVal);
+                        return onValue(std::move(jval)); //throw X
+                    }
+                    case TokenType::null:
+                        return onValue(JsonValue()); //throw X
+
+                    case TokenType::eof:
+                    case TokenType::curlyClose:
+                    case TokenType::squareClose:
+                    case TokenType::colon:
+                    case TokenType::comma:
+                        break;
+                }
+                break;
+
+            case Expect::keyOrClose:
+                if (type == TokenType::curlyClose)
+                    return closeContainer(); //throw X
+                [[fallthrough]];
+            case Expect::key:
+                if (type == TokenType::string)
+                {
+                    stack_.back().key = std::move(primVal);
+                    expect_ = Expect::colon;
+                    return;
+                }
+                break;
+
+            case Expect::colon:
+                if (type == TokenType::colon)
+                {
+                    expect_ = Expect::value;
+                    return;
+                }
+                break;
+
+            case Expect::commaOrClose:
+            {
+                const bool isObject = stack_.back().jval.type == JsonValue::Type::object;
+                if (type == TokenType::comma)
+                {
+                    expect_ = isObject ? Expect::key : Expect::value;
+                    return;
+                }
+                if (type == (isObject ? TokenType::curlyClose : TokenType::squareClose))
+                    return closeContainer(); //throw X
+                break;
+            }
+
+            case Expect::eof:
+                break;
+        }
+        throw JsonParsingError(row_, col_); //unexpected token
+    }
+
+    void closeContainer() //throw X
+    {
+        JsonValue jval = std::move(stack_.back().jval);
+        stack_.pop_back();
+        onValue(std::move(jval)); //throw X
+    }
+
+    void onValue(JsonValue&& jval) //throw X
+    {
+        if (stack_.empty())
+        {
+            root_ = std::move(jval);
+            expect_ = Expect::eof;
+            return;
+        }
+
+        Container& parent = stack_.back();
+        if (parent.jval.type == JsonValue::Type::object)
+            parent.jval.objectVal.set(std::move(parent.key), std::move(jval));
+        else if (parent.isStreamArray)
+            onArrayItem_(std::move(jval)); //throw X
+        else
+            parent.jval.arrayVal.push_back(std::move(jval));
+
+        expect_ = Expect::commaOrClose;
+    }
+
+    const std::string streamArrayName_;
+    const std::function<void(JsonValue&& item)> onArrayItem_; //throw X
+
+    std::string buf_; //not yet processed (partial token)
+    bool bomChecked_ = false;
+    size_t row_ = 0; //position of buf_ begin: beginning with 0
+    size_t col_ = 0; //
+
+    Expect expect_ = Expect::value;
+    std::vector<Container> stack_;
+    JsonValue root_;
+};
 }
 
 #endif //JSON_H_0187348321748321758934215734
@@ -370,6 +370,51 @@ void zen::verifySignature(const std::string_view message, const std::string_view
 }
 
 
+Md5Stream::Md5Stream() : mdctx_(::EVP_MD_CTX_new()) //throw SysError
+{
+    if (!mdctx_)
+        throw SysError(formatSystemError("EVP_MD_CTX_new", L"", L"No more error details.")); //no more error details
+
+    if (::EVP_DigestInit(mdctx_,          //EVP_MD_CTX* ctx
+                         EVP_md5()) != 1) //const EVP_MD* type
+    {
+        const std::wstring errorMsg = formatLastOpenSSLError("EVP_DigestInit");
+        ::EVP_MD_CTX_free(mdctx_);
+        throw SysError(errorMsg);
+    }
+}
+
+
+Md5Stream::~Md5Stream() { ::EVP_MD_CTX_free(mdctx_); }
+
+
+void Md5Stream::update(const void* buffer, size_t bytes)
+{
+    if (!errorMsg_)
+        if (::EVP_DigestUpdate(mdctx_,       //EVP_MD_CTX* ctx
+                               buffer,       //const void*
+                               bytes) != 1)  //size_t cnt
+            errorMsg_ = formatLastOpenSSLError("EVP_DigestUpdate");
+}
+
+
+std::string Md5Stream::finalize() //throw SysError
+{
+    if (errorMsg_)
+        throw SysError(*errorMsg_);
+
+    std::string output(EVP_MAX_MD_SIZE, '\0');
+    unsigned int bytesWritten = 0;
+    if (::EVP_DigestFinal_ex(mdctx_,                                          //EVP_MD_CTX* ctx
+                             reinterpret_cast<unsigned char*>(output.data()), //unsigned char* md
+                             &bytesWritten) != 1)                             //unsigned int* s
+        throw SysError(formatLastOpenSSLError("EVP_DigestFinal_ex"));
+
+    output.resize(bytesWritten);
+    return output;
+}
+
+
 bool zen::isPuttyKeyStream(const std::string_view keyStream)
 {
     return startsWith(trimCpy(keyStream, TrimSide::left), "PuTTY-User-Key-File-");
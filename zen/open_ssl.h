@@ -9,6 +9,8 @@
 
 #include "sys_error.h"
 
+struct evp_md_ctx_st; //avoid OpenSSL headers: EVP_MD_CTX
+
 
 namespace zen
 {
@@ -35,6 +37,25 @@ std::string convertRsaKey(const std::string_view keyStream, RsaStreamType typeFr
 
 bool isPuttyKeyStream(const std::string_view keyStream);
 std::string convertPuttyKeyToPkix(const std::string_view keyStream, const std::string_view passphrase); //throw SysError
+
+
+//incremental MD5, e.g. hash file content while copying: not about security, but MD5 is what Google Drive reports for stored files
+class Md5Stream
+{
+public:
+    Md5Stream(); //throw SysError
+    ~Md5Stream();
+
+    void update(const void* buffer, size_t bytes); //noexcept: errors are reported by finalize()
+    std::string finalize(); //throw SysError; 16 raw bytes
+
+private:
+    Md5Stream           (const Md5Stream&) = delete;
+    Md5Stream& operator=(const Md5Stream&) = delete;
+
+    evp_md_ctx_st* const mdctx_;
+    std::optional<std::wstring> errorMsg_;
+};
 }
 
 #endif //OPEN_SSL_H_801974580936508934568792347506
@@ -48,6 +48,8 @@ namespace zen
 
 using IoCallback = std::function<void(int64_t bytesDelta)>; //throw X
 
+using IoDataCallback = std::function<void(const void* buffer, size_t bytes)>; //throw X; e.g. hash data while it passes through
+
 
 template <class BinContainer, class Function>
 BinContainer unbufferedLoad(Function tryRead/*(void* buffer, size_t bytesToRead) throw X; may return short; only 0 means EOF*/,